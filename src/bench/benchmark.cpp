@@ -0,0 +1,86 @@
+#include "benchmark.hpp"
+#include "core/version.hpp"
+
+#include <iomanip>
+
+namespace ndn {
+namespace epac {
+namespace bench {
+
+Benchmark::Benchmark(time::milliseconds minTime, const std::string& filter)
+  : m_minTime(minTime)
+  , m_filter(filter)
+{
+}
+
+bool
+Benchmark::isSelected(const std::string& name) const
+{
+  return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void
+Benchmark::run(const std::string& name, const std::string& variant, uint64_t size,
+               const std::function<void()>& f)
+{
+  if (!isSelected(name)) {
+    return;
+  }
+
+  // warm up caches and lazily constructed state
+  f();
+
+  Result result{name, variant, size, 0, time::nanoseconds::zero()};
+  for (uint64_t batch = 1; result.elapsed < m_minTime; batch *= 2) {
+    auto start = time::steady_clock::now();
+    for (uint64_t i = 0; i < batch; ++i) {
+      f();
+    }
+    result.elapsed += time::steady_clock::now() - start;
+    result.iterations += batch;
+  }
+
+  double nsPerOp = static_cast<double>(result.elapsed.count()) / result.iterations;
+  std::cerr << std::left << std::setw(16) << name << std::setw(24) << variant
+            << std::right << std::setw(10) << size << std::setw(16) << std::fixed
+            << std::setprecision(1) << nsPerOp << " ns/op" << std::endl;
+
+  m_results.push_back(result);
+}
+
+void
+Benchmark::writeJson(std::ostream& os) const
+{
+  os << "{\n"
+     << "  \"program\": \"epac-bench\",\n"
+     << "  \"version\": \"" << tools::VERSION << "\",\n"
+     << "  \"minTimeMs\": " << m_minTime.count() << ",\n"
+     << "  \"results\": [";
+
+  for (size_t i = 0; i < m_results.size(); ++i) {
+    const Result& result = m_results[i];
+    double seconds = static_cast<double>(result.elapsed.count()) / 1e9;
+    double nsPerOp = static_cast<double>(result.elapsed.count()) / result.iterations;
+    double opsPerSecond = result.iterations / seconds;
+
+    os << (i == 0 ? "\n" : ",\n")
+       << "    {\"name\": \"" << result.name << "\""
+       << ", \"variant\": \"" << result.variant << "\""
+       << ", \"size\": " << result.size
+       << ", \"iterations\": " << result.iterations
+       << std::fixed << std::setprecision(1)
+       << ", \"nsPerOp\": " << nsPerOp
+       << ", \"opsPerSecond\": " << opsPerSecond;
+    if (result.size > 0) {
+      os << ", \"bytesPerSecond\": " << opsPerSecond * result.size;
+    }
+    os << "}";
+  }
+
+  os << "\n  ]\n"
+     << "}\n";
+}
+
+} // namespace bench
+} // namespace epac
+} // namespace ndn
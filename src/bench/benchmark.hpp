@@ -0,0 +1,68 @@
+#ifndef NDN_EPAC_BENCH_BENCHMARK_HPP
+#define NDN_EPAC_BENCH_BENCHMARK_HPP
+
+#include "core/common.hpp"
+
+#include <functional>
+
+namespace ndn {
+namespace epac {
+namespace bench {
+
+/**
+ * @brief measurement of one benchmark case
+ */
+struct Result
+{
+  std::string name;
+  std::string variant;
+  uint64_t size;
+  uint64_t iterations;
+  time::nanoseconds elapsed;
+};
+
+/**
+ * @brief runs benchmark cases and reports them as JSON
+ *
+ * Each case runs in batches of doubling size until it has run for at least the minimum time,
+ * so that reading the clock does not dominate cheap operations.
+ */
+class Benchmark : noncopyable
+{
+public:
+  Benchmark(time::milliseconds minTime, const std::string& filter);
+
+  /**
+   * @return whether cases named @p name are selected by the filter
+   */
+  bool
+  isSelected(const std::string& name) const;
+
+  /**
+   * @brief measure @p f, which processes @p size octets per call (0 if not applicable)
+   * @note Does nothing if @p name is not selected
+   */
+  void
+  run(const std::string& name, const std::string& variant, uint64_t size,
+      const std::function<void()>& f);
+
+  const std::vector<Result>&
+  getResults() const
+  {
+    return m_results;
+  }
+
+  void
+  writeJson(std::ostream& os) const;
+
+private:
+  time::milliseconds m_minTime;
+  std::string m_filter;
+  std::vector<Result> m_results;
+};
+
+} // namespace bench
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_BENCH_BENCHMARK_HPP
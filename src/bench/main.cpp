@@ -0,0 +1,495 @@
+#include "benchmark.hpp"
+#include "core/crypto-backend.hpp"
+#include "core/cuckoo-filter.hpp"
+#include "core/envelope.hpp"
+#include "core/key-store.hpp"
+#include "core/version.hpp"
+#include "core/worker-pool.hpp"
+#include "provider/access-group.hpp"
+#include "provider/active-user-table.hpp"
+#include "provider/name-tree.hpp"
+#include "provider/token-verifier.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <thread>
+
+namespace ndn {
+namespace epac {
+namespace bench {
+
+namespace po = boost::program_options;
+
+/**
+ * @brief options for epac-bench
+ */
+struct BenchOptions
+{
+  time::milliseconds minTime;
+  std::string filter;
+  uint64_t maxSize;
+  uint64_t maxUsers;
+  uint64_t maxNames;
+  std::string output;
+};
+
+static void
+benchKeys(Benchmark& benchmark)
+{
+  CryptoPP::AutoSeededRandomPool rng;
+  Buffer contentKey = envelope::generateContentKey();
+
+  for (const auto& name : CryptoBackend::getNames()) {
+    const CryptoBackend& backend = CryptoBackend::get(name);
+    benchmark.run("keygen", name, 0, [&] {
+      backend.makePublicKey(*backend.generatePrivateKey(rng));
+    });
+
+    if (!benchmark.isSelected("wrap") && !benchmark.isSelected("wrap-uncached") &&
+        !benchmark.isSelected("unwrap")) {
+      continue;
+    }
+
+    shared_ptr<const CryptoPP::PrivateKey> privateKey = backend.generatePrivateKey(rng);
+    shared_ptr<const CryptoPP::PublicKey> publicKey = backend.makePublicKey(*privateKey);
+    Buffer wrappedKey = envelope::wrapKey(contentKey, backend, publicKey);
+
+    benchmark.run("wrap", name, contentKey.size(), [&] {
+      envelope::wrapKey(contentKey, backend, publicKey);
+    });
+    // RNG, encryptor and filter chain constructed on every call, as before CryptoContext
+    benchmark.run("wrap-uncached", name, contentKey.size(), [&] {
+      std::string wrapped;
+      CryptoPP::AutoSeededRandomPool callRng;
+      unique_ptr<CryptoPP::PK_Encryptor> encryptor = backend.makeEncryptor(*publicKey);
+      CryptoPP::StringSource ss(contentKey.data(), contentKey.size(), true,
+        new CryptoPP::PK_EncryptorFilter(callRng, *encryptor, new CryptoPP::StringSink(wrapped)));
+    });
+    benchmark.run("unwrap", name, contentKey.size(), [&] {
+      envelope::unwrapKey(wrappedKey, backend, privateKey);
+    });
+  }
+}
+
+static void
+benchKeyStore(Benchmark& benchmark)
+{
+  if (!benchmark.isSelected("keystore-generate") && !benchmark.isSelected("keystore-load")) {
+    return;
+  }
+
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                      boost::filesystem::unique_path("epac-bench-%%%%-%%%%");
+
+  for (const auto& name : CryptoBackend::getNames()) {
+    const CryptoBackend& backend = CryptoBackend::get(name);
+    benchmark.run("keystore-generate", name, 0, [&] {
+      boost::filesystem::remove_all(directory);
+      KeyStore(directory.string(), backend).loadOrGenerate();
+    });
+
+    KeyStore(directory.string(), backend).loadOrGenerate();
+    benchmark.run("keystore-load", name, 0, [&] {
+      KeyStore(directory.string(), backend).loadOrGenerate();
+    });
+    boost::filesystem::remove_all(directory);
+  }
+}
+
+static void
+benchSymmetric(Benchmark& benchmark, const BenchOptions& options)
+{
+  if (!benchmark.isSelected("encrypt") && !benchmark.isSelected("decrypt")) {
+    return;
+  }
+
+  Buffer contentKey = envelope::generateContentKey();
+  Buffer iv = envelope::generateInitialVector();
+  Buffer payload(static_cast<size_t>(options.maxSize));
+  CryptoPP::AutoSeededRandomPool rng;
+  rng.GenerateBlock(payload.data(), payload.size());
+
+  for (uint64_t size = 64; size <= options.maxSize; size *= 4) {
+    Buffer cipher = envelope::encryptPayload(contentKey, iv, payload.data(), size);
+
+    benchmark.run("encrypt", "aes-128-gcm", size, [&] {
+      envelope::encryptPayload(contentKey, iv, payload.data(), size);
+    });
+    benchmark.run("decrypt", "aes-128-gcm", size, [&] {
+      envelope::decryptPayload(contentKey, iv, cipher.data(), cipher.size());
+    });
+  }
+}
+
+static void
+benchData(Benchmark& benchmark)
+{
+  if (!benchmark.isSelected("data-encode") && !benchmark.isSelected("data-sign")) {
+    return;
+  }
+
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  std::vector<std::pair<std::string, security::SigningInfo>> signers;
+  signers.emplace_back("sha256", security::signingWithSha256());
+  signers.emplace_back("rsa", security::signingByIdentity(
+    keyChain.createIdentity("/epac-bench/rsa", RsaKeyParams())));
+  signers.emplace_back("ecdsa", security::signingByIdentity(
+    keyChain.createIdentity("/epac-bench/ecdsa", EcKeyParams())));
+
+  // sizes up to the payload that fits into one NDN packet
+  for (size_t size : {64, 1024, 4096, 8000}) {
+    Buffer payload(size);
+    Block content = makeBinaryBlock(ndn::tlv::Content, payload.data(), payload.size());
+
+    Data data(Name("/epac-bench/data").appendVersion().appendSegment(0));
+    data.setFreshnessPeriod(time::seconds(10));
+    keyChain.sign(data, security::signingWithSha256());
+
+    benchmark.run("data-encode", "", size, [&] {
+      data.setContent(content);
+      data.wireEncode();
+    });
+
+    for (const auto& signer : signers) {
+      benchmark.run("data-sign", signer.first, size, [&] {
+        data.setContent(content);
+        keyChain.sign(data, signer.second);
+      });
+    }
+  }
+}
+
+static void
+benchActiveUserTable(Benchmark& benchmark, const BenchOptions& options)
+{
+  if (!benchmark.isSelected("aut-lookup") && !benchmark.isSelected("aut-concurrent")) {
+    return;
+  }
+
+  // every user shares one key: lookups do not depend on the key, and generating
+  // a million key pairs would dominate the run
+  CryptoPP::AutoSeededRandomPool rng;
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  shared_ptr<const CryptoPP::PublicKey> publicKey =
+    backend.makePublicKey(*backend.generatePrivateKey(rng));
+
+  const size_t N_QUERIES = 4096;
+  std::mt19937 random(42);
+
+  ActiveUserTable aut;
+  for (uint64_t nUsers = 1000; nUsers <= options.maxUsers; nUsers *= 10) {
+    for (uint64_t i = aut.size(); i < nUsers; ++i) {
+      aut.add("user" + std::to_string(i), publicKey, backend);
+    }
+
+    std::uniform_int_distribution<uint64_t> pick(0, nUsers - 1);
+    std::vector<std::string> hits;
+    std::vector<std::string> misses;
+    for (size_t i = 0; i < N_QUERIES; ++i) {
+      uint64_t n = pick(random);
+      hits.push_back("user" + std::to_string(n));
+      misses.push_back("absent" + std::to_string(n));
+    }
+
+    size_t next = 0;
+    size_t nFound = 0;
+    std::string users = std::to_string(nUsers);
+    benchmark.run("aut-lookup", "hit-" + users, 0, [&] {
+      nFound += aut.find(hits[next++ % N_QUERIES]) != nullptr;
+    });
+    benchmark.run("aut-lookup", "miss-" + users, 0, [&] {
+      nFound += aut.find(misses[next++ % N_QUERIES]) != nullptr;
+    });
+    BOOST_ASSERT(nFound > 0);
+  }
+
+  if (aut.size() == 0) {
+    return;
+  }
+
+  // lookups into the largest table from a growing number of threads; each operation is a
+  // batch of N_BATCH lookups split across the threads of a pool
+  const size_t N_BATCH = 65536;
+  std::uniform_int_distribution<uint64_t> pick(0, aut.size() - 1);
+  std::vector<std::string> userIds;
+  for (size_t i = 0; i < N_QUERIES; ++i) {
+    userIds.push_back("user" + std::to_string(pick(random)));
+  }
+
+  size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+    WorkerPool pool(nThreads);
+    std::atomic<size_t> nFound(0);
+    benchmark.run("aut-concurrent", "threads-" + std::to_string(nThreads), 0, [&] {
+      pool.parallelFor(N_BATCH, [&] (size_t begin, size_t end) {
+        size_t n = 0;
+        for (size_t i = begin; i < end; ++i) {
+          n += aut.find(userIds[i % N_QUERIES]) != nullptr;
+        }
+        nFound += n;
+      });
+    });
+    BOOST_ASSERT(nFound > 0);
+  }
+}
+
+static void
+benchAccessGroup(Benchmark& benchmark, const BenchOptions& options)
+{
+  if (!benchmark.isSelected("group-rekey")) {
+    return;
+  }
+
+  // members share one key, as in benchActiveUserTable
+  CryptoPP::AutoSeededRandomPool rng;
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  shared_ptr<const CryptoPP::PublicKey> publicKey =
+    backend.makePublicKey(*backend.generatePrivateKey(rng));
+
+  std::mt19937 random(42);
+  AccessGroup group("epac-bench", 0);
+  for (uint64_t nUsers = 1000; nUsers <= options.maxUsers; nUsers *= 10) {
+    for (uint64_t i = group.size(); i < nUsers; ++i) {
+      group.add("user" + std::to_string(i), backend, publicKey);
+    }
+
+    // each operation revokes a member and lets it join again: two rekey messages of
+    // O(log n) wrapped keys, and one public-key wrap for the joining member
+    std::uniform_int_distribution<uint64_t> pick(0, nUsers - 1);
+    size_t nWrappedKeys = 0;
+    benchmark.run("group-rekey", "users-" + std::to_string(nUsers), 0, [&] {
+      std::string userId = "user" + std::to_string(pick(random));
+      nWrappedKeys += group.remove(userId).size();
+      nWrappedKeys += group.add(userId, backend, publicKey).size();
+    });
+    BOOST_ASSERT(nWrappedKeys > 0);
+  }
+}
+
+static void
+benchUserFilter(Benchmark& benchmark, const BenchOptions& options)
+{
+  if (!benchmark.isSelected("filter-lookup")) {
+    return;
+  }
+
+  const size_t N_QUERIES = 4096;
+  std::mt19937 random(42);
+
+  for (uint64_t nUsers = 1000; nUsers <= options.maxUsers; nUsers *= 10) {
+    CuckooFilter filter(nUsers, 0.01);
+    for (uint64_t i = 0; i < nUsers; ++i) {
+      filter.insert("user" + std::to_string(i));
+    }
+
+    std::uniform_int_distribution<uint64_t> pick(0, nUsers - 1);
+    std::vector<std::string> hits;
+    std::vector<std::string> misses;
+    for (size_t i = 0; i < N_QUERIES; ++i) {
+      hits.push_back("user" + std::to_string(pick(random)));
+      misses.push_back("other" + std::to_string(pick(random)));
+    }
+
+    size_t next = 0;
+    size_t nFound = 0;
+    std::string users = std::to_string(nUsers);
+    benchmark.run("filter-lookup", "hit-" + users, 0, [&] {
+      nFound += filter.contains(hits[next++ % N_QUERIES]);
+    });
+    benchmark.run("filter-lookup", "miss-" + users, 0, [&] {
+      nFound += filter.contains(misses[next++ % N_QUERIES]);
+    });
+    // the table is what a provider publishes
+    benchmark.run("filter-lookup", "encode-" + users, filter.getTableSize(), [&] {
+      nFound += filter.wireEncode().size() > 0;
+    });
+    BOOST_ASSERT(nFound > 0);
+  }
+}
+
+static void
+benchTokens(Benchmark& benchmark)
+{
+  if (!benchmark.isSelected("token-verify")) {
+    return;
+  }
+
+  // as many users as the cache holds, or four times as many, so that nearly every token
+  // misses the cache and is checked with an HMAC
+  TokenVerifier verifier(time::hours(1));
+  for (size_t nUsers : {TokenVerifier::CACHE_SIZE / 4, TokenVerifier::CACHE_SIZE * 4}) {
+    std::vector<Block> tokens;
+    for (size_t i = 0; i < nUsers; ++i) {
+      tokens.push_back(verifier.issue("user" + std::to_string(i)).wireEncode());
+    }
+
+    // a token is decoded from the Interest, as by the provider
+    size_t next = 0;
+    size_t nVerified = 0;
+    std::string variant = nUsers < TokenVerifier::CACHE_SIZE ? "cached" : "hmac";
+    benchmark.run("token-verify", variant, 0, [&] {
+      nVerified += verifier.verify(AccessToken(tokens[next++ % nUsers]));
+    });
+    BOOST_ASSERT(nVerified > 0);
+  }
+}
+
+static void
+benchNameTree(Benchmark& benchmark, const BenchOptions& options)
+{
+  if (!benchmark.isSelected("name-lookup")) {
+    return;
+  }
+
+  // publications <prefix>/dir<n>/file<n>/<version> of a directory tree, 1000 files per directory
+  auto makeName = [] (uint64_t n) {
+    return Name("/epac-bench/tree").append("dir" + std::to_string(n / 1000))
+                                   .append("file" + std::to_string(n)).appendVersion(1);
+  };
+
+  const size_t N_QUERIES = 4096;
+  std::mt19937 random(42);
+
+  NameTree<uint64_t> tree;
+  for (uint64_t nNames = 1000; nNames <= options.maxNames; nNames *= 10) {
+    for (uint64_t i = tree.size(); i < nNames; ++i) {
+      tree[makeName(i)] = i;
+    }
+
+    std::uniform_int_distribution<uint64_t> pick(0, nNames - 1);
+    std::vector<Name> segments;
+    std::vector<Name> misses;
+    std::vector<Name> files;
+    for (size_t i = 0; i < N_QUERIES; ++i) {
+      uint64_t n = pick(random);
+      segments.push_back(makeName(n).appendSegment(n % 100));
+      misses.push_back(makeName(n).getPrefix(3).append("absent").appendSegment(0));
+      files.push_back(makeName(n).getPrefix(-1));
+    }
+
+    size_t next = 0;
+    size_t nFound = 0;
+    std::string names = std::to_string(nNames);
+    benchmark.run("name-lookup", "segment-" + names, 0, [&] {
+      nFound += tree.findLongestPrefix(segments[next++ % N_QUERIES]) != nullptr;
+    });
+    benchmark.run("name-lookup", "miss-" + names, 0, [&] {
+      nFound += tree.findLongestPrefix(misses[next++ % N_QUERIES]) != nullptr;
+    });
+    benchmark.run("name-lookup", "discovery-" + names, 0, [&] {
+      nFound += tree.findLast(files[next++ % N_QUERIES]) != nullptr;
+    });
+    BOOST_ASSERT(nFound > 0);
+  }
+}
+
+static void
+usage(std::ostream& os, const po::options_description& options)
+{
+  os << "Usage: epac-bench [options]\n"
+        "\n"
+        "Measure key generation, key wrapping, KeyStore startup, payload encryption, Data encoding\n"
+        "and signing, ActiveUserTable lookups from one and several threads, access group rekeying,\n"
+        "user filter lookups and encoding, access token verification, and name lookups, and write\n"
+        "the results as JSON.\n"
+        "\n"
+     << options;
+}
+
+static int
+main(int argc, char* argv[])
+{
+  BenchOptions options;
+  int minTime = 200;
+
+  po::options_description optDesc("Options");
+  optDesc.add_options()
+    ("help,h", "print help and exit")
+    ("version,V", "print version and exit")
+    ("min-time,t", po::value<int>(&minTime)->default_value(minTime),
+        "minimum running time of each case (in milliseconds)")
+    ("filter,f", po::value<std::string>(&options.filter),
+        "run only the cases whose name contains this string")
+    ("max-size", po::value<uint64_t>(&options.maxSize)->default_value(64 * 1024 * 1024),
+        "largest payload size for encryption (in octets)")
+    ("max-users", po::value<uint64_t>(&options.maxUsers)->default_value(1000000),
+        "largest ActiveUserTable, access group and user filter size")
+    ("max-names", po::value<uint64_t>(&options.maxNames)->default_value(1000000),
+        "largest number of names in the name tree")
+    ("output,o", po::value<std::string>(&options.output),
+        "write JSON into this file instead of the standard output")
+  ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, optDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    usage(std::cout, optDesc);
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "epac-bench " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (minTime <= 0) {
+    std::cerr << "ERROR: min-time must be a positive integer" << std::endl;
+    usage(std::cerr, optDesc);
+    return 2;
+  }
+  options.minTime = time::milliseconds(minTime);
+
+  Benchmark benchmark(options.minTime, options.filter);
+  try {
+    benchKeys(benchmark);
+    benchKeyStore(benchmark);
+    benchSymmetric(benchmark, options);
+    benchData(benchmark);
+    benchActiveUserTable(benchmark, options);
+    benchAccessGroup(benchmark, options);
+    benchUserFilter(benchmark, options);
+    benchTokens(benchmark);
+    benchNameTree(benchmark, options);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  if (options.output.empty()) {
+    benchmark.writeJson(std::cout);
+  }
+  else {
+    std::ofstream os(options.output);
+    benchmark.writeJson(os);
+    if (!os) {
+      std::cerr << "ERROR: cannot write " << options.output << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+} // namespace bench
+} // namespace epac
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::epac::bench::main(argc, argv);
+}
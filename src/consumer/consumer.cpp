@@ -3,49 +3,27 @@
 namespace ndn {
 namespace epac {
 
-Consumer::Consumer(Face& face, const PeekOptions& options)
+Consumer::Consumer(Face& face, const PeekOptions& options, KeyRing& keyRing)
   : m_face(face)
   , m_options(options)
   , m_timeout(options.timeout)
   , m_resultCode(ResultCode::TIMEOUT)
+  , m_keyRing(keyRing)
 {
   if (m_timeout < time::milliseconds::zero()) {
     m_timeout = m_options.interestLifetime < time::milliseconds::zero() ?
                 DEFAULT_INTEREST_LIFETIME : m_options.interestLifetime;
   }
-
-  AutoSeededRandomPool rng;
-  InvertibleRSAFunction params;
-
-  params.GenerateRandomWithKeySize(rng, 1024);
-
-  privateKey = new RSA::PrivateKey(params);
-  publicKey = new RSA::PublicKey(params);
 }
 
 void
-Consumer::loadPrivateKey(const std::string &filename, RSA::PrivateKey &key)
+Consumer::decrypt(const Data& data, std::ostream& os)
 {
-  ByteQueue queue;
-  FileSource file(filename.c_str(), true /*pumpAll*/);
-  file.TransferTo(queue);
-  queue.MessageEnd();
-  key.Load(queue);
-}
-
-std::string
-Consumer::decrypt(const std::string &cipher)
-{
-  AutoSeededRandomPool rng;
-  std::string recovered;
-  RSAES_OAEP_SHA_Decryptor d(*privateKey);
-  StringSource ss2(cipher, true,
-    new PK_DecryptorFilter(rng, d,
-      new StringSink(recovered)
-    ) // PK_DecryptorFilter
-  ); // StringSource
-
-  return recovered;
+  const Block& content = data.getContent();
+  m_keyRing.open(data.getName(), content.value(), content.value_size(),
+                 [&os] (const uint8_t* payload, size_t size) {
+                   os.write(reinterpret_cast<const char*>(payload), size);
+                 });
 }
 
 time::milliseconds
@@ -87,6 +65,9 @@ Consumer::createInterest() const
   if (m_options.link != nullptr)
     interest.setForwardingHint(m_options.link->getDelegationList());
 
+  if (m_options.token != nullptr)
+    m_options.token->attachTo(interest);
+
   if (m_options.mustBeFresh)
     interest.setMustBeFresh(true);
 
@@ -112,11 +93,7 @@ Consumer::onData(const Data& data)
   }
 
   if (m_options.wantPayloadOnly) {
-    const Block& block = data.getContent();
-    std::string info = std::string(reinterpret_cast<const char*>(block.value()), block.value_size());
-    std::string result = decrypt(info);
-    std::cout << result << std::endl;
-    //std::cout.write(reinterpret_cast<const char*>(block.value()), block.value_size());
+    decrypt(data, std::cout);
   }
   else {
     const Block& block = data.wireEncode();
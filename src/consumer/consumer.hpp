@@ -2,6 +2,9 @@
 #define NDN_EPAC_CONSUMER_HPP
 
 #include "core/common.hpp"
+#include "core/access-token.hpp"
+#include "core/envelope.hpp"
+#include "key-ring.hpp"
 
 using namespace CryptoPP;
 
@@ -19,10 +22,16 @@ struct PeekOptions
   time::milliseconds interestLifetime;
   time::milliseconds timeout;
   shared_ptr<Link> link;
+  /**
+   * @brief token attached to the Interest, or nullptr
+   */
+  shared_ptr<AccessToken> token;
   bool isVerbose;
   bool mustBeFresh;
   bool wantRightmostChild;
   bool wantPayloadOnly;
+  std::string algorithm;
+  std::vector<std::string> privateKeyFiles;
 };
 
 enum class ResultCode {
@@ -35,7 +44,10 @@ enum class ResultCode {
 class Consumer : boost::noncopyable
 {
 public:
-  Consumer(Face& face, const PeekOptions& options);
+  /**
+   * @param keyRing private keys that open the fetched content
+   */
+  Consumer(Face& face, const PeekOptions& options, KeyRing& keyRing);
 
   /**
    * @return the timeout
@@ -72,11 +84,13 @@ private:
   void
   onNack(const lp::Nack& nack);
 
+  /**
+   * @brief open the envelope carried in the content of @p data into @p os
+   *
+   * The payload is decrypted and written one chunk at a time.
+   */
   void
-  loadPrivateKey(const std::string& filename, RSA::PrivateKey& key);
-
-  std::string
-  decrypt(const std::string &cipher);
+  decrypt(const Data& data, std::ostream& os);
 
 private:
   Face& m_face;
@@ -84,9 +98,7 @@ private:
   time::steady_clock::TimePoint m_expressInterestTime;
   time::milliseconds m_timeout;
   ResultCode m_resultCode;
-
-  RSA::PrivateKey *privateKey;
-  RSA::PublicKey *publicKey;
+  KeyRing& m_keyRing;
 };
 
 } // namespace epac
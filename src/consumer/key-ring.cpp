@@ -0,0 +1,129 @@
+#include "key-ring.hpp"
+#include "core/key-store.hpp"
+
+namespace ndn {
+namespace epac {
+
+const size_t KeyRing::MAX_CACHED_KEYS = 1024;
+
+KeyRing::KeyRing(const CryptoBackend& backend)
+  : m_backend(backend)
+  , m_nUnwraps(0)
+{
+}
+
+void
+KeyRing::loadPrivateKey(const std::string& filename)
+{
+  auto key = m_backend.createPrivateKey();
+  try {
+    KeyStore::loadKey(filename, *key);
+  }
+  catch (const KeyStore::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(e.what()));
+  }
+
+  CryptoPP::AutoSeededRandomPool rng;
+  if (!key->Validate(rng, 2)) {
+    BOOST_THROW_EXCEPTION(Error("Private key in " + filename + " failed validation"));
+  }
+
+  addPrivateKey(key);
+}
+
+void
+KeyRing::addPrivateKey(shared_ptr<const CryptoPP::PrivateKey> key)
+{
+  BOOST_ASSERT(key != nullptr);
+  m_privateKeys.push_back(std::move(key));
+}
+
+Buffer
+KeyRing::open(const Name& name, const uint8_t* envelope, size_t size)
+{
+  envelope::Header header;
+  size_t headerSize = 0;
+  const Buffer& contentKey = openHeader(name, envelope, size, header, headerSize);
+  return envelope::openPayload(header, contentKey, envelope + headerSize, size - headerSize);
+}
+
+void
+KeyRing::open(const Name& name, const uint8_t* envelope, size_t size,
+              const envelope::PayloadSink& sink)
+{
+  envelope::Header header;
+  size_t headerSize = 0;
+  const Buffer& contentKey = openHeader(name, envelope, size, header, headerSize);
+  envelope::openPayload(header, contentKey, envelope + headerSize, size - headerSize, sink);
+}
+
+const Buffer&
+KeyRing::openHeader(const Name& name, const uint8_t* envelope, size_t size,
+                    envelope::Header& header, size_t& headerSize)
+{
+  header = envelope::decodeHeader(envelope, size, headerSize);
+  if (header.getAlgorithm() != static_cast<uint64_t>(m_backend.getType())) {
+    BOOST_THROW_EXCEPTION(Error("Content of " + name.toUri() + " is not wrapped with " +
+                                m_backend.getName()));
+  }
+  return findContentKey(name, header);
+}
+
+Name
+KeyRing::getContentKeyName(const Name& dataName)
+{
+  for (size_t i = dataName.size(); i > 0; --i) {
+    if (dataName.get(i - 1).isVersion()) {
+      return dataName.getPrefix(i);
+    }
+  }
+
+  if (!dataName.empty() && dataName.get(-1).isSegment()) {
+    return dataName.getPrefix(-1);
+  }
+  return dataName;
+}
+
+const Buffer&
+KeyRing::findContentKey(const Name& name, const envelope::Header& header)
+{
+  Name keyName = getContentKeyName(name);
+
+  auto it = m_contentKeys.find(keyName);
+  if (it != m_contentKeys.end() && it->second.wrappedKey == header.getWrappedKey()) {
+    return it->second.contentKey;
+  }
+
+  Buffer contentKey = unwrapContentKey(header);
+  ++m_nUnwraps;
+
+  if (it == m_contentKeys.end() && m_contentKeys.size() >= MAX_CACHED_KEYS) {
+    m_contentKeys.clear();
+  }
+
+  CachedKey& entry = m_contentKeys[keyName];
+  entry.wrappedKey = header.getWrappedKey();
+  entry.contentKey = std::move(contentKey);
+  return entry.contentKey;
+}
+
+Buffer
+KeyRing::unwrapContentKey(const envelope::Header& header) const
+{
+  if (m_privateKeys.empty()) {
+    BOOST_THROW_EXCEPTION(Error("No private key is loaded"));
+  }
+
+  for (const auto& key : m_privateKeys) {
+    try {
+      return envelope::unwrapKey(header.getWrappedKey(), m_backend, key);
+    }
+    catch (const envelope::Error&) {
+      // wrapped for another key, try the next one
+    }
+  }
+  BOOST_THROW_EXCEPTION(Error("None of the private keys unwraps the content key"));
+}
+
+} // namespace epac
+} // namespace ndn
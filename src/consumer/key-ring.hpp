@@ -0,0 +1,131 @@
+#ifndef NDN_EPAC_KEY_RING_HPP
+#define NDN_EPAC_KEY_RING_HPP
+
+#include "core/common.hpp"
+#include "core/crypto-backend.hpp"
+#include "core/envelope.hpp"
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief private keys of the consumer and the content keys unwrapped with them
+ *
+ * Private keys are loaded once at startup. Unwrapped content keys are cached by
+ * content name (prefix and version), so that fetching the same content again, or
+ * another segment of it, costs only the symmetric decryption.
+ */
+class KeyRing : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  explicit
+  KeyRing(const CryptoBackend& backend = CryptoBackend::getDefault());
+
+  /**
+   * @brief load a DER encoded private key of the backend from @p filename
+   * @throw Error the key cannot be read or fails validation
+   */
+  void
+  loadPrivateKey(const std::string& filename);
+
+  void
+  addPrivateKey(shared_ptr<const CryptoPP::PrivateKey> key);
+
+  size_t
+  getNPrivateKeys() const
+  {
+    return m_privateKeys.size();
+  }
+
+  /**
+   * @brief open the envelope carried in the content of Data named @p name
+   *
+   * The content key is unwrapped with the private keys only when no key is cached under
+   * getContentKeyName(@p name), or when the cached key was unwrapped from a different
+   * WrappedKey, i.e. the content was republished under the same name.
+   *
+   * @throw Error none of the private keys unwraps the content key
+   * @throw envelope::Error malformed envelope or authentication failure
+   */
+  Buffer
+  open(const Name& name, const uint8_t* envelope, size_t size);
+
+  /**
+   * @brief open the envelope carried in the content of Data named @p name into @p sink
+   *
+   * The payload is passed to @p sink one authenticated chunk at a time.
+   */
+  void
+  open(const Name& name, const uint8_t* envelope, size_t size,
+       const envelope::PayloadSink& sink);
+
+  /**
+   * @return the name under which the content key of Data @p dataName is cached:
+   *         the name up to and including its last version component, or the name without
+   *         a trailing segment component if it has no version
+   */
+  static Name
+  getContentKeyName(const Name& dataName);
+
+  size_t
+  getNCachedKeys() const
+  {
+    return m_contentKeys.size();
+  }
+
+  /**
+   * @return number of content keys unwrapped with a private key so far
+   */
+  size_t
+  getNUnwraps() const
+  {
+    return m_nUnwraps;
+  }
+
+public:
+  /**
+   * @brief maximum number of cached content keys; the cache is flushed when exceeded
+   */
+  static const size_t MAX_CACHED_KEYS;
+
+private:
+  /**
+   * @return the content key of the envelope, and its header in @p header
+   */
+  const Buffer&
+  openHeader(const Name& name, const uint8_t* envelope, size_t size,
+             envelope::Header& header, size_t& headerSize);
+
+  const Buffer&
+  findContentKey(const Name& name, const envelope::Header& header);
+
+  Buffer
+  unwrapContentKey(const envelope::Header& header) const;
+
+private:
+  struct CachedKey
+  {
+    Buffer wrappedKey;
+    Buffer contentKey;
+  };
+
+  const CryptoBackend& m_backend;
+  std::vector<shared_ptr<const CryptoPP::PrivateKey>> m_privateKeys;
+  std::map<Name, CachedKey> m_contentKeys;
+  size_t m_nUnwraps;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_KEY_RING_HPP
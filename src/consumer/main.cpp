@@ -28,6 +28,12 @@ main(int argc, char* argv[])
   options.maxSuffixComponents = -1;
   options.interestLifetime = time::milliseconds(-1);
   options.timeout = time::milliseconds(-1);
+  options.algorithm = CryptoBackend::getDefault().getName();
+
+  std::string algorithmHelp = "key wrapping algorithm:";
+  for (const auto& name : CryptoBackend::getNames()) {
+    algorithmHelp += " " + name;
+  }
 
   po::options_description genericOptDesc("Generic options");
   genericOptDesc.add_options()
@@ -38,6 +44,10 @@ main(int argc, char* argv[])
         "set timeout (in milliseconds)")
     ("verbose,v", po::bool_switch(&options.isVerbose),
         "turn on verbose output")
+    ("algorithm,a", po::value<std::string>(&options.algorithm)->default_value(options.algorithm),
+        algorithmHelp.data())
+    ("key,k", po::value<std::vector<std::string>>(&options.privateKeyFiles)->composing(),
+        "load a private key from file, may be repeated (default: privateKey.key)")
     ("version,V", "print version and exit")
   ;
 
@@ -55,6 +65,8 @@ main(int argc, char* argv[])
         "set InterestLifetime (in milliseconds)")
     ("link-file", po::value<std::string>(),
         "set Link from a file")
+    ("token-file", po::value<std::string>(),
+        "attach the AccessToken in a file, granted by a provider that requires tokens")
   ;
 
   po::options_description visibleOptDesc;
@@ -99,6 +111,16 @@ main(int argc, char* argv[])
     return 2;
   }
 
+  const CryptoBackend* backend = nullptr;
+  try {
+    backend = &CryptoBackend::get(options.algorithm);
+  }
+  catch (const CryptoBackend::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    usage(std::cerr, visibleOptDesc);
+    return 2;
+  }
+
   if (vm.count("minsuffix") > 0 && options.minSuffixComponents < 0) {
     std::cerr << "ERROR: MinSuffixComponents must be a non-negative integer" << std::endl;
     usage(std::cerr, visibleOptDesc);
@@ -142,8 +164,34 @@ main(int argc, char* argv[])
     }
   }
 
+  if (vm.count("token-file") > 0) {
+    options.token = io::load<AccessToken>(vm["token-file"].as<std::string>());
+    if (options.token == nullptr) {
+      std::cerr << "ERROR: Cannot read AccessToken from the specified file" << std::endl;
+      usage(std::cerr, visibleOptDesc);
+      return 2;
+    }
+  }
+
+  // keys are needed only to decrypt the payload, and are loaded once before any Interest
+  KeyRing keyRing(*backend);
+  if (options.wantPayloadOnly) {
+    if (options.privateKeyFiles.empty()) {
+      options.privateKeyFiles.push_back("privateKey.key");
+    }
+    try {
+      for (const auto& file : options.privateKeyFiles) {
+        keyRing.loadPrivateKey(file);
+      }
+    }
+    catch (const KeyRing::Error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return 2;
+    }
+  }
+
   Face face;
-  Consumer program(face, options);
+  Consumer program(face, options, keyRing);
 
   try {
     program.start();
@@ -0,0 +1,137 @@
+#include "access-token.hpp"
+#include "envelope.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+namespace ndn {
+namespace epac {
+
+const size_t AccessToken::MAC_SIZE;
+
+static_assert(AccessToken::MAC_SIZE == envelope::CONTENT_KEY_SIZE,
+              "the MAC is granted wrapped like a content key");
+
+AccessToken::AccessToken(std::string userId, uint64_t expiry, Buffer mac)
+  : m_userId(std::move(userId))
+  , m_expiry(expiry)
+  , m_mac(std::move(mac))
+{
+  BOOST_ASSERT(m_mac.size() == MAC_SIZE);
+}
+
+AccessToken::AccessToken(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+void
+AccessToken::attachTo(Interest& interest) const
+{
+  interest.setParameters(wireEncode());
+}
+
+static size_t
+prependUserIdAndExpiry(EncodingBuffer& encoder, const std::string& userId, uint64_t expiry)
+{
+  size_t totalLength = 0;
+  totalLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::TokenExpiry, expiry);
+  totalLength += encoding::prependByteArrayBlock(encoder, tlv::UserId,
+                                                 reinterpret_cast<const uint8_t*>(userId.data()),
+                                                 userId.size());
+  return totalLength;
+}
+
+Block
+AccessToken::wrap(const CryptoBackend& backend,
+                  const shared_ptr<const CryptoPP::PublicKey>& publicKey) const
+{
+  Buffer wrappedMac = envelope::wrapKey(m_mac, backend, publicKey);
+
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+  totalLength += encoding::prependByteArrayBlock(encoder, tlv::WrappedKey,
+                                                 wrappedMac.data(), wrappedMac.size());
+  totalLength += prependUserIdAndExpiry(encoder, m_userId, m_expiry);
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::TokenGrant);
+
+  return encoder.block();
+}
+
+AccessToken
+AccessToken::unwrap(const Block& grant, const CryptoBackend& backend,
+                    const shared_ptr<const CryptoPP::PrivateKey>& privateKey)
+{
+  if (grant.type() != tlv::TokenGrant) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(grant.type()) +
+                                " while decoding TokenGrant"));
+  }
+
+  std::string userId;
+  uint64_t expiry = 0;
+  Buffer wrappedMac;
+  try {
+    grant.parse();
+    const Block& userIdBlock = grant.get(tlv::UserId);
+    userId.assign(reinterpret_cast<const char*>(userIdBlock.value()), userIdBlock.value_size());
+    expiry = encoding::readNonNegativeInteger(grant.get(tlv::TokenExpiry));
+    const Block& wrappedKey = grant.get(tlv::WrappedKey);
+    wrappedMac = Buffer(wrappedKey.value(), wrappedKey.value_size());
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed TokenGrant: ") + e.what()));
+  }
+
+  return AccessToken(std::move(userId), expiry,
+                     envelope::unwrapKey(wrappedMac, backend, privateKey));
+}
+
+Block
+AccessToken::wireEncode() const
+{
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+  totalLength += encoding::prependByteArrayBlock(encoder, tlv::TokenMac,
+                                                 m_mac.data(), m_mac.size());
+  totalLength += prependUserIdAndExpiry(encoder, m_userId, m_expiry);
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::AccessToken);
+
+  return encoder.block();
+}
+
+void
+AccessToken::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::AccessToken) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(wire.type()) +
+                                " while decoding AccessToken"));
+  }
+
+  std::string userId;
+  uint64_t expiry = 0;
+  Buffer mac;
+  try {
+    wire.parse();
+    const Block& userIdBlock = wire.get(tlv::UserId);
+    userId.assign(reinterpret_cast<const char*>(userIdBlock.value()), userIdBlock.value_size());
+    expiry = encoding::readNonNegativeInteger(wire.get(tlv::TokenExpiry));
+    const Block& macBlock = wire.get(tlv::TokenMac);
+    mac = Buffer(macBlock.value(), macBlock.value_size());
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed AccessToken: ") + e.what()));
+  }
+
+  if (mac.size() != MAC_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TokenMac size " + std::to_string(mac.size())));
+  }
+
+  m_userId = std::move(userId);
+  m_expiry = expiry;
+  m_mac = std::move(mac);
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,105 @@
+#ifndef NDN_EPAC_CORE_ACCESS_TOKEN_HPP
+#define NDN_EPAC_CORE_ACCESS_TOKEN_HPP
+
+#include "common.hpp"
+#include "crypto-backend.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <ndn-cxx/interest.hpp>
+
+namespace ndn {
+namespace epac {
+
+/** \brief symmetric token authorizing a registered user to fetch from a provider
+ *
+ *  A token names its user and its expiry, and carries a MAC over both computed with a secret
+ *  of the provider, so the provider checks a token with one HMAC instead of a signature.
+ *  The MAC is what makes a token: it is granted to the user wrapped under the user's public
+ *  key, and only sent in the clear in the Interests of the user.
+ */
+class AccessToken
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  AccessToken()
+    : m_expiry(0)
+  {
+  }
+
+  AccessToken(std::string userId, uint64_t expiry, Buffer mac);
+
+  explicit
+  AccessToken(const Block& wire);
+
+  const std::string&
+  getUserId() const
+  {
+    return m_userId;
+  }
+
+  /** \return expiry in milliseconds since the Unix epoch
+   */
+  uint64_t
+  getExpiry() const
+  {
+    return m_expiry;
+  }
+
+  const Buffer&
+  getMac() const
+  {
+    return m_mac;
+  }
+
+  /** \brief set the parameters of \p interest to the token
+   */
+  void
+  attachTo(Interest& interest) const;
+
+  /** \return the TokenGrant of the token for its user, who has \p publicKey of \p backend
+   */
+  Block
+  wrap(const CryptoBackend& backend, const shared_ptr<const CryptoPP::PublicKey>& publicKey) const;
+
+  /** \return the token granted by \p grant, unwrapped with \p privateKey of \p backend
+   *  \throw Error \p grant is malformed
+   *  \throw envelope::Error the MAC cannot be unwrapped with \p privateKey
+   */
+  static AccessToken
+  unwrap(const Block& grant, const CryptoBackend& backend,
+         const shared_ptr<const CryptoPP::PrivateKey>& privateKey);
+
+  Block
+  wireEncode() const;
+
+  /** \throw Error \p wire is not an AccessToken with a MAC of MAC_SIZE octets
+   */
+  void
+  wireDecode(const Block& wire);
+
+public:
+  /** \brief size of the MAC in octets: HMAC-SHA256 truncated to 128 bits
+   */
+  static const size_t MAC_SIZE = 16;
+
+private:
+  std::string m_userId;
+  uint64_t m_expiry;
+  Buffer m_mac;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_ACCESS_TOKEN_HPP
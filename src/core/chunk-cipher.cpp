@@ -0,0 +1,87 @@
+#include "chunk-cipher.hpp"
+#include "envelope.hpp"
+
+namespace ndn {
+namespace epac {
+namespace envelope {
+
+const uint64_t ChunkCipher::MAX_CHUNKS = 0xFFFFFFFF;
+
+static const uint8_t MORE_CHUNKS = 0;
+static const uint8_t LAST_CHUNK = 1;
+
+ChunkCipher::ChunkCipher(const Buffer& iv)
+  : m_iv(iv)
+  , m_chunkIv(iv)
+  , m_nChunks(0)
+  , m_isFinished(false)
+{
+  if (m_iv.size() != IV_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected InitialVector size " + std::to_string(m_iv.size())));
+  }
+}
+
+void
+ChunkCipher::nextChunk(bool isLast)
+{
+  if (m_isFinished) {
+    BOOST_THROW_EXCEPTION(Error("Chunk after the last chunk"));
+  }
+  if (m_nChunks >= MAX_CHUNKS) {
+    BOOST_THROW_EXCEPTION(Error("Too many chunks in one payload"));
+  }
+
+  std::copy(m_iv.begin(), m_iv.end(), m_chunkIv.begin());
+  for (size_t i = 0; i < 4; ++i) {
+    m_chunkIv[IV_SIZE - 1 - i] ^= static_cast<uint8_t>(m_nChunks >> (8 * i));
+  }
+
+  ++m_nChunks;
+  m_isFinished = isLast;
+}
+
+ChunkEncryptor::ChunkEncryptor(const Buffer& contentKey, const Buffer& iv)
+  : ChunkCipher(iv)
+{
+  m_gcm.SetKeyWithIV(contentKey.data(), contentKey.size(), m_iv.data(), m_iv.size());
+}
+
+void
+ChunkEncryptor::encrypt(const uint8_t* input, size_t size, bool isLast, uint8_t* output)
+{
+  nextChunk(isLast);
+
+  uint8_t flag = isLast ? LAST_CHUNK : MORE_CHUNKS;
+  m_gcm.EncryptAndAuthenticate(output, output + size, TAG_SIZE,
+                               m_chunkIv.data(), static_cast<int>(m_chunkIv.size()),
+                               &flag, 1, input, size);
+}
+
+ChunkDecryptor::ChunkDecryptor(const Buffer& contentKey, const Buffer& iv)
+  : ChunkCipher(iv)
+{
+  m_gcm.SetKeyWithIV(contentKey.data(), contentKey.size(), m_iv.data(), m_iv.size());
+}
+
+void
+ChunkDecryptor::decrypt(const uint8_t* input, size_t size, bool isLast, uint8_t* output)
+{
+  if (size < TAG_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Encrypted chunk is shorter than the authentication tag"));
+  }
+  nextChunk(isLast);
+
+  size_t chunkSize = size - TAG_SIZE;
+  uint8_t flag = isLast ? LAST_CHUNK : MORE_CHUNKS;
+  bool isAuthentic = m_gcm.DecryptAndVerify(output, input + chunkSize, TAG_SIZE,
+                                            m_chunkIv.data(), static_cast<int>(m_chunkIv.size()),
+                                            &flag, 1, input, chunkSize);
+  if (!isAuthentic) {
+    BOOST_THROW_EXCEPTION(Error("Encrypted chunk " + std::to_string(m_nChunks - 1) +
+                                " failed authentication"));
+  }
+}
+
+} // namespace envelope
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,90 @@
+#ifndef NDN_EPAC_CORE_CHUNK_CIPHER_HPP
+#define NDN_EPAC_CORE_CHUNK_CIPHER_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <cryptopp/aes.h>
+#include <cryptopp/gcm.h>
+
+namespace ndn {
+namespace epac {
+namespace envelope {
+
+/** \brief AES-GCM over a sequence of independently authenticated chunks
+ *
+ *  Chunk i is encrypted under the envelope IV with its last four octets XORed with i,
+ *  and authenticates a one-octet flag marking the last chunk, so that chunks cannot be
+ *  reordered, and the payload cannot be truncated at a chunk boundary without detection.
+ *  A chunk is therefore released only after its own tag is verified, and neither side
+ *  needs more than one chunk of working memory.
+ */
+class ChunkCipher : noncopyable
+{
+public:
+  /** \brief maximum number of chunks in one payload
+   */
+  static const uint64_t MAX_CHUNKS;
+
+protected:
+  ChunkCipher(const Buffer& iv);
+
+  /** \brief compute the IV of the next chunk into m_chunkIv
+   *  \throw Error too many chunks, or a chunk follows the last one
+   */
+  void
+  nextChunk(bool isLast);
+
+protected:
+  Buffer m_iv;
+  Buffer m_chunkIv;
+  uint64_t m_nChunks;
+  bool m_isFinished;
+};
+
+class ChunkEncryptor : public ChunkCipher
+{
+public:
+  ChunkEncryptor(const Buffer& contentKey, const Buffer& iv);
+
+  /** \brief encrypt the next chunk of \p size octets at \p input
+   *  \param output receives \p size + TAG_SIZE octets; may be equal to \p input
+   *  \param isLast whether this is the last chunk of the payload
+   */
+  void
+  encrypt(const uint8_t* input, size_t size, bool isLast, uint8_t* output);
+
+private:
+  CryptoPP::GCM<CryptoPP::AES>::Encryption m_gcm;
+};
+
+class ChunkDecryptor : public ChunkCipher
+{
+public:
+  ChunkDecryptor(const Buffer& contentKey, const Buffer& iv);
+
+  /** \brief decrypt and authenticate the next chunk of \p size octets (including the tag)
+   *  \param output receives \p size - TAG_SIZE octets; may be equal to \p input
+   *  \throw Error chunk shorter than the tag, or authentication failed
+   */
+  void
+  decrypt(const uint8_t* input, size_t size, bool isLast, uint8_t* output);
+
+  /** \return whether the last chunk has been decrypted
+   */
+  bool
+  isFinished() const
+  {
+    return m_isFinished;
+  }
+
+private:
+  CryptoPP::GCM<CryptoPP::AES>::Decryption m_gcm;
+};
+
+} // namespace envelope
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_CHUNK_CIPHER_HPP
@@ -0,0 +1,195 @@
+#include "crypto-backend.hpp"
+
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/ecp.h>
+#include <cryptopp/oids.h>
+
+namespace ndn {
+namespace epac {
+
+template<typename T, typename Key>
+static const T&
+castKey(const Key& key, const std::string& algorithm)
+{
+  const T* typedKey = dynamic_cast<const T*>(&key);
+  if (typedKey == nullptr) {
+    BOOST_THROW_EXCEPTION(CryptoBackend::Error("Key is not a " + algorithm + " key"));
+  }
+  return *typedKey;
+}
+
+/** \brief RSA-OAEP with SHA-1, 1024-bit keys
+ */
+class RsaOaepBackend : public CryptoBackend
+{
+public:
+  std::string
+  getName() const final
+  {
+    return "rsa";
+  }
+
+  Type
+  getType() const final
+  {
+    return RSA_OAEP;
+  }
+
+  shared_ptr<CryptoPP::PrivateKey>
+  generatePrivateKey(CryptoPP::RandomNumberGenerator& rng) const final
+  {
+    auto key = make_shared<CryptoPP::RSA::PrivateKey>();
+    key->GenerateRandomWithKeySize(rng, KEY_SIZE);
+    return key;
+  }
+
+  shared_ptr<CryptoPP::PublicKey>
+  makePublicKey(const CryptoPP::PrivateKey& privateKey) const final
+  {
+    return make_shared<CryptoPP::RSA::PublicKey>(
+      castKey<CryptoPP::RSA::PrivateKey>(privateKey, getName()));
+  }
+
+  shared_ptr<CryptoPP::PublicKey>
+  createPublicKey() const final
+  {
+    return make_shared<CryptoPP::RSA::PublicKey>();
+  }
+
+  shared_ptr<CryptoPP::PrivateKey>
+  createPrivateKey() const final
+  {
+    return make_shared<CryptoPP::RSA::PrivateKey>();
+  }
+
+  unique_ptr<CryptoPP::PK_Encryptor>
+  makeEncryptor(const CryptoPP::PublicKey& publicKey) const final
+  {
+    const auto& key = castKey<CryptoPP::RSA::PublicKey>(publicKey, getName());
+    return unique_ptr<CryptoPP::PK_Encryptor>(new CryptoPP::RSAES_OAEP_SHA_Encryptor(key));
+  }
+
+  unique_ptr<CryptoPP::PK_Decryptor>
+  makeDecryptor(const CryptoPP::PrivateKey& privateKey) const final
+  {
+    const auto& key = castKey<CryptoPP::RSA::PrivateKey>(privateKey, getName());
+    return unique_ptr<CryptoPP::PK_Decryptor>(new CryptoPP::RSAES_OAEP_SHA_Decryptor(key));
+  }
+
+private:
+  static const unsigned int KEY_SIZE = 1024;
+};
+
+/** \brief ECIES over NIST P-256 with compressed ephemeral points
+ *
+ *  Key generation is a single scalar multiplication, and a wrapped 16-octet content key takes
+ *  69 octets (compressed point, ciphertext, HMAC) instead of the 128 octets of RSA-1024.
+ */
+class EciesP256Backend : public CryptoBackend
+{
+public:
+  typedef CryptoPP::ECIES<CryptoPP::ECP> Ecies;
+
+  std::string
+  getName() const final
+  {
+    return "ecies";
+  }
+
+  Type
+  getType() const final
+  {
+    return ECIES_P256;
+  }
+
+  shared_ptr<CryptoPP::PrivateKey>
+  generatePrivateKey(CryptoPP::RandomNumberGenerator& rng) const final
+  {
+    auto key = make_shared<Ecies::PrivateKey>();
+    key->Initialize(rng, CryptoPP::ASN1::secp256r1());
+    return key;
+  }
+
+  shared_ptr<CryptoPP::PublicKey>
+  makePublicKey(const CryptoPP::PrivateKey& privateKey) const final
+  {
+    auto key = make_shared<Ecies::PublicKey>();
+    castKey<Ecies::PrivateKey>(privateKey, getName()).MakePublicKey(*key);
+    return key;
+  }
+
+  shared_ptr<CryptoPP::PublicKey>
+  createPublicKey() const final
+  {
+    return make_shared<Ecies::PublicKey>();
+  }
+
+  shared_ptr<CryptoPP::PrivateKey>
+  createPrivateKey() const final
+  {
+    return make_shared<Ecies::PrivateKey>();
+  }
+
+  unique_ptr<CryptoPP::PK_Encryptor>
+  makeEncryptor(const CryptoPP::PublicKey& publicKey) const final
+  {
+    const auto& key = castKey<Ecies::PublicKey>(publicKey, getName());
+    unique_ptr<Ecies::Encryptor> encryptor(new Ecies::Encryptor(key));
+    encryptor->AccessKey().AccessGroupParameters().SetPointCompression(true);
+    return std::move(encryptor);
+  }
+
+  unique_ptr<CryptoPP::PK_Decryptor>
+  makeDecryptor(const CryptoPP::PrivateKey& privateKey) const final
+  {
+    const auto& key = castKey<Ecies::PrivateKey>(privateKey, getName());
+    unique_ptr<Ecies::Decryptor> decryptor(new Ecies::Decryptor(key));
+    decryptor->AccessKey().AccessGroupParameters().SetPointCompression(true);
+    return std::move(decryptor);
+  }
+};
+
+static const RsaOaepBackend g_rsaOaep{};
+static const EciesP256Backend g_eciesP256{};
+static const CryptoBackend* const g_backends[] = {&g_rsaOaep, &g_eciesP256};
+
+const CryptoBackend&
+CryptoBackend::get(const std::string& name)
+{
+  for (const CryptoBackend* backend : g_backends) {
+    if (backend->getName() == name) {
+      return *backend;
+    }
+  }
+  BOOST_THROW_EXCEPTION(Error("Unknown algorithm '" + name + "'"));
+}
+
+const CryptoBackend&
+CryptoBackend::get(uint64_t type)
+{
+  for (const CryptoBackend* backend : g_backends) {
+    if (static_cast<uint64_t>(backend->getType()) == type) {
+      return *backend;
+    }
+  }
+  BOOST_THROW_EXCEPTION(Error("Unknown algorithm type " + std::to_string(type)));
+}
+
+const CryptoBackend&
+CryptoBackend::getDefault()
+{
+  return g_rsaOaep;
+}
+
+std::vector<std::string>
+CryptoBackend::getNames()
+{
+  std::vector<std::string> names;
+  for (const CryptoBackend* backend : g_backends) {
+    names.push_back(backend->getName());
+  }
+  return names;
+}
+
+} // namespace epac
+} // namespace ndn
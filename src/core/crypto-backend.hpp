@@ -0,0 +1,99 @@
+#ifndef NDN_EPAC_CORE_CRYPTO_BACKEND_HPP
+#define NDN_EPAC_CORE_CRYPTO_BACKEND_HPP
+
+#include "common.hpp"
+
+namespace ndn {
+namespace epac {
+
+/** \brief public-key algorithm used to wrap content keys
+ *
+ *  Keys are handled through the generic Crypto++ CryptoPP::PublicKey and CryptoPP::PrivateKey
+ *  interfaces and saved in their DER (X.509 / PKCS #8) encodings; a backend creates, derives
+ *  and loads keys of its algorithm and builds encryptors and decryptors for them.
+ */
+class CryptoBackend : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /** \brief code of each algorithm, carried in the Algorithm field of the envelope
+   */
+  enum Type {
+    RSA_OAEP = 1,
+    ECIES_P256 = 2
+  };
+
+  virtual
+  ~CryptoBackend() = default;
+
+  /** \return name of the algorithm on the command line
+   */
+  virtual std::string
+  getName() const = 0;
+
+  virtual Type
+  getType() const = 0;
+
+  virtual shared_ptr<CryptoPP::PrivateKey>
+  generatePrivateKey(CryptoPP::RandomNumberGenerator& rng) const = 0;
+
+  virtual shared_ptr<CryptoPP::PublicKey>
+  makePublicKey(const CryptoPP::PrivateKey& privateKey) const = 0;
+
+  /** \return empty public key to be filled by CryptoMaterial::Load
+   */
+  virtual shared_ptr<CryptoPP::PublicKey>
+  createPublicKey() const = 0;
+
+  /** \return empty private key to be filled by CryptoMaterial::Load
+   */
+  virtual shared_ptr<CryptoPP::PrivateKey>
+  createPrivateKey() const = 0;
+
+  /** \throw Error \p publicKey is not a key of this algorithm
+   */
+  virtual unique_ptr<CryptoPP::PK_Encryptor>
+  makeEncryptor(const CryptoPP::PublicKey& publicKey) const = 0;
+
+  /** \throw Error \p privateKey is not a key of this algorithm
+   */
+  virtual unique_ptr<CryptoPP::PK_Decryptor>
+  makeDecryptor(const CryptoPP::PrivateKey& privateKey) const = 0;
+
+public:
+  /** \return backend registered under \p name
+   *  \throw Error no such backend
+   */
+  static const CryptoBackend&
+  get(const std::string& name);
+
+  /** \return backend of \p type
+   *  \throw Error no such backend
+   */
+  static const CryptoBackend&
+  get(uint64_t type);
+
+  /** \return the backend used when none is selected (RSA-OAEP)
+   */
+  static const CryptoBackend&
+  getDefault();
+
+  /** \return names of all backends
+   */
+  static std::vector<std::string>
+  getNames();
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_CRYPTO_BACKEND_HPP
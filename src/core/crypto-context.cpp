@@ -0,0 +1,87 @@
+#include "crypto-context.hpp"
+
+namespace ndn {
+namespace epac {
+
+const size_t CryptoContext::MAX_CACHED_KEYS = 1024;
+
+CryptoContext&
+CryptoContext::get()
+{
+  static thread_local CryptoContext context;
+  return context;
+}
+
+const CryptoPP::PK_Encryptor&
+CryptoContext::getEncryptor(const CryptoBackend& backend,
+                            const shared_ptr<const CryptoPP::PublicKey>& key)
+{
+  BOOST_ASSERT(key != nullptr);
+
+  auto it = m_encryptors.find(key.get());
+  if (it != m_encryptors.end()) {
+    return *it->second.operation;
+  }
+
+  if (m_encryptors.size() >= MAX_CACHED_KEYS) {
+    m_encryptors.clear();
+  }
+
+  auto encryptor = backend.makeEncryptor(*key);
+  auto& entry = m_encryptors[key.get()];
+  entry.key = key;
+  entry.operation = std::move(encryptor);
+  return *entry.operation;
+}
+
+const CryptoPP::PK_Decryptor&
+CryptoContext::getDecryptor(const CryptoBackend& backend,
+                            const shared_ptr<const CryptoPP::PrivateKey>& key)
+{
+  BOOST_ASSERT(key != nullptr);
+
+  auto it = m_decryptors.find(key.get());
+  if (it != m_decryptors.end()) {
+    return *it->second.operation;
+  }
+
+  if (m_decryptors.size() >= MAX_CACHED_KEYS) {
+    m_decryptors.clear();
+  }
+
+  auto decryptor = backend.makeDecryptor(*key);
+  auto& entry = m_decryptors[key.get()];
+  entry.key = key;
+  entry.operation = std::move(decryptor);
+  return *entry.operation;
+}
+
+CryptoPP::GCM<CryptoPP::AES>::Encryption&
+CryptoContext::getContentEncryption(const Buffer& contentKey, const Buffer& iv)
+{
+  if (contentKey != m_encryptionKey) {
+    m_contentEncryption.SetKeyWithIV(contentKey.data(), contentKey.size(), iv.data(), iv.size());
+    m_encryptionKey = contentKey;
+  }
+  return m_contentEncryption;
+}
+
+CryptoPP::GCM<CryptoPP::AES>::Decryption&
+CryptoContext::getContentDecryption(const Buffer& contentKey, const Buffer& iv)
+{
+  if (contentKey != m_decryptionKey) {
+    m_contentDecryption.SetKeyWithIV(contentKey.data(), contentKey.size(), iv.data(), iv.size());
+    m_decryptionKey = contentKey;
+  }
+  return m_contentDecryption;
+}
+
+void
+CryptoContext::clear()
+{
+  m_encryptors.clear();
+  m_decryptors.clear();
+}
+
+} // namespace epac
+} // namespace ndn
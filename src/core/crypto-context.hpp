@@ -0,0 +1,111 @@
+#ifndef NDN_EPAC_CORE_CRYPTO_CONTEXT_HPP
+#define NDN_EPAC_CORE_CRYPTO_CONTEXT_HPP
+
+#include "common.hpp"
+#include "crypto-backend.hpp"
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <cryptopp/aes.h>
+#include <cryptopp/gcm.h>
+
+namespace ndn {
+namespace epac {
+
+/** \brief per-thread cache of cryptographic objects
+ *
+ *  Constructing an AutoSeededRandomPool reseeds from the operating system, and constructing
+ *  public-key encryptors and AES-GCM ciphers is not free either. CryptoContext owns one RNG
+ *  per thread and keeps encryptors/decryptors keyed by the identity of the key object,
+ *  so that per-Interest encryption only pays for the cryptographic operation itself.
+ *
+ *  A key is identified by the address of the shared key object; the cache holds a reference
+ *  to the key, so the address cannot be reused while the entry exists.
+ *
+ *  \note Each thread has its own context; a context must not be shared between threads.
+ */
+class CryptoContext : noncopyable
+{
+public:
+  /** \return the context of the calling thread
+   */
+  static CryptoContext&
+  get();
+
+  CryptoPP::RandomNumberGenerator&
+  getRng()
+  {
+    return m_rng;
+  }
+
+  /** \return encryptor for \p key made by \p backend, constructed on first use
+   *  \throw CryptoBackend::Error \p key does not belong to \p backend
+   */
+  const CryptoPP::PK_Encryptor&
+  getEncryptor(const CryptoBackend& backend, const shared_ptr<const CryptoPP::PublicKey>& key);
+
+  /** \return decryptor for \p key made by \p backend, constructed on first use
+   *  \throw CryptoBackend::Error \p key does not belong to \p backend
+   */
+  const CryptoPP::PK_Decryptor&
+  getDecryptor(const CryptoBackend& backend, const shared_ptr<const CryptoPP::PrivateKey>& key);
+
+  /** \return AES-GCM encryption keyed with \p contentKey
+   *
+   *  The key schedule is recomputed only when \p contentKey differs from the previous call.
+   *  \p iv is used when rekeying; callers still pass the IV to every operation.
+   */
+  CryptoPP::GCM<CryptoPP::AES>::Encryption&
+  getContentEncryption(const Buffer& contentKey, const Buffer& iv);
+
+  /** \return AES-GCM decryption keyed with \p contentKey
+   */
+  CryptoPP::GCM<CryptoPP::AES>::Decryption&
+  getContentDecryption(const Buffer& contentKey, const Buffer& iv);
+
+  /** \return number of cached encryptors and decryptors
+   */
+  size_t
+  size() const
+  {
+    return m_encryptors.size() + m_decryptors.size();
+  }
+
+  /** \brief drop all cached encryptors and decryptors
+   */
+  void
+  clear();
+
+public:
+  /** \brief maximum number of keys cached per direction; the cache is flushed when exceeded
+   */
+  static const size_t MAX_CACHED_KEYS;
+
+private:
+  CryptoContext() = default;
+
+  template<typename Key, typename Operation>
+  struct CacheEntry
+  {
+    shared_ptr<const Key> key;
+    unique_ptr<Operation> operation;
+  };
+
+private:
+  CryptoPP::AutoSeededRandomPool m_rng;
+
+  std::unordered_map<const void*, CacheEntry<CryptoPP::PublicKey,
+                                             CryptoPP::PK_Encryptor>> m_encryptors;
+  std::unordered_map<const void*, CacheEntry<CryptoPP::PrivateKey,
+                                             CryptoPP::PK_Decryptor>> m_decryptors;
+
+  CryptoPP::GCM<CryptoPP::AES>::Encryption m_contentEncryption;
+  CryptoPP::GCM<CryptoPP::AES>::Decryption m_contentDecryption;
+  Buffer m_encryptionKey;
+  Buffer m_decryptionKey;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_CRYPTO_CONTEXT_HPP
@@ -0,0 +1,275 @@
+#include "cuckoo-filter.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+#include <cmath>
+
+namespace ndn {
+namespace epac {
+
+/** \brief relocations tried before an insertion gives up
+ */
+static const size_t MAX_KICKS = 500;
+
+static const size_t MIN_FINGERPRINT_SIZE = 4;
+static const size_t MAX_FINGERPRINT_SIZE = 32;
+
+const size_t CuckooFilter::BUCKET_SIZE;
+
+CuckooFilter::CuckooFilter(size_t capacity, double falsePositiveRate)
+{
+  BOOST_ASSERT(falsePositiveRate > 0 && falsePositiveRate < 1);
+
+  double bits = std::ceil(std::log2(2 * BUCKET_SIZE / falsePositiveRate));
+  size_t fingerprintSize = std::min(std::max(static_cast<size_t>(bits), MIN_FINGERPRINT_SIZE),
+                                    MAX_FINGERPRINT_SIZE);
+
+  // buckets fill up to about 95% before insertions start to fail
+  size_t nBuckets = 1;
+  while (nBuckets * BUCKET_SIZE * 19 < capacity * 20) {
+    nBuckets *= 2;
+  }
+  reset(nBuckets, fingerprintSize);
+}
+
+CuckooFilter::CuckooFilter(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+void
+CuckooFilter::reset(size_t nBuckets, size_t fingerprintSize)
+{
+  m_nBuckets = nBuckets;
+  m_fingerprintSize = fingerprintSize;
+  m_fingerprintMask = static_cast<uint32_t>((uint64_t(1) << fingerprintSize) - 1);
+  m_size = 0;
+  m_table.assign((nBuckets * BUCKET_SIZE * fingerprintSize + 63) / 64, 0);
+  m_random = 0x9e3779b97f4a7c15;
+}
+
+uint64_t
+CuckooFilter::hash(const std::string& key)
+{
+  uint64_t h = 14695981039346656037u;
+  for (char c : key) {
+    h = (h ^ static_cast<uint8_t>(c)) * 1099511628211u;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccd;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53;
+  h ^= h >> 33;
+  return h;
+}
+
+uint32_t
+CuckooFilter::getFingerprint(uint64_t hash) const
+{
+  uint32_t fingerprint = static_cast<uint32_t>(hash >> 32) & m_fingerprintMask;
+  return fingerprint != 0 ? fingerprint : 1;
+}
+
+size_t
+CuckooFilter::getAltBucket(size_t bucket, uint32_t fingerprint) const
+{
+  return (bucket ^ (uint64_t(fingerprint) * 0x5bd1e995)) & (m_nBuckets - 1);
+}
+
+uint32_t
+CuckooFilter::getSlot(size_t slot) const
+{
+  size_t bit = slot * m_fingerprintSize;
+  size_t word = bit / 64;
+  size_t offset = bit % 64;
+  uint64_t value = m_table[word] >> offset;
+  if (offset + m_fingerprintSize > 64) {
+    value |= m_table[word + 1] << (64 - offset);
+  }
+  return static_cast<uint32_t>(value) & m_fingerprintMask;
+}
+
+void
+CuckooFilter::setSlot(size_t slot, uint32_t fingerprint)
+{
+  size_t bit = slot * m_fingerprintSize;
+  size_t word = bit / 64;
+  size_t offset = bit % 64;
+  m_table[word] = (m_table[word] & ~(uint64_t(m_fingerprintMask) << offset)) |
+                  (uint64_t(fingerprint) << offset);
+  if (offset + m_fingerprintSize > 64) {
+    size_t shift = 64 - offset;
+    m_table[word + 1] = (m_table[word + 1] & ~(uint64_t(m_fingerprintMask) >> shift)) |
+                        (uint64_t(fingerprint) >> shift);
+  }
+}
+
+uint64_t
+CuckooFilter::nextRandom()
+{
+  m_random ^= m_random << 13;
+  m_random ^= m_random >> 7;
+  m_random ^= m_random << 17;
+  return m_random;
+}
+
+bool
+CuckooFilter::insertInto(size_t bucket, uint32_t fingerprint)
+{
+  for (size_t slot = bucket * BUCKET_SIZE; slot < (bucket + 1) * BUCKET_SIZE; ++slot) {
+    if (getSlot(slot) == 0) {
+      setSlot(slot, fingerprint);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+CuckooFilter::containsIn(size_t bucket, uint32_t fingerprint) const
+{
+  for (size_t slot = bucket * BUCKET_SIZE; slot < (bucket + 1) * BUCKET_SIZE; ++slot) {
+    if (getSlot(slot) == fingerprint) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+CuckooFilter::insert(const std::string& key)
+{
+  uint64_t h = hash(key);
+  uint32_t fingerprint = getFingerprint(h);
+  size_t bucket = h & (m_nBuckets - 1);
+  if (insertInto(bucket, fingerprint) ||
+      insertInto(getAltBucket(bucket, fingerprint), fingerprint)) {
+    ++m_size;
+    return true;
+  }
+
+  // move fingerprints to their other bucket until one lands in an empty slot; the moves are
+  // recorded, so that they can be undone if none does
+  std::vector<std::pair<size_t, uint32_t>> moves;
+  moves.reserve(MAX_KICKS);
+  if ((nextRandom() & 1) != 0) {
+    bucket = getAltBucket(bucket, fingerprint);
+  }
+  for (size_t n = 0; n < MAX_KICKS; ++n) {
+    size_t slot = bucket * BUCKET_SIZE + nextRandom() % BUCKET_SIZE;
+    uint32_t victim = getSlot(slot);
+    setSlot(slot, fingerprint);
+    moves.emplace_back(slot, victim);
+
+    fingerprint = victim;
+    bucket = getAltBucket(bucket, fingerprint);
+    if (insertInto(bucket, fingerprint)) {
+      ++m_size;
+      return true;
+    }
+  }
+
+  for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+    setSlot(it->first, it->second);
+  }
+  return false;
+}
+
+bool
+CuckooFilter::remove(const std::string& key)
+{
+  uint64_t h = hash(key);
+  uint32_t fingerprint = getFingerprint(h);
+  size_t bucket = h & (m_nBuckets - 1);
+  for (size_t b : {bucket, getAltBucket(bucket, fingerprint)}) {
+    for (size_t slot = b * BUCKET_SIZE; slot < (b + 1) * BUCKET_SIZE; ++slot) {
+      if (getSlot(slot) == fingerprint) {
+        setSlot(slot, 0);
+        --m_size;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool
+CuckooFilter::contains(const std::string& key) const
+{
+  uint64_t h = hash(key);
+  uint32_t fingerprint = getFingerprint(h);
+  size_t bucket = h & (m_nBuckets - 1);
+  return containsIn(bucket, fingerprint) ||
+         containsIn(getAltBucket(bucket, fingerprint), fingerprint);
+}
+
+Block
+CuckooFilter::wireEncode() const
+{
+  // words are written least significant octet first
+  Buffer table(getTableSize());
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = static_cast<uint8_t>(m_table[i / 8] >> (8 * (i % 8)));
+  }
+
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+  totalLength += encoding::prependByteArrayBlock(encoder, tlv::FilterTable,
+                                                 table.data(), table.size());
+  totalLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::BucketCount, m_nBuckets);
+  totalLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::FingerprintSize,
+                                                          m_fingerprintSize);
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::UserFilter);
+
+  return encoder.block();
+}
+
+void
+CuckooFilter::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::UserFilter) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(wire.type()) +
+                                " while decoding UserFilter"));
+  }
+
+  uint64_t fingerprintSize = 0;
+  uint64_t nBuckets = 0;
+  const uint8_t* table = nullptr;
+  size_t tableSize = 0;
+  try {
+    wire.parse();
+    fingerprintSize = encoding::readNonNegativeInteger(wire.get(tlv::FingerprintSize));
+    nBuckets = encoding::readNonNegativeInteger(wire.get(tlv::BucketCount));
+    const Block& tableBlock = wire.get(tlv::FilterTable);
+    table = tableBlock.value();
+    tableSize = tableBlock.value_size();
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed UserFilter: ") + e.what()));
+  }
+
+  if (fingerprintSize < MIN_FINGERPRINT_SIZE || fingerprintSize > MAX_FINGERPRINT_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected FingerprintSize " + std::to_string(fingerprintSize)));
+  }
+  if (nBuckets == 0 || (nBuckets & (nBuckets - 1)) != 0 ||
+      nBuckets > (uint64_t(1) << 40) / fingerprintSize) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected BucketCount " + std::to_string(nBuckets)));
+  }
+
+  if (tableSize != (nBuckets * BUCKET_SIZE * fingerprintSize + 7) / 8) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected FilterTable size " + std::to_string(tableSize)));
+  }
+
+  reset(static_cast<size_t>(nBuckets), static_cast<size_t>(fingerprintSize));
+  for (size_t i = 0; i < tableSize; ++i) {
+    m_table[i / 8] |= uint64_t(table[i]) << (8 * (i % 8));
+  }
+  for (size_t slot = 0; slot < m_nBuckets * BUCKET_SIZE; ++slot) {
+    m_size += getSlot(slot) != 0;
+  }
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,147 @@
+#ifndef NDN_EPAC_CORE_CUCKOO_FILTER_HPP
+#define NDN_EPAC_CORE_CUCKOO_FILTER_HPP
+
+#include "common.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+
+namespace ndn {
+namespace epac {
+
+/** \brief compact set of strings answering membership with a bounded false positive rate
+ *
+ *  A cuckoo filter: each string is reduced to a fingerprint of a few bits stored in one of two
+ *  buckets of BUCKET_SIZE slots, so a lookup reads two buckets and never misses a string that
+ *  was inserted. Unlike a Bloom filter, a string can be removed again. A string that was not
+ *  inserted matches with probability about 2 * BUCKET_SIZE / 2^f for fingerprints of f bits.
+ *
+ *  A string is hashed with 64-bit FNV-1a followed by the finalizer of MurmurHash3. Its
+ *  fingerprint is bits 32 and up of the hash, or 1 where those are all zero; its first bucket
+ *  is the hash modulo the number of buckets, a power of two, and its second bucket the first
+ *  one XOR the fingerprint times 0x5bd1e995, modulo the number of buckets.
+ *
+ *  Slots are packed into 64-bit words without padding, so the table takes
+ *  f * BUCKET_SIZE bits per bucket.
+ */
+class CuckooFilter
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /** \brief make an empty filter for about \p capacity strings, with false positive rate
+   *         at most \p falsePositiveRate
+   */
+  CuckooFilter(size_t capacity, double falsePositiveRate);
+
+  explicit
+  CuckooFilter(const Block& wire);
+
+  /** \brief insert \p key
+   *  \return false if there is no room left for \p key; the filter is unchanged then
+   */
+  bool
+  insert(const std::string& key);
+
+  /** \brief remove \p key
+   *  \pre \p key was inserted; removing another string may remove one that matches it
+   *  \return whether a matching fingerprint was removed
+   */
+  bool
+  remove(const std::string& key);
+
+  /** \return whether \p key may have been inserted
+   */
+  bool
+  contains(const std::string& key) const;
+
+  /** \return number of inserted strings
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  size_t
+  getNBuckets() const
+  {
+    return m_nBuckets;
+  }
+
+  size_t
+  getFingerprintSize() const
+  {
+    return m_fingerprintSize;
+  }
+
+  /** \return size of the table in octets
+   */
+  size_t
+  getTableSize() const
+  {
+    return (m_nBuckets * BUCKET_SIZE * m_fingerprintSize + 7) / 8;
+  }
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+public:
+  static const size_t BUCKET_SIZE = 4;
+
+private:
+  static uint64_t
+  hash(const std::string& key);
+
+  uint32_t
+  getFingerprint(uint64_t hash) const;
+
+  size_t
+  getAltBucket(size_t bucket, uint32_t fingerprint) const;
+
+  uint32_t
+  getSlot(size_t slot) const;
+
+  void
+  setSlot(size_t slot, uint32_t fingerprint);
+
+  uint64_t
+  nextRandom();
+
+  /** \return whether \p fingerprint was stored into an empty slot of \p bucket
+   */
+  bool
+  insertInto(size_t bucket, uint32_t fingerprint);
+
+  bool
+  containsIn(size_t bucket, uint32_t fingerprint) const;
+
+  void
+  reset(size_t nBuckets, size_t fingerprintSize);
+
+private:
+  size_t m_nBuckets;
+  size_t m_fingerprintSize;
+  uint32_t m_fingerprintMask;
+  size_t m_size;
+  std::vector<uint64_t> m_table;
+  /** \brief state of the xorshift generator picking fingerprints to relocate
+   */
+  uint64_t m_random;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_CUCKOO_FILTER_HPP
@@ -0,0 +1,449 @@
+#include "envelope.hpp"
+#include "chunk-cipher.hpp"
+#include "crypto-context.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace ndn {
+namespace epac {
+namespace envelope {
+
+Header::Header()
+  : m_algorithm(CryptoBackend::RSA_OAEP)
+  , m_chunkSize(0)
+{
+}
+
+Header::Header(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+Block
+Header::wireEncode() const
+{
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  if (m_chunkSize > 0) {
+    totalLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::ChunkSize, m_chunkSize);
+  }
+  totalLength += encoding::prependByteArrayBlock(encoder, tlv::InitialVector,
+                                                 m_iv.data(), m_iv.size());
+  totalLength += encoding::prependByteArrayBlock(encoder, tlv::WrappedKey,
+                                                 m_wrappedKey.data(), m_wrappedKey.size());
+  totalLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::Algorithm, m_algorithm);
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::EnvelopeHeader);
+
+  return encoder.block();
+}
+
+void
+Header::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::EnvelopeHeader) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(wire.type()) +
+                                " while decoding EnvelopeHeader"));
+  }
+
+  try {
+    wire.parse();
+    auto algorithm = wire.find(tlv::Algorithm);
+    if (algorithm != wire.elements_end()) {
+      m_algorithm = encoding::readNonNegativeInteger(*algorithm);
+    }
+    else {
+      m_algorithm = CryptoBackend::RSA_OAEP;
+    }
+    const Block& wrappedKey = wire.get(tlv::WrappedKey);
+    const Block& iv = wire.get(tlv::InitialVector);
+    m_wrappedKey = Buffer(wrappedKey.value(), wrappedKey.value_size());
+    m_iv = Buffer(iv.value(), iv.value_size());
+
+    auto chunkSize = wire.find(tlv::ChunkSize);
+    if (chunkSize != wire.elements_end()) {
+      m_chunkSize = encoding::readNonNegativeInteger(*chunkSize);
+      if (m_chunkSize > std::numeric_limits<uint32_t>::max()) {
+        BOOST_THROW_EXCEPTION(Error("Unexpected ChunkSize " + std::to_string(m_chunkSize)));
+      }
+    }
+    else {
+      m_chunkSize = 0;
+    }
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed EnvelopeHeader: ") + e.what()));
+  }
+
+  if (m_iv.size() != IV_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected InitialVector size " + std::to_string(m_iv.size())));
+  }
+}
+
+Buffer
+generateContentKey()
+{
+  Buffer key(CONTENT_KEY_SIZE);
+  CryptoContext::get().getRng().GenerateBlock(key.data(), key.size());
+  return key;
+}
+
+Buffer
+generateInitialVector()
+{
+  Buffer iv(IV_SIZE);
+  CryptoContext::get().getRng().GenerateBlock(iv.data(), iv.size());
+  return iv;
+}
+
+Buffer
+wrapKey(const Buffer& contentKey, const CryptoBackend& backend,
+        const shared_ptr<const CryptoPP::PublicKey>& key)
+{
+  CryptoContext& context = CryptoContext::get();
+  const CryptoPP::PK_Encryptor& encryptor = context.getEncryptor(backend, key);
+
+  Buffer wrapped(encryptor.CiphertextLength(contentKey.size()));
+  encryptor.Encrypt(context.getRng(), contentKey.data(), contentKey.size(), wrapped.data());
+  return wrapped;
+}
+
+Buffer
+unwrapKey(const Buffer& wrappedKey, const CryptoBackend& backend,
+          const shared_ptr<const CryptoPP::PrivateKey>& key)
+{
+  CryptoContext& context = CryptoContext::get();
+  const CryptoPP::PK_Decryptor& decryptor = context.getDecryptor(backend, key);
+
+  Buffer contentKey(decryptor.MaxPlaintextLength(wrappedKey.size()));
+  if (contentKey.empty()) {
+    BOOST_THROW_EXCEPTION(Error("WrappedKey does not match the size of the private key"));
+  }
+
+  CryptoPP::DecodingResult result;
+  try {
+    result = decryptor.Decrypt(context.getRng(), wrappedKey.data(), wrappedKey.size(),
+                               contentKey.data());
+  }
+  catch (const CryptoPP::Exception& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Cannot unwrap content key: ") + e.what()));
+  }
+
+  if (!result.isValidCoding || result.messageLength != CONTENT_KEY_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Cannot unwrap content key: wrong private key"));
+  }
+
+  contentKey.resize(result.messageLength);
+  return contentKey;
+}
+
+/** \brief encrypt \p size octets at \p payload into \p output
+ *  \param output must have room for \p size + TAG_SIZE octets
+ */
+static void
+encryptInto(const Buffer& contentKey, const Buffer& iv,
+            const uint8_t* payload, size_t size, uint8_t* output)
+{
+  auto& encryption = CryptoContext::get().getContentEncryption(contentKey, iv);
+  encryption.EncryptAndAuthenticate(output, output + size, TAG_SIZE,
+                                    iv.data(), static_cast<int>(iv.size()),
+                                    nullptr, 0, payload, size);
+}
+
+Buffer
+encryptPayload(const Buffer& contentKey, const Buffer& iv, const uint8_t* payload, size_t size)
+{
+  Buffer cipher(size + TAG_SIZE);
+  encryptInto(contentKey, iv, payload, size, cipher.data());
+  return cipher;
+}
+
+Buffer
+decryptPayload(const Buffer& contentKey, const Buffer& iv, const uint8_t* cipher, size_t size)
+{
+  if (size < TAG_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Encrypted payload is shorter than the authentication tag"));
+  }
+
+  size_t payloadSize = size - TAG_SIZE;
+  Buffer payload(payloadSize);
+
+  auto& decryption = CryptoContext::get().getContentDecryption(contentKey, iv);
+  bool isAuthentic = decryption.DecryptAndVerify(payload.data(), cipher + payloadSize, TAG_SIZE,
+                                                 iv.data(), static_cast<int>(iv.size()),
+                                                 nullptr, 0, cipher, payloadSize);
+  if (!isAuthentic) {
+    BOOST_THROW_EXCEPTION(Error("Encrypted payload failed authentication"));
+  }
+
+  return payload;
+}
+
+Buffer
+wrapKey(const Buffer& key, const Buffer& wrappingKey)
+{
+  Buffer iv = generateInitialVector();
+  Buffer wrapped(IV_SIZE + key.size() + TAG_SIZE);
+  std::copy(iv.begin(), iv.end(), wrapped.begin());
+  encryptInto(wrappingKey, iv, key.data(), key.size(), wrapped.data() + IV_SIZE);
+  return wrapped;
+}
+
+Buffer
+unwrapKey(const Buffer& wrappedKey, const Buffer& wrappingKey)
+{
+  if (wrappedKey.size() != IV_SIZE + CONTENT_KEY_SIZE + TAG_SIZE) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected WrappedKey size " +
+                                std::to_string(wrappedKey.size())));
+  }
+
+  Buffer iv(wrappedKey.data(), IV_SIZE);
+  return decryptPayload(wrappingKey, iv, wrappedKey.data() + IV_SIZE,
+                        wrappedKey.size() - IV_SIZE);
+}
+
+Buffer
+seal(const uint8_t* payload, size_t size, const CryptoBackend& backend,
+     const shared_ptr<const CryptoPP::PublicKey>& key)
+{
+  return seal(payload, size, generateContentKey(), backend, key);
+}
+
+Buffer
+seal(const uint8_t* payload, size_t size, const Buffer& contentKey,
+     const CryptoBackend& backend, const shared_ptr<const CryptoPP::PublicKey>& key)
+{
+  Header header;
+  header.setAlgorithm(backend.getType());
+  header.setWrappedKey(wrapKey(contentKey, backend, key));
+  header.setInitialVector(generateInitialVector());
+  Block headerWire = header.wireEncode();
+
+  Buffer envelope(headerWire.size() + size + TAG_SIZE);
+  std::copy(headerWire.begin(), headerWire.end(), envelope.begin());
+  encryptInto(contentKey, header.getInitialVector(), payload, size,
+              envelope.data() + headerWire.size());
+  return envelope;
+}
+
+/** \return octets left in \p input, or the largest size_t if it cannot seek (e.g. a pipe)
+ */
+static size_t
+getRemainingSize(std::streambuf& input)
+{
+  const std::streampos failed(std::streamoff(-1));
+  std::streampos current = input.pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+  if (current == failed)
+    return std::numeric_limits<size_t>::max();
+
+  std::streampos end = input.pubseekoff(0, std::ios_base::end, std::ios_base::in);
+  input.pubseekpos(current, std::ios_base::in);
+  if (end == failed || end < current)
+    return std::numeric_limits<size_t>::max();
+
+  return static_cast<size_t>(end - current);
+}
+
+/** \brief read up to \p size octets from \p input into \p output
+ *  \return number of octets read, less than \p size only at end of input
+ */
+static size_t
+readChunk(std::streambuf& input, uint8_t* output, size_t size)
+{
+  size_t nRead = 0;
+  while (nRead < size) {
+    std::streamsize n = input.sgetn(reinterpret_cast<char*>(output + nRead), size - nRead);
+    if (n <= 0) {
+      break;
+    }
+    nRead += static_cast<size_t>(n);
+  }
+  return nRead;
+}
+
+/** \brief write TLV-TYPE and TLV-LENGTH so that they end right before \p end
+ *  \return the start of the written TLV header
+ */
+static uint8_t*
+writeTlvHeaderBefore(uint8_t* end, uint32_t type, uint64_t length)
+{
+  size_t lengthSize = ndn::tlv::sizeOfVarNumber(length);
+  uint8_t* begin = end - ndn::tlv::sizeOfVarNumber(type) - lengthSize;
+
+  uint8_t* p = end - lengthSize;
+  if (lengthSize == 1) {
+    p[0] = static_cast<uint8_t>(length);
+  }
+  else {
+    p[0] = lengthSize == 3 ? 253 : lengthSize == 5 ? 254 : 255;
+    for (size_t i = 1; i < lengthSize; ++i) {
+      p[i] = static_cast<uint8_t>(length >> (8 * (lengthSize - 1 - i)));
+    }
+  }
+
+  BOOST_ASSERT(type < 253);
+  begin[0] = static_cast<uint8_t>(type);
+  return begin;
+}
+
+Sealer::Sealer(const Buffer& contentKey, const CryptoBackend& backend,
+               const shared_ptr<const CryptoPP::PublicKey>& key)
+  : m_contentKey(contentKey)
+{
+  m_header.setAlgorithm(backend.getType());
+  m_header.setWrappedKey(wrapKey(contentKey, backend, key));
+}
+
+Block
+Sealer::sealStream(std::istream& input, size_t maxSize, size_t chunkSize) const
+{
+  BOOST_ASSERT(chunkSize > 0);
+  chunkSize = std::max<size_t>(1, std::min(chunkSize, maxSize));
+
+  Header header = m_header;
+  header.setInitialVector(generateInitialVector());
+  header.setChunkSize(chunkSize);
+  Block headerWire = header.wireEncode();
+
+  // room for the TLV-TYPE and the longest TLV-LENGTH of Content in front of the envelope
+  const size_t tlvHeaderRoom = 1 + 9;
+
+  std::streambuf& in = *input.rdbuf();
+  auto buffer = make_shared<Buffer>(tlvHeaderRoom + headerWire.size());
+  std::copy(headerWire.begin(), headerWire.end(), buffer->begin() + tlvHeaderRoom);
+
+  // an unbounded read from a pipe is the only case in which the size is not known up front
+  size_t expectedSize = std::min(maxSize, getRemainingSize(in));
+  if (expectedSize == std::numeric_limits<size_t>::max())
+    expectedSize = chunkSize;
+  size_t nChunks = std::max<size_t>(1, (expectedSize + chunkSize - 1) / chunkSize);
+  buffer->reserve(buffer->size() + expectedSize + nChunks * TAG_SIZE);
+
+  ChunkEncryptor encryptor(m_contentKey, header.getInitialVector());
+  size_t remaining = maxSize;
+  bool isLast = false;
+  while (!isLast) {
+    size_t wanted = std::min(chunkSize, remaining);
+    size_t offset = buffer->size();
+    buffer->resize(offset + wanted + TAG_SIZE);
+    uint8_t* chunk = buffer->data() + offset;
+
+    size_t n = readChunk(in, chunk, wanted);
+    remaining -= n;
+    isLast = n < wanted || remaining == 0 || in.sgetc() == std::char_traits<char>::eof();
+    encryptor.encrypt(chunk, n, isLast, chunk);
+    buffer->resize(offset + n + TAG_SIZE);
+  }
+
+  uint8_t* envelopeBegin = buffer->data() + tlvHeaderRoom;
+  uint8_t* begin = writeTlvHeaderBefore(envelopeBegin, ndn::tlv::Content,
+                                        buffer->size() - tlvHeaderRoom);
+  return Block(buffer, buffer->begin() + (begin - buffer->data()), buffer->end());
+}
+
+Block
+sealStream(std::istream& input, const Buffer& contentKey, const CryptoBackend& backend,
+           const shared_ptr<const CryptoPP::PublicKey>& key, size_t chunkSize)
+{
+  return Sealer(contentKey, backend, key).sealStream(input, std::numeric_limits<size_t>::max(),
+                                                     chunkSize);
+}
+
+Header
+decodeHeader(const uint8_t* envelope, size_t size, size_t& headerSize)
+{
+  Block headerWire;
+  try {
+    headerWire = Block(envelope, size);
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed envelope: ") + e.what()));
+  }
+
+  headerSize = headerWire.size();
+  return Header(headerWire);
+}
+
+/** \brief call \p f(offset, size, isLast) for each encrypted chunk of a chunked payload
+ */
+template<typename F>
+static void
+forEachChunk(const Header& header, size_t size, const F& f)
+{
+  BOOST_ASSERT(header.getChunkSize() > 0);
+  uint64_t encryptedChunkSize = header.getChunkSize() + TAG_SIZE;
+
+  size_t offset = 0;
+  do {
+    size_t n = static_cast<size_t>(std::min<uint64_t>(encryptedChunkSize, size - offset));
+    f(offset, n, offset + n == size);
+    offset += n;
+  } while (offset < size);
+}
+
+Buffer
+openPayload(const Header& header, const Buffer& contentKey, const uint8_t* cipher, size_t size)
+{
+  if (header.getChunkSize() == 0) {
+    return decryptPayload(contentKey, header.getInitialVector(), cipher, size);
+  }
+
+  uint64_t encryptedChunkSize = header.getChunkSize() + TAG_SIZE;
+  size_t lastChunkSize = static_cast<size_t>(size % encryptedChunkSize);
+  if (size == 0 || (lastChunkSize > 0 && lastChunkSize < TAG_SIZE)) {
+    BOOST_THROW_EXCEPTION(Error("Encrypted chunk is shorter than the authentication tag"));
+  }
+  size_t nChunks = static_cast<size_t>(size / encryptedChunkSize) + (lastChunkSize > 0 ? 1 : 0);
+
+  // chunks are decrypted straight into their place in the payload
+  Buffer payload(size - nChunks * TAG_SIZE);
+  ChunkDecryptor decryptor(contentKey, header.getInitialVector());
+  size_t payloadOffset = 0;
+  forEachChunk(header, size, [&] (size_t offset, size_t n, bool isLast) {
+    decryptor.decrypt(cipher + offset, n, isLast, payload.data() + payloadOffset);
+    payloadOffset += n - TAG_SIZE;
+  });
+  return payload;
+}
+
+void
+openPayload(const Header& header, const Buffer& contentKey, const uint8_t* cipher, size_t size,
+            const PayloadSink& sink)
+{
+  if (header.getChunkSize() == 0) {
+    Buffer payload = decryptPayload(contentKey, header.getInitialVector(), cipher, size);
+    sink(payload.data(), payload.size());
+    return;
+  }
+
+  ChunkDecryptor decryptor(contentKey, header.getInitialVector());
+  Buffer chunk(static_cast<size_t>(std::min<uint64_t>(header.getChunkSize(), size)));
+  forEachChunk(header, size, [&] (size_t offset, size_t n, bool isLast) {
+    decryptor.decrypt(cipher + offset, n, isLast, chunk.data());
+    sink(chunk.data(), n - TAG_SIZE);
+  });
+}
+
+Buffer
+open(const uint8_t* envelope, size_t size, const CryptoBackend& backend,
+     const shared_ptr<const CryptoPP::PrivateKey>& key)
+{
+  size_t headerSize = 0;
+  Header header = decodeHeader(envelope, size, headerSize);
+  if (header.getAlgorithm() != static_cast<uint64_t>(backend.getType())) {
+    BOOST_THROW_EXCEPTION(Error("Envelope algorithm " + std::to_string(header.getAlgorithm()) +
+                                " does not match " + backend.getName()));
+  }
+
+  Buffer contentKey = unwrapKey(header.getWrappedKey(), backend, key);
+  return openPayload(header, contentKey, envelope + headerSize, size - headerSize);
+}
+
+} // namespace envelope
+} // namespace epac
+} // namespace ndn
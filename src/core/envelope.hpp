@@ -0,0 +1,271 @@
+#ifndef NDN_EPAC_CORE_ENVELOPE_HPP
+#define NDN_EPAC_CORE_ENVELOPE_HPP
+
+#include "common.hpp"
+#include "crypto-backend.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <functional>
+#include <limits>
+
+namespace ndn {
+namespace epac {
+
+/** \brief hybrid (envelope) encryption of Data payloads
+ *
+ *  The payload is encrypted once with AES-GCM under a random content key; only the content key
+ *  is encrypted (wrapped) with the public key of the recipient, using the algorithm of
+ *  a CryptoBackend.
+ *
+ *  RNGs, public-key encryptors/decryptors and AES-GCM ciphers come from the CryptoContext of
+ *  the calling thread.
+ */
+namespace envelope {
+
+class Error : public std::runtime_error
+{
+public:
+  explicit
+  Error(const std::string& what)
+    : std::runtime_error(what)
+  {
+  }
+};
+
+/** \brief size of the content key in octets (AES-128)
+ */
+const size_t CONTENT_KEY_SIZE = 16;
+
+/** \brief size of the GCM initial vector in octets
+ */
+const size_t IV_SIZE = 12;
+
+/** \brief size of the GCM authentication tag in octets
+ */
+const size_t TAG_SIZE = 16;
+
+/** \brief default number of payload octets per chunk of sealStream
+ */
+const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+/** \brief receives decrypted payload, one authenticated chunk at a time
+ */
+typedef std::function<void(const uint8_t* data, size_t size)> PayloadSink;
+
+/** \brief envelope header carrying the wrapped content key and the initial vector
+ */
+class Header
+{
+public:
+  Header();
+
+  explicit
+  Header(const Block& wire);
+
+  /** \return CryptoBackend::Type of the wrapped key
+   */
+  uint64_t
+  getAlgorithm() const
+  {
+    return m_algorithm;
+  }
+
+  void
+  setAlgorithm(uint64_t algorithm)
+  {
+    m_algorithm = algorithm;
+  }
+
+  const Buffer&
+  getWrappedKey() const
+  {
+    return m_wrappedKey;
+  }
+
+  void
+  setWrappedKey(Buffer wrappedKey)
+  {
+    m_wrappedKey = std::move(wrappedKey);
+  }
+
+  const Buffer&
+  getInitialVector() const
+  {
+    return m_iv;
+  }
+
+  void
+  setInitialVector(Buffer iv)
+  {
+    m_iv = std::move(iv);
+  }
+
+  /** \return payload octets per chunk, or 0 if the payload is encrypted as a whole
+   */
+  uint64_t
+  getChunkSize() const
+  {
+    return m_chunkSize;
+  }
+
+  void
+  setChunkSize(uint64_t chunkSize)
+  {
+    m_chunkSize = chunkSize;
+  }
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  uint64_t m_algorithm;
+  Buffer m_wrappedKey;
+  Buffer m_iv;
+  uint64_t m_chunkSize;
+};
+
+/** \brief generate a random content key
+ */
+Buffer
+generateContentKey();
+
+/** \brief generate a random initial vector
+ */
+Buffer
+generateInitialVector();
+
+/** \brief encrypt \p contentKey under \p key of \p backend
+ */
+Buffer
+wrapKey(const Buffer& contentKey, const CryptoBackend& backend,
+        const shared_ptr<const CryptoPP::PublicKey>& key);
+
+/** \brief decrypt a content key wrapped by wrapKey
+ *  \throw Error the wrapped key cannot be decrypted with \p key
+ */
+Buffer
+unwrapKey(const Buffer& wrappedKey, const CryptoBackend& backend,
+          const shared_ptr<const CryptoPP::PrivateKey>& key);
+
+/** \brief encrypt \p key under the symmetric key \p wrappingKey with AES-GCM
+ *  \return a random initial vector followed by the ciphertext and the authentication tag
+ */
+Buffer
+wrapKey(const Buffer& key, const Buffer& wrappingKey);
+
+/** \brief decrypt a key wrapped under \p wrappingKey by wrapKey
+ *  \throw Error the wrapped key is malformed or fails authentication
+ */
+Buffer
+unwrapKey(const Buffer& wrappedKey, const Buffer& wrappingKey);
+
+/** \brief encrypt \p size octets at \p payload with AES-GCM
+ *  \return ciphertext followed by the authentication tag
+ */
+Buffer
+encryptPayload(const Buffer& contentKey, const Buffer& iv, const uint8_t* payload, size_t size);
+
+/** \brief decrypt and authenticate the output of encryptPayload
+ *  \throw Error authentication failed
+ */
+Buffer
+decryptPayload(const Buffer& contentKey, const Buffer& iv, const uint8_t* cipher, size_t size);
+
+/** \brief seal \p payload into an envelope readable by the owner of \p key
+ *  \return encoded EnvelopeHeader followed by the encrypted payload
+ */
+Buffer
+seal(const uint8_t* payload, size_t size, const CryptoBackend& backend,
+     const shared_ptr<const CryptoPP::PublicKey>& key);
+
+/** \brief seal \p payload under a given \p contentKey, wrapping it for the owner of \p key
+ *
+ *  Used when the same content key is also wrapped for other recipients.
+ */
+Buffer
+seal(const uint8_t* payload, size_t size, const Buffer& contentKey,
+     const CryptoBackend& backend, const shared_ptr<const CryptoPP::PublicKey>& key);
+
+/** \brief seals payloads read from streams under one content key
+ *
+ *  The content key is wrapped once, when the Sealer is constructed; every sealed payload
+ *  carries the same WrappedKey under its own initial vector.
+ */
+class Sealer : noncopyable
+{
+public:
+  Sealer(const Buffer& contentKey, const CryptoBackend& backend,
+         const shared_ptr<const CryptoPP::PublicKey>& key);
+
+  /** \brief seal at most \p maxSize octets read from \p input into the Content block of a Data
+   *
+   *  \p input is read in chunks of \p chunkSize octets straight into the returned block, and
+   *  each chunk is encrypted in place by a ChunkEncryptor, so no copy of the payload is made.
+   *  The block is allocated once, for \p maxSize octets or the octets left in \p input if it
+   *  can seek, whichever is fewer; only when neither is known (stdin from a pipe) does it grow
+   *  as chunks are read.
+   *
+   *  \return Content TLV block holding the encoded EnvelopeHeader and the encrypted chunks
+   *  \note sealStream may be called from several threads at once
+   */
+  Block
+  sealStream(std::istream& input, size_t maxSize = std::numeric_limits<size_t>::max(),
+             size_t chunkSize = DEFAULT_CHUNK_SIZE) const;
+
+private:
+  Buffer m_contentKey;
+  Header m_header;
+};
+
+/** \brief seal everything read from \p input into the Content block of a Data packet
+ *  \sa Sealer::sealStream
+ */
+Block
+sealStream(std::istream& input, const Buffer& contentKey, const CryptoBackend& backend,
+           const shared_ptr<const CryptoPP::PublicKey>& key,
+           size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+/** \brief decode the Header at the front of an envelope produced by seal
+ *  \param[out] headerSize size of the encoded header; the encrypted payload follows it
+ *  \throw Error malformed header
+ */
+Header
+decodeHeader(const uint8_t* envelope, size_t size, size_t& headerSize);
+
+/** \brief decrypt the payload that follows \p header, whether chunked or not
+ *  \throw Error malformed payload or authentication failure
+ */
+Buffer
+openPayload(const Header& header, const Buffer& contentKey, const uint8_t* cipher, size_t size);
+
+/** \brief decrypt the payload that follows \p header into \p sink
+ *
+ *  Each chunk is passed to \p sink only after it is authenticated, so at most one chunk of
+ *  plaintext is held in memory. A failure after some chunks have been passed to \p sink means
+ *  the payload was truncated or tampered with after those chunks.
+ *
+ *  \throw Error malformed payload or authentication failure
+ */
+void
+openPayload(const Header& header, const Buffer& contentKey, const uint8_t* cipher, size_t size,
+            const PayloadSink& sink);
+
+/** \brief open an envelope produced by seal or sealStream
+ *  \throw Error malformed envelope, algorithm other than \p backend, wrong key,
+ *               or authentication failure
+ */
+Buffer
+open(const uint8_t* envelope, size_t size, const CryptoBackend& backend,
+     const shared_ptr<const CryptoPP::PrivateKey>& key);
+
+} // namespace envelope
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_ENVELOPE_HPP
@@ -0,0 +1,66 @@
+#include "group-key-ring.hpp"
+#include "envelope.hpp"
+
+namespace ndn {
+namespace epac {
+
+GroupKeyRing::GroupKeyRing(const std::string& userId, const CryptoBackend& backend,
+                           shared_ptr<const CryptoPP::PrivateKey> privateKey)
+  : m_userId(userId)
+  , m_backend(backend)
+  , m_privateKey(std::move(privateKey))
+{
+}
+
+size_t
+GroupKeyRing::apply(const RekeyMessage& message)
+{
+  size_t nLearnt = 0;
+  for (const auto& entry : message.getEntries()) {
+    Buffer key;
+    if (!entry.userId.empty()) {
+      if (entry.userId != m_userId) {
+        continue;
+      }
+      key = envelope::unwrapKey(entry.wrappedKey, m_backend, m_privateKey);
+    }
+    else {
+      const Buffer* wrappingKey = findKey(entry.wrappingNode, entry.wrappingVersion);
+      if (wrappingKey == nullptr) {
+        continue;
+      }
+      key = envelope::unwrapKey(entry.wrappedKey, *wrappingKey);
+    }
+
+    auto& known = m_keys[entry.node];
+    if (known.second.empty() || known.first < message.getEpoch()) {
+      known = std::make_pair(message.getEpoch(), std::move(key));
+      ++nLearnt;
+    }
+  }
+  return nLearnt;
+}
+
+const Buffer*
+GroupKeyRing::findKey(uint64_t node, uint64_t version) const
+{
+  auto it = m_keys.find(node);
+  if (it == m_keys.end() || it->second.first != version) {
+    return nullptr;
+  }
+  return &it->second.second;
+}
+
+Buffer
+GroupKeyRing::unwrapContentKey(const KeyWrapBundle::GroupEntry& entry) const
+{
+  const Buffer* groupKey = findKey(entry.keyNode, entry.keyVersion);
+  if (groupKey == nullptr) {
+    BOOST_THROW_EXCEPTION(envelope::Error("Group key of " + entry.groupId + " at version " +
+                                          std::to_string(entry.keyVersion) + " is not known"));
+  }
+  return envelope::unwrapKey(entry.wrappedKey, *groupKey);
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,63 @@
+#ifndef NDN_EPAC_CORE_GROUP_KEY_RING_HPP
+#define NDN_EPAC_CORE_GROUP_KEY_RING_HPP
+
+#include "common.hpp"
+#include "crypto-backend.hpp"
+#include "key-wrap-bundle.hpp"
+#include "rekey-message.hpp"
+
+namespace ndn {
+namespace epac {
+
+/** \brief keys of the key tree of an access group known to one member
+ *
+ *  A member learns its own leaf key with its private key when it joins, and every other key
+ *  it is entitled to from the rekey messages of the group, applied in order of epoch. Only
+ *  the latest known version of each node is kept. Content keys of the group are unwrapped
+ *  under the group key, the key of the root.
+ */
+class GroupKeyRing : noncopyable
+{
+public:
+  GroupKeyRing(const std::string& userId, const CryptoBackend& backend,
+               shared_ptr<const CryptoPP::PrivateKey> privateKey);
+
+  /** \brief learn the keys of \p message wrapped for the user or under known keys
+   *  \return number of keys learnt
+   *  \throw envelope::Error a key wrapped for the member cannot be unwrapped
+   */
+  size_t
+  apply(const RekeyMessage& message);
+
+  /** \return the key of \p node at \p version, or nullptr if it is not known
+   */
+  const Buffer*
+  findKey(uint64_t node, uint64_t version) const;
+
+  /** \brief unwrap the content key of \p entry under the group key it names
+   *  \throw envelope::Error the group key is not known, or the key cannot be unwrapped
+   */
+  Buffer
+  unwrapContentKey(const KeyWrapBundle::GroupEntry& entry) const;
+
+  /** \return number of known keys
+   */
+  size_t
+  size() const
+  {
+    return m_keys.size();
+  }
+
+private:
+  std::string m_userId;
+  const CryptoBackend& m_backend;
+  shared_ptr<const CryptoPP::PrivateKey> m_privateKey;
+  /** \brief version and key of each known node
+   */
+  std::unordered_map<uint64_t, std::pair<uint64_t, Buffer>> m_keys;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_GROUP_KEY_RING_HPP
@@ -0,0 +1,173 @@
+#include "key-store.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace epac {
+
+namespace fs = boost::filesystem;
+
+/** \return DER encoding of \p key
+ */
+static std::string
+encodeKey(const CryptoPP::CryptoMaterial& key)
+{
+  std::string der;
+  CryptoPP::StringSink sink(der);
+  key.Save(sink);
+  return der;
+}
+
+KeyStore::KeyStore(const std::string& directory, const CryptoBackend& backend)
+  : m_directory(directory.empty() ? "." : directory)
+  , m_backend(backend)
+  , m_isGenerated(false)
+{
+}
+
+std::string
+KeyStore::getPublicKeyFile() const
+{
+  return (fs::path(m_directory) / "publicKey.key").string();
+}
+
+std::string
+KeyStore::getPrivateKeyFile() const
+{
+  return (fs::path(m_directory) / "privateKey.key").string();
+}
+
+void
+KeyStore::loadOrGenerate()
+{
+  bool hasPublicKey = fs::exists(getPublicKeyFile());
+  bool hasPrivateKey = fs::exists(getPrivateKeyFile());
+
+  if (hasPublicKey && hasPrivateKey) {
+    load();
+  }
+  else if (!hasPublicKey && !hasPrivateKey) {
+    generate();
+  }
+  else {
+    BOOST_THROW_EXCEPTION(Error("Only one of " + getPublicKeyFile() + " and " +
+                                getPrivateKeyFile() + " exists, refusing to overwrite it"));
+  }
+}
+
+void
+KeyStore::load()
+{
+  auto publicKey = m_backend.createPublicKey();
+  auto privateKey = m_backend.createPrivateKey();
+  loadKey(getPublicKeyFile(), *publicKey);
+  loadKey(getPrivateKeyFile(), *privateKey);
+
+  // Keys are validated only here. Afterwards they are shared immutably, so values decoded
+  // with the private key (e.g. RSA CRT components) are reused by every decryption.
+  CryptoPP::AutoSeededRandomPool rng;
+  if (!publicKey->Validate(rng, 2) || !privateKey->Validate(rng, 2)) {
+    BOOST_THROW_EXCEPTION(Error("Keys in " + m_directory + " failed validation"));
+  }
+  if (encodeKey(*m_backend.makePublicKey(*privateKey)) != encodeKey(*publicKey)) {
+    BOOST_THROW_EXCEPTION(Error("Public and private keys in " + m_directory + " do not match"));
+  }
+
+  m_publicKey = publicKey;
+  m_privateKey = privateKey;
+  m_isGenerated = false;
+}
+
+void
+KeyStore::generate()
+{
+  CryptoPP::AutoSeededRandomPool rng;
+  auto privateKey = m_backend.generatePrivateKey(rng);
+  auto publicKey = m_backend.makePublicKey(*privateKey);
+
+  boost::system::error_code ec;
+  fs::create_directories(m_directory, ec);
+  if (ec) {
+    BOOST_THROW_EXCEPTION(Error("Cannot create key directory " + m_directory + ": " +
+                                ec.message()));
+  }
+
+  saveKey(getPrivateKeyFile(), *privateKey, true);
+  saveKey(getPublicKeyFile(), *publicKey);
+
+  m_publicKey = publicKey;
+  m_privateKey = privateKey;
+  m_isGenerated = true;
+}
+
+void
+KeyStore::saveKey(const std::string& filename, const CryptoPP::CryptoMaterial& key,
+                  bool isPrivate)
+{
+  std::string der;
+  try {
+    der = encodeKey(key);
+  }
+  catch (const CryptoPP::Exception& e) {
+    BOOST_THROW_EXCEPTION(Error("Cannot write " + filename + ": " + e.what()));
+  }
+
+  // a private key is created readable by its owner only, before any of it is written
+  std::string tmpFilename = filename + ".tmp";
+  mode_t mode = isPrivate ? S_IRUSR | S_IWUSR : 0666;
+  int fd = ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
+  if (fd < 0) {
+    BOOST_THROW_EXCEPTION(Error("Cannot write " + filename + ": " + std::strerror(errno)));
+  }
+
+  // a file left over by an earlier attempt keeps the mode it was created with
+  std::string error;
+  if (isPrivate && ::fchmod(fd, mode) != 0) {
+    error = "Cannot restrict access to " + filename + ": " + std::strerror(errno);
+  }
+  for (size_t offset = 0; error.empty() && offset < der.size(); ) {
+    ssize_t n = ::write(fd, der.data() + offset, der.size() - offset);
+    if (n < 0 && errno != EINTR) {
+      error = "Cannot write " + filename + ": " + std::strerror(errno);
+    }
+    offset += n > 0 ? n : 0;
+  }
+  if (::close(fd) != 0 && error.empty()) {
+    error = "Cannot write " + filename + ": " + std::strerror(errno);
+  }
+  if (!error.empty()) {
+    ::unlink(tmpFilename.c_str());
+    BOOST_THROW_EXCEPTION(Error(error));
+  }
+
+  boost::system::error_code ec;
+  fs::rename(tmpFilename, filename, ec);
+  if (ec) {
+    BOOST_THROW_EXCEPTION(Error("Cannot write " + filename + ": " + ec.message()));
+  }
+}
+
+void
+KeyStore::loadKey(const std::string& filename, CryptoPP::CryptoMaterial& key)
+{
+  try {
+    CryptoPP::ByteQueue queue;
+    CryptoPP::FileSource file(filename.c_str(), true /*pumpAll*/);
+    file.TransferTo(queue);
+    queue.MessageEnd();
+    key.Load(queue);
+  }
+  catch (const CryptoPP::Exception& e) {
+    BOOST_THROW_EXCEPTION(Error("Cannot load key from " + filename + ": " + e.what()));
+  }
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,109 @@
+#ifndef NDN_EPAC_CORE_KEY_STORE_HPP
+#define NDN_EPAC_CORE_KEY_STORE_HPP
+
+#include "common.hpp"
+#include "crypto-backend.hpp"
+
+namespace ndn {
+namespace epac {
+
+/** \brief persistent key pair kept in a directory
+ *
+ *  The key pair of the selected CryptoBackend is stored as publicKey.key and privateKey.key
+ *  (DER encoded).
+ *  Existing keys are loaded and validated once; a new key pair is generated only when
+ *  the directory contains neither file.
+ */
+class KeyStore : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  explicit
+  KeyStore(const std::string& directory,
+           const CryptoBackend& backend = CryptoBackend::getDefault());
+
+  /** \brief load the key pair from the directory, or generate and save a new one
+   *  \throw Error only one of the key files exists, the keys are invalid or do not match,
+   *               or a generated key pair cannot be saved
+   */
+  void
+  loadOrGenerate();
+
+  /** \return whether the key pair was generated by loadOrGenerate rather than loaded
+   */
+  bool
+  isGenerated() const
+  {
+    return m_isGenerated;
+  }
+
+  const CryptoBackend&
+  getBackend() const
+  {
+    return m_backend;
+  }
+
+  shared_ptr<const CryptoPP::PublicKey>
+  getPublicKey() const
+  {
+    return m_publicKey;
+  }
+
+  shared_ptr<const CryptoPP::PrivateKey>
+  getPrivateKey() const
+  {
+    return m_privateKey;
+  }
+
+  std::string
+  getPublicKeyFile() const;
+
+  std::string
+  getPrivateKeyFile() const;
+
+  /** \brief write DER encoding of \p key into \p filename
+   *
+   *  The key is written into a temporary file that is then renamed over \p filename,
+   *  so a concurrently starting process never observes a partially written key.
+   *  If \p isPrivate, the temporary file has mode 0600 before the key is written into it.
+   *
+   *  \throw Error the file cannot be written, or its mode cannot be set
+   */
+  static void
+  saveKey(const std::string& filename, const CryptoPP::CryptoMaterial& key,
+          bool isPrivate = false);
+
+  /** \brief read DER encoding of \p key from \p filename
+   *  \throw Error the file cannot be read or decoded
+   */
+  static void
+  loadKey(const std::string& filename, CryptoPP::CryptoMaterial& key);
+
+private:
+  void
+  load();
+
+  void
+  generate();
+
+private:
+  std::string m_directory;
+  const CryptoBackend& m_backend;
+  bool m_isGenerated;
+  shared_ptr<const CryptoPP::PublicKey> m_publicKey;
+  shared_ptr<const CryptoPP::PrivateKey> m_privateKey;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_KEY_STORE_HPP
@@ -0,0 +1,140 @@
+#include "key-wrap-bundle.hpp"
+#include "crypto-backend.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace epac {
+
+static bool
+compareUserId(const KeyWrapBundle::Entry& entry, const std::string& userId)
+{
+  return entry.userId < userId;
+}
+
+KeyWrapBundle::KeyWrapBundle(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+KeyWrapBundle::KeyWrapBundle(std::vector<Entry> entries, std::vector<GroupEntry> groupEntries)
+  : m_entries(std::move(entries))
+  , m_groupEntries(std::move(groupEntries))
+{
+  std::sort(m_entries.begin(), m_entries.end(),
+            [] (const Entry& a, const Entry& b) { return a.userId < b.userId; });
+}
+
+const KeyWrapBundle::Entry*
+KeyWrapBundle::find(const std::string& userId) const
+{
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), userId, &compareUserId);
+  if (it == m_entries.end() || it->userId != userId) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+const KeyWrapBundle::GroupEntry*
+KeyWrapBundle::findGroup(const std::string& groupId) const
+{
+  auto it = std::find_if(m_groupEntries.begin(), m_groupEntries.end(),
+                         [&groupId] (const GroupEntry& entry) {
+                           return entry.groupId == groupId;
+                         });
+  return it != m_groupEntries.end() ? &*it : nullptr;
+}
+
+Block
+KeyWrapBundle::wireEncode() const
+{
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  for (auto it = m_groupEntries.rbegin(); it != m_groupEntries.rend(); ++it) {
+    size_t entryLength = 0;
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::WrappedKey,
+                                                   it->wrappedKey.data(), it->wrappedKey.size());
+    entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::KeyVersion,
+                                                            it->keyVersion);
+    entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::KeyNode, it->keyNode);
+    const uint8_t* groupId = reinterpret_cast<const uint8_t*>(it->groupId.data());
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::GroupId,
+                                                   groupId, it->groupId.size());
+    entryLength += encoder.prependVarNumber(entryLength);
+    entryLength += encoder.prependVarNumber(tlv::GroupKeyWrap);
+    totalLength += entryLength;
+  }
+
+  for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+    size_t entryLength = 0;
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::WrappedKey,
+                                                   it->wrappedKey.data(), it->wrappedKey.size());
+    entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::Algorithm,
+                                                            it->algorithm);
+    const uint8_t* userId = reinterpret_cast<const uint8_t*>(it->userId.data());
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::UserId,
+                                                   userId, it->userId.size());
+    entryLength += encoder.prependVarNumber(entryLength);
+    entryLength += encoder.prependVarNumber(tlv::KeyWrapEntry);
+    totalLength += entryLength;
+  }
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::KeyWrapBundle);
+
+  return encoder.block();
+}
+
+void
+KeyWrapBundle::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::KeyWrapBundle) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(wire.type()) +
+                                " while decoding KeyWrapBundle"));
+  }
+
+  std::vector<Entry> entries;
+  std::vector<GroupEntry> groupEntries;
+  try {
+    wire.parse();
+    entries.reserve(wire.elements_size());
+    for (const Block& element : wire.elements()) {
+      if (element.type() == tlv::GroupKeyWrap) {
+        element.parse();
+        const Block& groupId = element.get(tlv::GroupId);
+        const Block& wrappedKey = element.get(tlv::WrappedKey);
+        groupEntries.push_back({std::string(reinterpret_cast<const char*>(groupId.value()),
+                                            groupId.value_size()),
+                                encoding::readNonNegativeInteger(element.get(tlv::KeyNode)),
+                                encoding::readNonNegativeInteger(element.get(tlv::KeyVersion)),
+                                Buffer(wrappedKey.value(), wrappedKey.value_size())});
+        continue;
+      }
+      if (element.type() != tlv::KeyWrapEntry) {
+        continue;
+      }
+      element.parse();
+      const Block& userId = element.get(tlv::UserId);
+      const Block& wrappedKey = element.get(tlv::WrappedKey);
+      auto algorithm = element.find(tlv::Algorithm);
+      entries.push_back({std::string(reinterpret_cast<const char*>(userId.value()),
+                                     userId.value_size()),
+                         algorithm != element.elements_end() ?
+                           encoding::readNonNegativeInteger(*algorithm) :
+                           static_cast<uint64_t>(CryptoBackend::RSA_OAEP),
+                         Buffer(wrappedKey.value(), wrappedKey.value_size())});
+    }
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed KeyWrapBundle: ") + e.what()));
+  }
+
+  *this = KeyWrapBundle(std::move(entries), std::move(groupEntries));
+}
+
+} // namespace epac
+} // namespace ndn
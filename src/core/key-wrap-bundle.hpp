@@ -0,0 +1,103 @@
+#ifndef NDN_EPAC_CORE_KEY_WRAP_BUNDLE_HPP
+#define NDN_EPAC_CORE_KEY_WRAP_BUNDLE_HPP
+
+#include "common.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+
+namespace ndn {
+namespace epac {
+
+/** \brief one content key wrapped for many users
+ *
+ *  Entries are kept sorted by user id, so a consumer finds its own entry by binary search.
+ *  The content key may also be wrapped under the group key of access groups, once per group,
+ *  for members that hold the group key (see GroupKeyRing).
+ */
+class KeyWrapBundle
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct Entry
+  {
+    std::string userId;
+    /** \brief CryptoBackend::Type of the backend that unwraps wrappedKey
+     */
+    uint64_t algorithm;
+    Buffer wrappedKey;
+  };
+
+  struct GroupEntry
+  {
+    std::string groupId;
+    /** \brief node of the group key in the key tree of the group
+     */
+    uint64_t keyNode;
+    uint64_t keyVersion;
+    Buffer wrappedKey;
+  };
+
+  KeyWrapBundle() = default;
+
+  explicit
+  KeyWrapBundle(const Block& wire);
+
+  /** \brief take \p entries as the content of the bundle; entries are sorted by user id
+   */
+  explicit
+  KeyWrapBundle(std::vector<Entry> entries, std::vector<GroupEntry> groupEntries = {});
+
+  const std::vector<Entry>&
+  getEntries() const
+  {
+    return m_entries;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /** \return the entry of \p userId, or nullptr if the bundle has none
+   */
+  const Entry*
+  find(const std::string& userId) const;
+
+  const std::vector<GroupEntry>&
+  getGroupEntries() const
+  {
+    return m_groupEntries;
+  }
+
+  /** \return the entry of group \p groupId, or nullptr if the bundle has none
+   */
+  const GroupEntry*
+  findGroup(const std::string& groupId) const;
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  std::vector<Entry> m_entries;
+  std::vector<GroupEntry> m_groupEntries;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_KEY_WRAP_BUNDLE_HPP
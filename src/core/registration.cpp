@@ -0,0 +1,99 @@
+#include "registration.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+namespace ndn {
+namespace epac {
+
+const name::Component Registration::COMMAND_COMPONENT("REGISTER");
+
+Registration::Registration(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+void
+Registration::add(const std::string& userId, const CryptoPP::PublicKey& publicKey,
+                  const CryptoBackend& backend)
+{
+  std::string der;
+  CryptoPP::StringSink sink(der);
+  publicKey.Save(sink);
+
+  m_entries.push_back({userId, static_cast<uint64_t>(backend.getType()),
+                       Buffer(der.data(), der.size())});
+}
+
+Name
+Registration::getCommandName(const Name& prefix) const
+{
+  return Name(prefix).append(COMMAND_COMPONENT).append(wireEncode());
+}
+
+Block
+Registration::wireEncode() const
+{
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+    size_t entryLength = 0;
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::PublicKey,
+                                                   it->publicKey.data(), it->publicKey.size());
+    entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::Algorithm,
+                                                            it->algorithm);
+    const uint8_t* userId = reinterpret_cast<const uint8_t*>(it->userId.data());
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::UserId,
+                                                   userId, it->userId.size());
+    entryLength += encoder.prependVarNumber(entryLength);
+    entryLength += encoder.prependVarNumber(tlv::UserRegistration);
+    totalLength += entryLength;
+  }
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::Registration);
+
+  return encoder.block();
+}
+
+void
+Registration::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::Registration) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(wire.type()) +
+                                " while decoding Registration"));
+  }
+
+  std::vector<Entry> entries;
+  try {
+    wire.parse();
+    entries.reserve(wire.elements_size());
+    for (const Block& element : wire.elements()) {
+      if (element.type() != tlv::UserRegistration) {
+        continue;
+      }
+      element.parse();
+      const Block& userId = element.get(tlv::UserId);
+      const Block& publicKey = element.get(tlv::PublicKey);
+      auto algorithm = element.find(tlv::Algorithm);
+      entries.push_back({std::string(reinterpret_cast<const char*>(userId.value()),
+                                     userId.value_size()),
+                         algorithm != element.elements_end() ?
+                           encoding::readNonNegativeInteger(*algorithm) :
+                           static_cast<uint64_t>(CryptoBackend::RSA_OAEP),
+                         Buffer(publicKey.value(), publicKey.value_size())});
+    }
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed Registration: ") + e.what()));
+  }
+
+  if (entries.empty()) {
+    BOOST_THROW_EXCEPTION(Error("Registration without users"));
+  }
+  m_entries = std::move(entries);
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,90 @@
+#ifndef NDN_EPAC_CORE_REGISTRATION_HPP
+#define NDN_EPAC_CORE_REGISTRATION_HPP
+
+#include "common.hpp"
+#include "crypto-backend.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+
+namespace ndn {
+namespace epac {
+
+/** \brief users to be registered with a provider by one command
+ *
+ *  A Registration is carried in the name of a signed command Interest
+ *  <prefix>/REGISTER/<Registration>; one command may register many users.
+ */
+class Registration
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct Entry
+  {
+    std::string userId;
+    /** \brief CryptoBackend::Type of the key
+     */
+    uint64_t algorithm;
+    /** \brief DER encoding of the public key
+     */
+    Buffer publicKey;
+  };
+
+  Registration() = default;
+
+  explicit
+  Registration(const Block& wire);
+
+  /** \brief add the user \p userId with \p publicKey of \p backend
+   */
+  void
+  add(const std::string& userId, const CryptoPP::PublicKey& publicKey,
+      const CryptoBackend& backend = CryptoBackend::getDefault());
+
+  const std::vector<Entry>&
+  getEntries() const
+  {
+    return m_entries;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /** \return name of the command Interest registering these users with the provider
+   *          serving \p prefix, to be signed as a command Interest
+   */
+  Name
+  getCommandName(const Name& prefix) const;
+
+  Block
+  wireEncode() const;
+
+  /** \throw Error \p wire is not a Registration with at least one user
+   */
+  void
+  wireDecode(const Block& wire);
+
+public:
+  static const name::Component COMMAND_COMPONENT;
+
+private:
+  std::vector<Entry> m_entries;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_REGISTRATION_HPP
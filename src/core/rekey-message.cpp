@@ -0,0 +1,111 @@
+#include "rekey-message.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+namespace ndn {
+namespace epac {
+
+const name::Component RekeyMessage::NAME_COMPONENT("REKEY");
+
+RekeyMessage::RekeyMessage(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+void
+RekeyMessage::addForUser(uint64_t node, const std::string& userId, Buffer wrappedKey)
+{
+  m_entries.push_back({node, userId, 0, 0, std::move(wrappedKey)});
+}
+
+void
+RekeyMessage::addForNode(uint64_t node, uint64_t wrappingNode, uint64_t wrappingVersion,
+                         Buffer wrappedKey)
+{
+  m_entries.push_back({node, "", wrappingNode, wrappingVersion, std::move(wrappedKey)});
+}
+
+Name
+RekeyMessage::getName(const Name& prefix, const std::string& groupId, uint64_t epoch)
+{
+  return Name(prefix).append(NAME_COMPONENT).append(groupId).appendVersion(epoch);
+}
+
+Block
+RekeyMessage::wireEncode() const
+{
+  EncodingBuffer encoder;
+  size_t totalLength = 0;
+
+  for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+    size_t entryLength = 0;
+    entryLength += encoding::prependByteArrayBlock(encoder, tlv::WrappedKey,
+                                                   it->wrappedKey.data(), it->wrappedKey.size());
+    if (it->userId.empty()) {
+      entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::WrappingVersion,
+                                                              it->wrappingVersion);
+      entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::WrappingNode,
+                                                              it->wrappingNode);
+    }
+    else {
+      const uint8_t* userId = reinterpret_cast<const uint8_t*>(it->userId.data());
+      entryLength += encoding::prependByteArrayBlock(encoder, tlv::UserId,
+                                                     userId, it->userId.size());
+    }
+    entryLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::KeyNode, it->node);
+    entryLength += encoder.prependVarNumber(entryLength);
+    entryLength += encoder.prependVarNumber(tlv::RekeyEntry);
+    totalLength += entryLength;
+  }
+
+  totalLength += encoding::prependNonNegativeIntegerBlock(encoder, tlv::KeyVersion, m_epoch);
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::RekeyMessage);
+
+  return encoder.block();
+}
+
+void
+RekeyMessage::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::RekeyMessage) {
+    BOOST_THROW_EXCEPTION(Error("Unexpected TLV-TYPE " + std::to_string(wire.type()) +
+                                " while decoding RekeyMessage"));
+  }
+
+  uint64_t epoch = 0;
+  std::vector<Entry> entries;
+  try {
+    wire.parse();
+    epoch = encoding::readNonNegativeInteger(wire.get(tlv::KeyVersion));
+    entries.reserve(wire.elements_size());
+    for (const Block& element : wire.elements()) {
+      if (element.type() != tlv::RekeyEntry) {
+        continue;
+      }
+      element.parse();
+      Entry entry{encoding::readNonNegativeInteger(element.get(tlv::KeyNode)), "", 0, 0, Buffer()};
+      auto userId = element.find(tlv::UserId);
+      if (userId != element.elements_end()) {
+        entry.userId.assign(reinterpret_cast<const char*>(userId->value()), userId->value_size());
+      }
+      else {
+        entry.wrappingNode = encoding::readNonNegativeInteger(element.get(tlv::WrappingNode));
+        entry.wrappingVersion = encoding::readNonNegativeInteger(element.get(tlv::WrappingVersion));
+      }
+      const Block& wrappedKey = element.get(tlv::WrappedKey);
+      entry.wrappedKey = Buffer(wrappedKey.value(), wrappedKey.value_size());
+      entries.push_back(std::move(entry));
+    }
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Malformed RekeyMessage: ") + e.what()));
+  }
+
+  m_epoch = epoch;
+  m_entries = std::move(entries);
+}
+
+} // namespace epac
+} // namespace ndn
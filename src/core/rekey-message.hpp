@@ -0,0 +1,105 @@
+#ifndef NDN_EPAC_CORE_REKEY_MESSAGE_HPP
+#define NDN_EPAC_CORE_REKEY_MESSAGE_HPP
+
+#include "common.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+
+namespace ndn {
+namespace epac {
+
+/** \brief new keys of the key tree of an access group after a change of its members
+ *
+ *  All keys of a message take the epoch of the change as their version. Each key is wrapped
+ *  either for one user, or under the key of another node of the tree; entries are ordered
+ *  so that a member learns every key it may learn in one pass (see GroupKeyRing).
+ */
+class RekeyMessage
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct Entry
+  {
+    uint64_t node;
+    /** \brief user the key is wrapped for; empty if it is wrapped under wrappingNode
+     */
+    std::string userId;
+    uint64_t wrappingNode;
+    uint64_t wrappingVersion;
+    Buffer wrappedKey;
+  };
+
+  explicit
+  RekeyMessage(uint64_t epoch = 0)
+    : m_epoch(epoch)
+  {
+  }
+
+  explicit
+  RekeyMessage(const Block& wire);
+
+  /** \return version of every key in the message
+   */
+  uint64_t
+  getEpoch() const
+  {
+    return m_epoch;
+  }
+
+  /** \brief append the key of \p node wrapped for user \p userId
+   */
+  void
+  addForUser(uint64_t node, const std::string& userId, Buffer wrappedKey);
+
+  /** \brief append the key of \p node wrapped under the key of \p wrappingNode
+   *         at \p wrappingVersion
+   */
+  void
+  addForNode(uint64_t node, uint64_t wrappingNode, uint64_t wrappingVersion, Buffer wrappedKey);
+
+  const std::vector<Entry>&
+  getEntries() const
+  {
+    return m_entries;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /** \return <prefix>/REKEY/<groupId>/<version=epoch>, the name of the message of \p epoch
+   */
+  static Name
+  getName(const Name& prefix, const std::string& groupId, uint64_t epoch);
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+public:
+  static const name::Component NAME_COMPONENT;
+
+private:
+  uint64_t m_epoch;
+  std::vector<Entry> m_entries;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_REKEY_MESSAGE_HPP
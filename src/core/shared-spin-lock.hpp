@@ -0,0 +1,93 @@
+#ifndef NDN_EPAC_CORE_SHARED_SPIN_LOCK_HPP
+#define NDN_EPAC_CORE_SHARED_SPIN_LOCK_HPP
+
+#include "common.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace ndn {
+namespace epac {
+
+/** \brief reader-writer lock for short critical sections that are mostly read
+ *
+ *  Taking the lock shared costs one atomic increment, so readers never wait for each other.
+ *  A writer first stops new readers, then waits for the readers inside to leave; waiting
+ *  threads yield instead of sleeping. It satisfies the Lockable and SharedLockable
+ *  requirements, so std::lock_guard and SharedSpinLock::SharedGuard can hold it.
+ */
+class SharedSpinLock : noncopyable
+{
+public:
+  /** \brief holds a SharedSpinLock shared during its lifetime
+   */
+  class SharedGuard : noncopyable
+  {
+  public:
+    explicit
+    SharedGuard(SharedSpinLock& lock)
+      : m_lock(lock)
+    {
+      m_lock.lock_shared();
+    }
+
+    ~SharedGuard()
+    {
+      m_lock.unlock_shared();
+    }
+
+  private:
+    SharedSpinLock& m_lock;
+  };
+
+  void
+  lock_shared()
+  {
+    while (m_state.fetch_add(1, std::memory_order_acquire) & WRITER) {
+      // a writer holds or awaits the lock: step back until it is done
+      m_state.fetch_sub(1, std::memory_order_relaxed);
+      while (m_state.load(std::memory_order_relaxed) & WRITER) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void
+  unlock_shared()
+  {
+    m_state.fetch_sub(1, std::memory_order_release);
+  }
+
+  void
+  lock()
+  {
+    uint32_t state = m_state.load(std::memory_order_relaxed) & ~WRITER;
+    while (!m_state.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire)) {
+      if (state & WRITER) {
+        std::this_thread::yield();
+        state &= ~WRITER;
+      }
+    }
+    while (m_state.load(std::memory_order_acquire) != WRITER) {
+      std::this_thread::yield();
+    }
+  }
+
+  void
+  unlock()
+  {
+    m_state.fetch_and(~WRITER, std::memory_order_release);
+  }
+
+private:
+  /** \brief bit set while a writer holds or awaits the lock; the other bits count readers
+   */
+  static const uint32_t WRITER = 1u << 31;
+
+  std::atomic<uint32_t> m_state{0};
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_SHARED_SPIN_LOCK_HPP
@@ -0,0 +1,164 @@
+#ifndef NDN_EPAC_CORE_TLV_HPP
+#define NDN_EPAC_CORE_TLV_HPP
+
+namespace ndn {
+namespace epac {
+namespace tlv {
+
+/** \brief TLV-TYPE codes of EPAC packet formats
+ *
+ *  Content of an encrypted Data packet is laid out as
+ *
+ *      EnvelopeHeader ::= ENVELOPE-HEADER-TYPE TLV-LENGTH
+ *                           Algorithm?
+ *                           WrappedKey
+ *                           InitialVector
+ *                           ChunkSize?
+ *
+ *      Algorithm ::= ALGORITHM-TYPE TLV-LENGTH nonNegativeInteger
+ *      ChunkSize ::= CHUNK-SIZE-TYPE TLV-LENGTH nonNegativeInteger
+ *
+ *  followed by the raw AES-GCM ciphertext of the payload and its authentication tag.
+ *  Algorithm is a CryptoBackend::Type and defaults to RSA-OAEP when absent.
+ *  When ChunkSize is present, the payload is encrypted in chunks of ChunkSize octets
+ *  (the last one may be shorter), each followed by its own authentication tag.
+ *
+ *  A content key wrapped for many users is published as
+ *
+ *      KeyWrapBundle ::= KEY-WRAP-BUNDLE-TYPE TLV-LENGTH
+ *                          KeyWrapEntry*
+ *                          GroupKeyWrap*
+ *
+ *      KeyWrapEntry ::= KEY-WRAP-ENTRY-TYPE TLV-LENGTH
+ *                         UserId
+ *                         Algorithm?
+ *                         WrappedKey
+ *
+ *  with entries sorted by UserId. Algorithm of an entry is the CryptoBackend::Type the user
+ *  registered with, which unwraps its WrappedKey, and defaults to RSA-OAEP when absent.
+ *
+ *  Users are registered with a provider by a signed command Interest
+ *  <prefix>/REGISTER/<Registration> carrying
+ *
+ *      Registration ::= REGISTRATION-TYPE TLV-LENGTH
+ *                         UserRegistration+
+ *
+ *      UserRegistration ::= USER-REGISTRATION-TYPE TLV-LENGTH
+ *                             UserId
+ *                             Algorithm?
+ *                             PublicKey
+ *
+ *      PublicKey ::= PUBLIC-KEY-TYPE TLV-LENGTH *OCTET
+ *
+ *  where PublicKey is the DER (X.509) encoding of the key of the user.
+ *
+ *  Members of an access group share keys arranged in a binary tree (see AccessGroup), and
+ *  learn new keys of the tree from rekey messages published under
+ *  <prefix>/REKEY/<group>/<version>:
+ *
+ *      RekeyMessage ::= REKEY-MESSAGE-TYPE TLV-LENGTH
+ *                         KeyVersion
+ *                         RekeyEntry*
+ *
+ *      RekeyEntry ::= REKEY-ENTRY-TYPE TLV-LENGTH
+ *                       KeyNode
+ *                       (UserId | WrappingNode WrappingVersion)
+ *                       WrappedKey
+ *
+ *      KeyNode ::= KEY-NODE-TYPE TLV-LENGTH nonNegativeInteger
+ *      KeyVersion ::= KEY-VERSION-TYPE TLV-LENGTH nonNegativeInteger
+ *      WrappingNode ::= WRAPPING-NODE-TYPE TLV-LENGTH nonNegativeInteger
+ *      WrappingVersion ::= WRAPPING-VERSION-TYPE TLV-LENGTH nonNegativeInteger
+ *
+ *  Every key of a rekey message takes its KeyVersion. A key is wrapped either for the user
+ *  UserId like a content key, or under the key of node WrappingNode at version
+ *  WrappingVersion, as the initial vector followed by the AES-GCM ciphertext and tag.
+ *  Entries are ordered from the leaves up, so each key is wrapped under keys that come before
+ *  it or are already known.
+ *
+ *  GroupKeyWrap of a KeyWrapBundle is the content key wrapped under the key of a group:
+ *
+ *      GroupKeyWrap ::= GROUP-KEY-WRAP-TYPE TLV-LENGTH
+ *                         GroupId
+ *                         KeyNode
+ *                         KeyVersion
+ *                         WrappedKey
+ *
+ *      GroupId ::= GROUP-ID-TYPE TLV-LENGTH *OCTET
+ *
+ *  The ids of the users registered with a provider are published as a cuckoo filter in
+ *  segments <prefix>/USERS/<version>/<segment>:
+ *
+ *      UserFilter ::= USER-FILTER-TYPE TLV-LENGTH
+ *                       FingerprintSize
+ *                       BucketCount
+ *                       FilterTable
+ *
+ *      FingerprintSize ::= FINGERPRINT-SIZE-TYPE TLV-LENGTH nonNegativeInteger
+ *      BucketCount ::= BUCKET-COUNT-TYPE TLV-LENGTH nonNegativeInteger
+ *      FilterTable ::= FILTER-TABLE-TYPE TLV-LENGTH *OCTET
+ *
+ *  FilterTable packs BucketCount buckets of four fingerprints of FingerprintSize bits each,
+ *  least significant bit first; an empty slot is 0. See CuckooFilter for how user ids are
+ *  hashed.
+ *
+ *  A provider that requires access tokens answers a registration with a ControlResponse
+ *  whose body grants one token to each registered user:
+ *
+ *      TokenGrants ::= TOKEN-GRANTS-TYPE TLV-LENGTH
+ *                        TokenGrant*
+ *
+ *      TokenGrant ::= TOKEN-GRANT-TYPE TLV-LENGTH
+ *                       UserId
+ *                       TokenExpiry
+ *                       WrappedKey
+ *
+ *  where WrappedKey is the TokenMac wrapped for the user like a content key. The user then
+ *  attaches the token as the parameters of its Interests:
+ *
+ *      AccessToken ::= ACCESS-TOKEN-TYPE TLV-LENGTH
+ *                        UserId
+ *                        TokenExpiry
+ *                        TokenMac
+ *
+ *      TokenExpiry ::= TOKEN-EXPIRY-TYPE TLV-LENGTH nonNegativeInteger
+ *      TokenMac ::= TOKEN-MAC-TYPE TLV-LENGTH *OCTET
+ *
+ *  TokenExpiry is in milliseconds since the Unix epoch.
+ */
+enum {
+  EnvelopeHeader   = 128,
+  WrappedKey       = 129,
+  InitialVector    = 130,
+  KeyWrapBundle    = 131,
+  KeyWrapEntry     = 132,
+  UserId           = 133,
+  Algorithm        = 134,
+  ChunkSize        = 135,
+  Registration     = 136,
+  UserRegistration = 137,
+  PublicKey        = 138,
+  RekeyMessage     = 139,
+  RekeyEntry       = 140,
+  KeyNode          = 141,
+  KeyVersion       = 142,
+  WrappingNode     = 143,
+  WrappingVersion  = 144,
+  GroupKeyWrap     = 145,
+  GroupId          = 146,
+  UserFilter       = 147,
+  FingerprintSize  = 148,
+  BucketCount      = 149,
+  FilterTable      = 150,
+  AccessToken      = 151,
+  TokenExpiry      = 152,
+  TokenMac         = 153,
+  TokenGrant       = 154,
+  TokenGrants      = 155
+};
+
+} // namespace tlv
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_TLV_HPP
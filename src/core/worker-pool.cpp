@@ -0,0 +1,110 @@
+#include "worker-pool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace ndn {
+namespace epac {
+
+WorkerPool::WorkerPool(size_t nThreads)
+  : m_work(new boost::asio::io_service::work(m_io))
+{
+  if (nThreads == 0) {
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  for (size_t i = 0; i < nThreads; ++i) {
+    m_threads.emplace_back([this] {
+      for (;;) {
+        try {
+          m_io.run();
+          return;
+        }
+        catch (const std::exception& e) {
+          std::cerr << "ERROR: " << e.what() << std::endl;
+        }
+      }
+    });
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  m_work.reset();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void
+WorkerPool::post(const std::function<void()>& task)
+{
+  m_io.post(task);
+}
+
+void
+WorkerPool::parallelFor(size_t n, const std::function<void(size_t, size_t)>& task)
+{
+  if (n == 0) {
+    return;
+  }
+
+  if (isWorkerThread()) {
+    task(0, n);
+    return;
+  }
+
+  // a few ranges per thread keep the threads busy when ranges take uneven time
+  size_t nRanges = std::min(n, m_threads.size() * 4);
+  size_t rangeSize = (n + nRanges - 1) / nRanges;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t nPending = 0;
+  std::exception_ptr error;
+
+  for (size_t begin = 0; begin < n; begin += rangeSize) {
+    size_t end = std::min(n, begin + rangeSize);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++nPending;
+    }
+    m_io.post([&, begin, end] {
+      std::exception_ptr e;
+      try {
+        task(begin, end);
+      }
+      catch (...) {
+        e = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (e != nullptr && error == nullptr) {
+        error = e;
+      }
+      if (--nPending == 0) {
+        cv.notify_all();
+      }
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return nPending == 0; });
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool
+WorkerPool::isWorkerThread() const
+{
+  std::thread::id self = std::this_thread::get_id();
+  return std::any_of(m_threads.begin(), m_threads.end(),
+                     [self] (const std::thread& thread) { return thread.get_id() == self; });
+}
+
+} // namespace epac
+} // namespace ndn
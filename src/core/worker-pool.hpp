@@ -0,0 +1,96 @@
+#ifndef NDN_EPAC_CORE_WORKER_POOL_HPP
+#define NDN_EPAC_CORE_WORKER_POOL_HPP
+
+#include "common.hpp"
+
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace ndn {
+namespace epac {
+
+/** \brief fixed-size pool of threads running an io_service
+ *
+ *  Tasks posted to the pool run on any of its threads. Cryptographic work done by tasks
+ *  should use CryptoContext::get(), which gives each worker thread its own RNG and caches.
+ */
+class WorkerPool : noncopyable
+{
+public:
+  /** \brief start \p nThreads threads
+   *  \param nThreads number of threads; 0 means one thread per hardware thread
+   */
+  explicit
+  WorkerPool(size_t nThreads = 0);
+
+  /** \brief finish queued tasks and join all threads
+   */
+  ~WorkerPool();
+
+  size_t
+  size() const
+  {
+    return m_threads.size();
+  }
+
+  boost::asio::io_service&
+  getIoService()
+  {
+    return m_io;
+  }
+
+  /** \brief run \p task on one of the worker threads
+   */
+  void
+  post(const std::function<void()>& task);
+
+  /** \brief run \p task on a worker thread, then \p callback with its result on \p io
+   *
+   *  This keeps the thread running \p io (e.g. the thread of a Face) free for I/O while
+   *  \p task does cryptographic work. If \p task throws, \p onError is invoked on \p io
+   *  with the exception instead of \p callback.
+   */
+  template<typename T>
+  void
+  dispatch(boost::asio::io_service& io, const std::function<T()>& task,
+           const std::function<void(const T&)>& callback,
+           const std::function<void(std::exception_ptr)>& onError)
+  {
+    m_io.post([&io, task, callback, onError] {
+      try {
+        T result = task();
+        io.post([callback, result] { callback(result); });
+      }
+      catch (...) {
+        std::exception_ptr e = std::current_exception();
+        io.post([onError, e] { onError(e); });
+      }
+    });
+  }
+
+  /** \brief split [0, \p n) into ranges, run \p task on each range across the pool, and wait
+   *
+   *  \p task is invoked as task(begin, end). The first exception thrown by any invocation
+   *  is rethrown after all ranges have finished.
+   *  When called from a worker thread of this pool, e.g. by a dispatched task, the whole range
+   *  runs on the calling thread, since waiting for other workers could deadlock the pool.
+   */
+  void
+  parallelFor(size_t n, const std::function<void(size_t, size_t)>& task);
+
+  /** \return whether the calling thread is a worker thread of this pool
+   */
+  bool
+  isWorkerThread() const;
+
+private:
+  boost::asio::io_service m_io;
+  unique_ptr<boost::asio::io_service::work> m_work;
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CORE_WORKER_POOL_HPP
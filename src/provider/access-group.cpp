@@ -0,0 +1,119 @@
+#include "access-group.hpp"
+#include "core/envelope.hpp"
+
+namespace ndn {
+namespace epac {
+
+AccessGroup::AccessGroup(const std::string& groupId, uint64_t epoch)
+  : m_groupId(groupId)
+  , m_epoch(epoch)
+  , m_levels(1, std::vector<Node>(1))
+  , m_freeLeaves(1, 0)
+{
+}
+
+RekeyMessage
+AccessGroup::add(const std::string& userId, const CryptoBackend& backend,
+                 const shared_ptr<const CryptoPP::PublicKey>& publicKey)
+{
+  if (contains(userId)) {
+    BOOST_THROW_EXCEPTION(Error(userId + " is already a member of " + m_groupId));
+  }
+
+  // wrapping for a malformed key throws before anything changes
+  Buffer leafKey = envelope::generateContentKey();
+  Buffer wrappedKey = envelope::wrapKey(leafKey, backend, publicKey);
+
+  if (m_freeLeaves.empty()) {
+    grow();
+  }
+  size_t leaf = m_freeLeaves.back();
+  m_freeLeaves.pop_back();
+  m_leaves[userId] = leaf;
+
+  RekeyMessage message(++m_epoch);
+  for (size_t level = 0; level < m_levels.size(); ++level) {
+    ++m_levels[level][leaf >> level].nMembers;
+  }
+  Node& node = m_levels[0][leaf];
+  node.key = std::move(leafKey);
+  node.version = m_epoch;
+  message.addForUser(getNodeId(0, leaf), userId, std::move(wrappedKey));
+
+  rekeyPath(leaf, message);
+  return message;
+}
+
+RekeyMessage
+AccessGroup::remove(const std::string& userId)
+{
+  auto it = m_leaves.find(userId);
+  if (it == m_leaves.end()) {
+    BOOST_THROW_EXCEPTION(Error(userId + " is not a member of " + m_groupId));
+  }
+  size_t leaf = it->second;
+  m_leaves.erase(it);
+  m_freeLeaves.push_back(leaf);
+
+  RekeyMessage message(++m_epoch);
+  for (size_t level = 0; level < m_levels.size(); ++level) {
+    --m_levels[level][leaf >> level].nMembers;
+  }
+  m_levels[0][leaf].key = Buffer();
+
+  rekeyPath(leaf, message);
+  return message;
+}
+
+KeyWrapBundle::GroupEntry
+AccessGroup::wrap(const Buffer& contentKey) const
+{
+  const Node& root = m_levels.back()[0];
+  if (root.nMembers == 0) {
+    BOOST_THROW_EXCEPTION(Error(m_groupId + " has no members"));
+  }
+  return {m_groupId, getNodeId(getDepth(), 0), root.version,
+          envelope::wrapKey(contentKey, root.key)};
+}
+
+void
+AccessGroup::grow()
+{
+  size_t nLeaves = m_levels[0].size();
+  for (auto& nodes : m_levels) {
+    nodes.resize(nodes.size() * 2);
+  }
+  m_levels.emplace_back(1);
+  m_levels.back()[0].nMembers = m_levels[m_levels.size() - 2][0].nMembers;
+
+  // leaves are taken from the back: lower leaves first
+  for (size_t leaf = nLeaves * 2; leaf > nLeaves; --leaf) {
+    m_freeLeaves.push_back(leaf - 1);
+  }
+}
+
+void
+AccessGroup::rekeyPath(size_t leaf, RekeyMessage& message)
+{
+  for (size_t level = 1; level < m_levels.size(); ++level) {
+    size_t index = leaf >> level;
+    Node& node = m_levels[level][index];
+    if (node.nMembers == 0) {
+      node.key = Buffer();
+      continue;
+    }
+
+    node.key = envelope::generateContentKey();
+    node.version = m_epoch;
+    for (size_t child = index * 2; child <= index * 2 + 1; ++child) {
+      const Node& childNode = m_levels[level - 1][child];
+      if (childNode.nMembers > 0) {
+        message.addForNode(getNodeId(level, index), getNodeId(level - 1, child),
+                           childNode.version, envelope::wrapKey(node.key, childNode.key));
+      }
+    }
+  }
+}
+
+} // namespace epac
+} // namespace ndn
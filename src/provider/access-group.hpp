@@ -0,0 +1,155 @@
+#ifndef NDN_EPAC_ACCESS_GROUP_HPP
+#define NDN_EPAC_ACCESS_GROUP_HPP
+
+#include "core/common.hpp"
+#include "core/crypto-backend.hpp"
+#include "core/key-wrap-bundle.hpp"
+#include "core/rekey-message.hpp"
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief users sharing a group key through a logical key hierarchy
+ *
+ * Members sit at the leaves of a complete binary tree of symmetric keys, and each member
+ * holds the keys from its leaf up to the root, whose key is the group key. A content key is
+ * wrapped once under the group key, however many members the group has.
+ *
+ * When a member joins or leaves, every key on the path from its leaf to the root is replaced,
+ * and each new key is wrapped under the keys of the two children of its node. The RekeyMessage
+ * thus carries at most two wrapped keys per level of the tree, plus the leaf key of a joining
+ * member wrapped with its public key: O(log n) symmetric wraps and at most one public-key
+ * wrap per change. A member that leaves cannot unwrap the new keys, and one that joins cannot
+ * unwrap the old ones.
+ *
+ * Node (level, index) covers leaves [index << level, (index + 1) << level), so nodes keep
+ * their ids when the tree grows a level on top to double its leaves. Keys of nodes without
+ * members are dropped. Every change advances the epoch of the group by one, which is the
+ * version of the keys it makes.
+ */
+class AccessGroup : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @param epoch epoch of the group before its first change
+   */
+  AccessGroup(const std::string& groupId, uint64_t epoch);
+
+  const std::string&
+  getId() const
+  {
+    return m_groupId;
+  }
+
+  /**
+   * @return epoch of the last change
+   */
+  uint64_t
+  getEpoch() const
+  {
+    return m_epoch;
+  }
+
+  /**
+   * @return number of members
+   */
+  size_t
+  size() const
+  {
+    return m_leaves.size();
+  }
+
+  /**
+   * @return number of levels above the leaves
+   */
+  size_t
+  getDepth() const
+  {
+    return m_levels.size() - 1;
+  }
+
+  bool
+  contains(const std::string& userId) const
+  {
+    return m_leaves.count(userId) > 0;
+  }
+
+  /**
+   * @brief add @p userId, whose leaf key is wrapped for @p publicKey with @p backend
+   * @return the rekey message of the change
+   * @throw Error @p userId is already a member
+   */
+  RekeyMessage
+  add(const std::string& userId, const CryptoBackend& backend,
+      const shared_ptr<const CryptoPP::PublicKey>& publicKey);
+
+  /**
+   * @brief remove @p userId
+   * @return the rekey message of the change
+   * @throw Error @p userId is not a member
+   */
+  RekeyMessage
+  remove(const std::string& userId);
+
+  /**
+   * @brief wrap @p contentKey under the group key
+   * @throw Error the group has no members
+   */
+  KeyWrapBundle::GroupEntry
+  wrap(const Buffer& contentKey) const;
+
+  /**
+   * @return id of node (@p level, @p index)
+   */
+  static uint64_t
+  getNodeId(size_t level, size_t index)
+  {
+    return (static_cast<uint64_t>(level) << 32) | index;
+  }
+
+private:
+  struct Node
+  {
+    Buffer key;
+    uint64_t version = 0;
+    size_t nMembers = 0;
+  };
+
+  /**
+   * @brief double the leaves, adding a level on top
+   */
+  void
+  grow();
+
+  /**
+   * @brief replace the keys above @p leaf, adding them to @p message
+   */
+  void
+  rekeyPath(size_t leaf, RekeyMessage& message);
+
+private:
+  std::string m_groupId;
+  uint64_t m_epoch;
+  /**
+   * @brief nodes of each level, from the leaves up to the root
+   */
+  std::vector<std::vector<Node>> m_levels;
+  std::unordered_map<std::string, size_t> m_leaves;
+  std::vector<size_t> m_freeLeaves;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_ACCESS_GROUP_HPP
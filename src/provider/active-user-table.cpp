@@ -1,17 +1,736 @@
 #include "active-user-table.hpp"
 
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <exception>
+
 namespace ndn {
 namespace epac {
 
+namespace fs = boost::filesystem;
+
+static const size_t MIN_SLOTS = 16;
+static const size_t MIN_FILTER_CAPACITY = 1024;
+
+const time::seconds ActiveUserTable::EXPIRY_TICK(1);
+
+ActiveUserTable::ActiveUserTable()
+  : m_nMemoryUsers(0)
+  , m_size(0)
+  , m_nShadowed(0)
+  , m_nLoggedChanges(0)
+  , m_ttl(0)
+  , m_origin(time::steady_clock::now())
+  , m_now(0)
+  , m_snapshotDeadline(0)
+  , m_isSnapshotStale(false)
+  , m_filterRate(0)
+  , m_nFilterChanges(0)
+{
+  for (auto& shard : m_shards) {
+    shard.slots.resize(MIN_SLOTS);
+    shard.mask = MIN_SLOTS - 1;
+  }
+}
+
+ActiveUserTable::~ActiveUserTable()
+{
+  deleteDecoded(m_decoded.get(), getNSnapshotUsers());
+}
+
+void
+ActiveUserTable::setTtl(time::seconds ttl)
+{
+  BOOST_ASSERT(m_nMemoryUsers == 0 && m_directory.empty());
+  m_ttl = ttl > time::seconds::zero() ?
+          static_cast<uint32_t>(std::max<int64_t>(ttl / EXPIRY_TICK, 1)) : 0;
+}
+
+void
+ActiveUserTable::setFilterRate(double falsePositiveRate)
+{
+  BOOST_ASSERT(m_nMemoryUsers == 0 && m_directory.empty());
+  BOOST_ASSERT(falsePositiveRate >= 0 && falsePositiveRate < 1);
+  m_filterRate = falsePositiveRate;
+  m_filter.reset();
+  rebuildFilter();
+}
+
+Block
+ActiveUserTable::exportFilter() const
+{
+  std::lock_guard<std::mutex> writeLock(m_writeMutex);
+  BOOST_ASSERT(m_filter != nullptr);
+  return m_filter->wireEncode();
+}
+
+uint64_t
+ActiveUserTable::getCurrentTick() const
+{
+  return static_cast<uint64_t>((time::steady_clock::now() - m_origin) / EXPIRY_TICK);
+}
+
+size_t
+ActiveUserTable::expire()
+{
+  uint64_t tick = getCurrentTick();
+  m_now.store(static_cast<uint32_t>(tick), std::memory_order_relaxed);
+  // a snapshot being saved holds the write lock while it collects or swaps in the users; the
+  // next call expires what is missed now, since the wheel catches up on every tick
+  std::unique_lock<std::mutex> writeLock(m_writeMutex, std::try_to_lock);
+  if (!writeLock.owns_lock() || m_ttl == 0) {
+    return 0;
+  }
+
+  size_t nExpired = 0;
+  m_wheel.advance(tick, [this, tick, &nExpired] (std::string userId) {
+    nExpired += expireUser(userId, tick);
+  });
+  if (m_snapshotDeadline != 0 && tick >= m_snapshotDeadline) {
+    nExpired += expireSnapshot(tick);
+  }
+  return nExpired;
+}
+
+std::string
+ActiveUserTable::getSnapshotFile() const
+{
+  return (fs::path(m_directory) / "users.snapshot").string();
+}
+
+std::string
+ActiveUserTable::getLogFile() const
+{
+  return (fs::path(m_directory) / "users.log").string();
+}
+
+void
+ActiveUserTable::open(const std::string& directory)
+{
+  BOOST_ASSERT(m_nMemoryUsers == 0 && m_directory.empty());
+
+  m_directory = directory.empty() ? "." : directory;
+  boost::system::error_code ec;
+  fs::create_directories(m_directory, ec);
+  if (ec) {
+    BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot create user directory " + m_directory +
+                                              ": " + ec.message()));
+  }
+
+  uint64_t tick = getCurrentTick();
+  m_now.store(static_cast<uint32_t>(tick), std::memory_order_relaxed);
+
+  if (fs::exists(getSnapshotFile())) {
+    m_snapshot.reset(new UserSnapshot(getSnapshotFile()));
+    m_decoded.reset(new DecodedUser[m_snapshot->size()]());
+    m_isShadowed.assign(m_snapshot->size(), 0);
+    if (m_ttl > 0) {
+      m_snapshotDeadline = tick + m_ttl;
+    }
+  }
+  updateSize();
+  rebuildFilter();
+
+  if (!fs::exists(getLogFile())) {
+    return;
+  }
+
+  std::ifstream file(getLogFile(), std::ios::binary);
+  std::string log((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (file.bad()) {
+    BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot read " + getLogFile()));
+  }
+
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(log.data());
+  const uint8_t* end = begin + log.size();
+  UserSnapshot::Record record;
+  for (size_t size; (size = UserSnapshot::decodeRecord(begin, end, record)) > 0; begin += size) {
+    if (record.keySize == 0) {
+      erase(std::string(record.userId, record.userIdSize));
+    }
+    else {
+      unique_ptr<User> user = decodeUser(record);
+      user->lastActive = static_cast<uint32_t>(tick);
+      insert(std::move(user));
+    }
+    ++m_nLoggedChanges;
+  }
+
+  // a record cut short by a crash is dropped, so that the next records are appended after
+  // the last whole one
+  if (begin != end) {
+    fs::resize_file(getLogFile(), log.size() - (end - begin));
+  }
+}
+
+void
+ActiveUserTable::saveSnapshot()
+{
+  BOOST_ASSERT(!m_directory.empty());
+  // the old snapshot is replaced only here, so it stays mapped while the new one is written
+  std::lock_guard<std::mutex> snapshotLock(m_snapshotMutex);
+
+  // changes wait only while the users are collected, not while they are encoded and written
+  std::vector<shared_ptr<const User>> users;
+  std::vector<size_t> snapshotUsers;
+  uint64_t logSize = 0;
+  size_t nLoggedChanges = 0;
+  bool isStale = false;
+  {
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    users.reserve(m_nMemoryUsers);
+    for (const auto& shard : m_shards) {
+      users.insert(users.end(), shard.users.begin(), shard.users.end());
+    }
+    for (size_t i = 0; i < getNSnapshotUsers(); ++i) {
+      if (!m_isShadowed[i]) {
+        snapshotUsers.push_back(i);
+      }
+    }
+    boost::system::error_code ec;
+    logSize = fs::file_size(getLogFile(), ec);
+    if (ec) {
+      logSize = 0;
+    }
+    nLoggedChanges = m_nLoggedChanges;
+    isStale = m_isSnapshotStale;
+  }
+
+  std::vector<std::string> keys(users.size());
+  std::vector<UserSnapshot::Record> records;
+  records.reserve(users.size() + snapshotUsers.size());
+  for (size_t i = 0; i < users.size(); ++i) {
+    CryptoPP::StringSink sink(keys[i]);
+    users[i]->publicKey->Save(sink);
+
+    UserSnapshot::Record record;
+    record.userId = users[i]->userId.data();
+    record.userIdSize = users[i]->userId.size();
+    record.backendType = users[i]->backend->getType();
+    record.key = reinterpret_cast<const uint8_t*>(keys[i].data());
+    record.keySize = keys[i].size();
+    records.push_back(record);
+  }
+  for (size_t i : snapshotUsers) {
+    records.push_back(m_snapshot->getRecord(i));
+  }
+
+  UserSnapshot::write(getSnapshotFile(), records);
+  unique_ptr<UserSnapshot> snapshot(new UserSnapshot(getSnapshotFile()));
+  unique_ptr<DecodedUser[]> decoded(new DecodedUser[snapshot->size()]());
+
+  std::lock_guard<std::mutex> writeLock(m_writeMutex);
+  // users that were in memory are kept there, unless they were removed since; users of the
+  // old snapshot are hidden if they were replaced or removed since
+  std::vector<uint8_t> isShadowed(snapshot->size(), 1);
+  size_t nShadowed = users.size();
+  for (size_t j = 0; j < snapshotUsers.size(); ++j) {
+    isShadowed[users.size() + j] = m_isShadowed[snapshotUsers[j]];
+    nShadowed += m_isShadowed[snapshotUsers[j]];
+  }
+
+  // lookups may be reading the old snapshot: replace it only while every shard is held
+  for (auto& shard : m_shards) {
+    shard.lock.lock();
+  }
+  // users of the old snapshot keep the copies found so far, stamped with their last lookup
+  for (size_t j = 0; j < snapshotUsers.size(); ++j) {
+    const shared_ptr<const User>* user = m_decoded[snapshotUsers[j]].exchange(nullptr);
+    decoded[users.size() + j].store(user, std::memory_order_relaxed);
+  }
+  m_snapshot.swap(snapshot);
+  m_decoded.swap(decoded);
+  m_isShadowed.swap(isShadowed);
+  std::swap(m_nShadowed, nShadowed);
+  for (auto& shard : m_shards) {
+    shard.lock.unlock();
+  }
+
+  // whoever found an old user holds its own reference to it
+  deleteDecoded(decoded.get(), snapshot != nullptr ? snapshot->size() : 0);
+  updateSize();
+  // users of the old snapshot that are not in memory keep the deadline they had; snapshot
+  // users that expire while this is written are dropped by the next save
+  if (isStale) {
+    m_isSnapshotStale.store(false, std::memory_order_relaxed);
+  }
+
+  m_log.close();
+  truncateLog(logSize, m_nLoggedChanges - nLoggedChanges);
+  m_nLoggedChanges -= nLoggedChanges;
+}
+
 void
-ActiveUserTable::add(std::string uid, RSA::PublicKey &pubKey)
+ActiveUserTable::truncateLog(uint64_t offset, size_t nChanges)
+{
+  boost::system::error_code ec;
+  if (nChanges == 0) {
+    fs::remove(getLogFile(), ec);
+    return;
+  }
+
+  // a crash before the rename replays the whole log over the new snapshot, to the same users
+  std::ifstream file(getLogFile(), std::ios::binary);
+  file.seekg(offset);
+  std::string tmpFilename = getLogFile() + ".tmp";
+  {
+    std::ofstream os(tmpFilename, std::ios::binary | std::ios::trunc);
+    os << file.rdbuf();
+    os.close();
+    if (!os || !file) {
+      BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot write " + tmpFilename));
+    }
+  }
+  fs::rename(tmpFilename, getLogFile(), ec);
+  if (ec) {
+    BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot rename " + tmpFilename + ": " +
+                                              ec.message()));
+  }
+}
+
+bool
+ActiveUserTable::add(const std::string& userId, shared_ptr<const CryptoPP::PublicKey> publicKey,
+                     const CryptoBackend& backend)
+{
+  BOOST_ASSERT(publicKey != nullptr);
+  unique_ptr<User> user = makeUser(userId, std::move(publicKey), backend);
+
+  std::lock_guard<std::mutex> writeLock(m_writeMutex);
+  user->lastActive = static_cast<uint32_t>(getCurrentTick());
+  if (!m_directory.empty()) {
+    std::string key;
+    CryptoPP::StringSink sink(key);
+    user->publicKey->Save(sink);
+
+    UserSnapshot::Record record;
+    record.userId = userId.data();
+    record.userIdSize = userId.size();
+    record.backendType = backend.getType();
+    record.key = reinterpret_cast<const uint8_t*>(key.data());
+    record.keySize = key.size();
+    appendLog(record);
+  }
+
+  return insert(std::move(user));
+}
+
+bool
+ActiveUserTable::remove(const std::string& userId)
+{
+  std::lock_guard<std::mutex> writeLock(m_writeMutex);
+  return removeUser(userId);
+}
+
+bool
+ActiveUserTable::removeUser(const std::string& userId)
+{
+  if (!erase(userId)) {
+    return false;
+  }
+
+  if (!m_directory.empty()) {
+    UserSnapshot::Record record;
+    record.userId = userId.data();
+    record.userIdSize = userId.size();
+    appendLog(record);
+  }
+  return true;
+}
+
+shared_ptr<const ActiveUserTable::User>
+ActiveUserTable::find(const std::string& userId) const
 {
-  aut.insert({uid, pubKey});
+  uint32_t h = hash(userId);
+  const Shard& shard = getShard(h);
+  SharedSpinLock::SharedGuard guard(shard.lock);
+
+  size_t position = findSlot(shard, userId, h);
+  if (position != shard.slots.size()) {
+    const shared_ptr<const User>& user = shard.users[shard.slots[position].user - 1];
+    touch(*user);
+    return user;
+  }
+
+  if (m_snapshot != nullptr) {
+    size_t n = m_snapshot->find(userId);
+    if (n != m_snapshot->size() && !m_isShadowed[n]) {
+      shared_ptr<const User> user = getSnapshotUser(n);
+      touch(*user);
+      return user;
+    }
+  }
+  return nullptr;
 }
 
-RSA::PublicKey
-ActiveUserTable::findPublicKeyByUserId(std::string uid) {
-  return aut.find(uid)->second;
+std::vector<shared_ptr<const ActiveUserTable::User>>
+ActiveUserTable::getUsers() const
+{
+  // hold every shard, so that the snapshot and the users it hides stay as they are
+  for (const auto& shard : m_shards) {
+    shard.lock.lock_shared();
+  }
+
+  std::vector<shared_ptr<const User>> users;
+  std::exception_ptr error;
+  try {
+    users.reserve(size());
+    for (const auto& shard : m_shards) {
+      users.insert(users.end(), shard.users.begin(), shard.users.end());
+    }
+    for (size_t i = 0; i < getNSnapshotUsers(); ++i) {
+      if (!m_isShadowed[i]) {
+        users.push_back(getSnapshotUser(i));
+      }
+    }
+  }
+  catch (...) {
+    error = std::current_exception();
+  }
+
+  for (const auto& shard : m_shards) {
+    shard.lock.unlock_shared();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  return users;
+}
+
+unique_ptr<ActiveUserTable::User>
+ActiveUserTable::makeUser(const std::string& userId,
+                          shared_ptr<const CryptoPP::PublicKey> publicKey,
+                          const CryptoBackend& backend)
+{
+  unique_ptr<User> user(new User);
+  user->userId = userId;
+  user->encryptor = backend.makeEncryptor(*publicKey);
+  user->publicKey = std::move(publicKey);
+  user->backend = &backend;
+  return user;
+}
+
+unique_ptr<ActiveUserTable::User>
+ActiveUserTable::decodeUser(const UserSnapshot::Record& record)
+{
+  std::string userId(record.userId, record.userIdSize);
+  try {
+    const CryptoBackend& backend = CryptoBackend::get(record.backendType);
+    shared_ptr<CryptoPP::PublicKey> publicKey = backend.createPublicKey();
+
+    CryptoPP::ByteQueue queue;
+    queue.Put(record.key, record.keySize);
+    queue.MessageEnd();
+    publicKey->Load(queue);
+
+    return makeUser(userId, std::move(publicKey), backend);
+  }
+  catch (const CryptoBackend::Error& e) {
+    BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot decode the key of " + userId + ": " +
+                                              e.what()));
+  }
+  catch (const CryptoPP::Exception& e) {
+    BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot decode the key of " + userId + ": " +
+                                              e.what()));
+  }
+}
+
+shared_ptr<const ActiveUserTable::User>
+ActiveUserTable::getSnapshotUser(size_t n) const
+{
+  const shared_ptr<const User>* user = m_decoded[n].load(std::memory_order_acquire);
+  if (user != nullptr) {
+    return *user;
+  }
+
+  // users may be looked up from several threads; the first decoded copy wins
+  unique_ptr<const shared_ptr<const User>> decoded(
+    new shared_ptr<const User>(decodeUser(m_snapshot->getRecord(n))));
+  if (m_decoded[n].compare_exchange_strong(user, decoded.get(), std::memory_order_acq_rel)) {
+    return *decoded.release();
+  }
+  return *user;
+}
+
+bool
+ActiveUserTable::shadow(const std::string& userId)
+{
+  if (m_snapshot == nullptr) {
+    return false;
+  }
+
+  size_t n = m_snapshot->find(userId);
+  if (n == m_snapshot->size() || m_isShadowed[n]) {
+    return false;
+  }
+  m_isShadowed[n] = 1;
+  ++m_nShadowed;
+  return true;
+}
+
+bool
+ActiveUserTable::insert(shared_ptr<const User> user)
+{
+  uint32_t h = hash(user->userId);
+  Shard& shard = getShard(h);
+  std::lock_guard<SharedSpinLock> lock(shard.lock);
+
+  bool isReplaced = shadow(user->userId);
+  size_t position = findSlot(shard, user->userId, h);
+  if (position != shard.slots.size()) {
+    shard.users[shard.slots[position].user - 1] = std::move(user);
+    updateSize();
+    return false;
+  }
+
+  // keep the load factor at most 1/2, so that probe sequences stay short
+  if ((shard.users.size() + 1) * 2 > shard.slots.size()) {
+    rehash(shard, shard.slots.size() * 2);
+  }
+
+  size_t timer = TimingWheel<std::string>::NONE;
+  if (m_ttl > 0) {
+    timer = m_wheel.schedule(uint64_t(user->lastActive.load()) + m_ttl, user->userId);
+  }
+  shard.users.push_back(std::move(user));
+  shard.timers.push_back(timer);
+  insertSlot(shard, h, static_cast<uint32_t>(shard.users.size()));
+  ++m_nMemoryUsers;
+  updateSize();
+  // a user of the snapshot that was replaced is in the filter already
+  if (!isReplaced) {
+    addToFilter(shard.users.back()->userId);
+  }
+  return !isReplaced;
+}
+
+bool
+ActiveUserTable::erase(const std::string& userId)
+{
+  uint32_t h = hash(userId);
+  Shard& shard = getShard(h);
+  std::lock_guard<SharedSpinLock> lock(shard.lock);
+
+  bool isRemoved = shadow(userId);
+  size_t position = findSlot(shard, userId, h);
+  if (position == shard.slots.size()) {
+    updateSize();
+    if (isRemoved) {
+      removeFromFilter(userId);
+    }
+    return isRemoved;
+  }
+
+  size_t index = shard.slots[position].user - 1;
+  eraseSlot(shard, position);
+  if (shard.timers[index] != TimingWheel<std::string>::NONE) {
+    m_wheel.cancel(shard.timers[index]);
+  }
+
+  // fill the gap in the users of the shard with the last user
+  if (index != shard.users.size() - 1) {
+    const User& last = *shard.users.back();
+    size_t lastPosition = findSlot(shard, last.userId, hash(last.userId));
+    shard.slots[lastPosition].user = static_cast<uint32_t>(index + 1);
+    shard.users[index] = std::move(shard.users.back());
+    shard.timers[index] = shard.timers.back();
+  }
+  shard.users.pop_back();
+  shard.timers.pop_back();
+  --m_nMemoryUsers;
+  updateSize();
+  removeFromFilter(userId);
+  return true;
+}
+
+bool
+ActiveUserTable::expireUser(const std::string& userId, uint64_t tick)
+{
+  uint32_t h = hash(userId);
+  Shard& shard = getShard(h);
+  size_t position = findSlot(shard, userId, h);
+  BOOST_ASSERT(position != shard.slots.size());
+  size_t index = shard.slots[position].user - 1;
+
+  // the timers are read only by changes, so the shard need not be held to reschedule
+  uint64_t deadline = uint64_t(shard.users[index]->lastActive.load()) + m_ttl;
+  if (deadline > tick) {
+    shard.timers[index] = m_wheel.schedule(deadline, userId);
+    return false;
+  }
+
+  shard.timers[index] = TimingWheel<std::string>::NONE;
+  removeUser(userId);
+  return true;
+}
+
+size_t
+ActiveUserTable::expireSnapshot(uint64_t tick)
+{
+  // users of the snapshot looked up within the TTL move to memory, where they expire one by
+  // one; the others are only shadowed, and dropped from the file by the next saveSnapshot()
+  std::vector<shared_ptr<const User>> active;
+  for (size_t i = 0; i < getNSnapshotUsers(); ++i) {
+    const shared_ptr<const User>* user = m_decoded[i].load(std::memory_order_acquire);
+    if (!m_isShadowed[i] && user != nullptr &&
+        uint64_t((*user)->lastActive.load()) + m_ttl > tick) {
+      active.push_back(*user);
+    }
+  }
+  for (auto& user : active) {
+    insert(std::move(user));
+  }
+
+  for (auto& shard : m_shards) {
+    shard.lock.lock();
+  }
+  size_t nExpired = getNSnapshotUsers() - m_nShadowed;
+  std::fill(m_isShadowed.begin(), m_isShadowed.end(), 1);
+  m_nShadowed = getNSnapshotUsers();
+  for (auto& shard : m_shards) {
+    shard.lock.unlock();
+  }
+  updateSize();
+  rebuildFilter();
+  // every user left is in memory, where it expires on its own
+  m_snapshotDeadline = 0;
+  if (nExpired > 0) {
+    m_isSnapshotStale.store(true, std::memory_order_relaxed);
+  }
+  return nExpired;
+}
+
+void
+ActiveUserTable::updateSize()
+{
+  m_size.store(m_nMemoryUsers + getNSnapshotUsers() - m_nShadowed, std::memory_order_relaxed);
+}
+
+void
+ActiveUserTable::addToFilter(const std::string& userId)
+{
+  if (m_filter == nullptr) {
+    return;
+  }
+  if (m_filter->insert(userId)) {
+    ++m_nFilterChanges;
+  }
+  else {
+    // the user is not in the filter yet: the new one is built from the table
+    rebuildFilter();
+  }
+}
+
+void
+ActiveUserTable::removeFromFilter(const std::string& userId)
+{
+  if (m_filter != nullptr) {
+    m_filter->remove(userId);
+    ++m_nFilterChanges;
+  }
+}
+
+void
+ActiveUserTable::rebuildFilter()
+{
+  if (m_filterRate == 0) {
+    return;
+  }
+
+  // an insertion may still fail well below capacity, by bad luck; a larger filter is tried then
+  for (size_t capacity = std::max(size() * 2, MIN_FILTER_CAPACITY); ; capacity *= 2) {
+    unique_ptr<CuckooFilter> filter(new CuckooFilter(capacity, m_filterRate));
+    bool isComplete = true;
+    for (const auto& shard : m_shards) {
+      for (const auto& user : shard.users) {
+        isComplete = isComplete && filter->insert(user->userId);
+      }
+    }
+    for (size_t i = 0; i < getNSnapshotUsers() && isComplete; ++i) {
+      if (!m_isShadowed[i]) {
+        UserSnapshot::Record record = m_snapshot->getRecord(i);
+        isComplete = filter->insert(std::string(record.userId, record.userIdSize));
+      }
+    }
+
+    if (isComplete) {
+      m_filter = std::move(filter);
+      ++m_nFilterChanges;
+      return;
+    }
+  }
+}
+
+void
+ActiveUserTable::appendLog(const UserSnapshot::Record& record)
+{
+  if (!m_log.is_open()) {
+    m_log.open(getLogFile(), std::ios::binary | std::ios::app);
+  }
+
+  UserSnapshot::encodeRecord(m_log, record);
+  m_log.flush();
+  if (!m_log) {
+    BOOST_THROW_EXCEPTION(UserSnapshot::Error("Cannot write " + getLogFile()));
+  }
+  ++m_nLoggedChanges;
+}
+
+size_t
+ActiveUserTable::findSlot(const Shard& shard, const std::string& userId, uint32_t hash)
+{
+  for (size_t position = hash & shard.mask; shard.slots[position].user != 0;
+       position = (position + 1) & shard.mask) {
+    const Slot& slot = shard.slots[position];
+    if (slot.hash == hash && shard.users[slot.user - 1]->userId == userId) {
+      return position;
+    }
+  }
+  return shard.slots.size();
+}
+
+void
+ActiveUserTable::insertSlot(Shard& shard, uint32_t hash, uint32_t user)
+{
+  size_t position = hash & shard.mask;
+  while (shard.slots[position].user != 0) {
+    position = (position + 1) & shard.mask;
+  }
+  shard.slots[position] = {hash, user};
+}
+
+void
+ActiveUserTable::eraseSlot(Shard& shard, size_t position)
+{
+  // shift back the following slots of the probe sequence, so that no lookup stops early
+  size_t mask = shard.mask;
+  size_t hole = position;
+  for (size_t next = (hole + 1) & mask; shard.slots[next].user != 0; next = (next + 1) & mask) {
+    size_t home = shard.slots[next].hash & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      shard.slots[hole] = shard.slots[next];
+      hole = next;
+    }
+  }
+  shard.slots[hole] = {0, 0};
+}
+
+void
+ActiveUserTable::rehash(Shard& shard, size_t nSlots)
+{
+  shard.slots.assign(nSlots, {0, 0});
+  shard.mask = nSlots - 1;
+  for (size_t i = 0; i < shard.users.size(); ++i) {
+    insertSlot(shard, hash(shard.users[i]->userId), static_cast<uint32_t>(i + 1));
+  }
+}
+
+void
+ActiveUserTable::deleteDecoded(DecodedUser* decoded, size_t size)
+{
+  for (size_t i = 0; i < size; ++i) {
+    delete decoded[i].load();
+  }
 }
 
 } // namespace epac
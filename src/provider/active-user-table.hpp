@@ -2,25 +2,459 @@
 #define NDN_EPAC_ACTIVE_USER_TABLE_HPP
 
 #include <core/common.hpp>
+#include <core/crypto-backend.hpp>
+#include <core/cuckoo-filter.hpp>
+#include <core/shared-spin-lock.hpp>
+#include "timing-wheel.hpp"
+#include "user-snapshot.hpp"
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <mutex>
 
 using namespace CryptoPP;
 
 namespace ndn {
 namespace epac {
 
-class ActiveUserTable
+/**
+ * @brief users allowed to receive content keys, by user id
+ *
+ * Every user is kept as an immutable User holding its shared public key together with an
+ * encryptor made for it when the user is added, so wrapping a content key for a user does
+ * not construct anything. Users are found through an open-addressing hash table with linear
+ * probing whose slots hold only a hash and an index, so a lookup touches one or two cache
+ * lines and allocates nothing.
+ *
+ * The table may be read by many threads while others change it. Users are spread over
+ * shards by hash, each guarded by its own SharedSpinLock: a lookup holds one shard shared,
+ * a change holds one shard exclusively, and changes are serialized among themselves. Users
+ * are handed out as shared pointers, so a user found by one thread stays valid while another
+ * removes or replaces it.
+ *
+ * A table opened on a directory persists its users there: a UserSnapshot that is mapped when
+ * the table is opened, and whose users are decoded one by one when they are first looked
+ * up, plus a log of the users added and removed since the snapshot was saved.
+ *
+ * With a TTL, a user expires once it has been neither registered nor looked up for that
+ * long. Each user in memory has an entry in a TimingWheel; a lookup only stamps the user
+ * with the current tick, and an entry that comes due for a user stamped since is scheduled
+ * again instead of expiring. The users of the snapshot expire together, a TTL after the
+ * table is opened, except those looked up meanwhile, which move to memory. Expired users of
+ * the snapshot are only hidden; rewriting the snapshot without them is left to
+ * saveSnapshot(), which the owner of the table may run on another thread.
+ *
+ * With a filter rate, the ids of all users are also kept in a CuckooFilter, updated as users
+ * are added, removed or expire, so that the table can be exported compactly for others to
+ * check users against.
+ */
+class ActiveUserTable : noncopyable
 {
 public:
+  struct User
+  {
+    std::string userId;
+    shared_ptr<const CryptoPP::PublicKey> publicKey;
+    /**
+     * @brief the backend that made encryptor
+     */
+    const CryptoBackend* backend;
+    /**
+     * @brief encryptor for publicKey; encryption only reads the key, and the caller
+     *        supplies the RNG
+     */
+    shared_ptr<const CryptoPP::PK_Encryptor> encryptor;
+    /**
+     * @brief tick of the last registration or lookup of the user
+     */
+    mutable std::atomic<uint32_t> lastActive{0};
+  };
+
+  ActiveUserTable();
+
+  ~ActiveUserTable();
+
+  /**
+   * @brief let users expire after @p ttl without registration or lookup; 0 disables expiry
+   * @pre the table is empty and not open
+   */
+  void
+  setTtl(time::seconds ttl);
+
+  /**
+   * @brief keep the ids of the users in a filter with false positive rate
+   *        @p falsePositiveRate; 0 disables the filter
+   * @pre the table is empty and not open
+   */
+  void
+  setFilterRate(double falsePositiveRate);
+
+  /**
+   * @return the filter of the ids of all users, encoded
+   * @pre the filter is enabled
+   */
+  Block
+  exportFilter() const;
+
+  /**
+   * @return number of changes to the filter so far; the filter needs to be exported again
+   *         only when this changed
+   */
+  uint64_t
+  getNFilterChanges() const
+  {
+    return m_nFilterChanges.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief expire the users whose TTL has passed
+   *
+   * Meant to be called every EXPIRY_TICK; expiring costs a constant time per user that
+   * comes due, however many users there are. Expired users are removed as by remove().
+   * While saveSnapshot() holds the write lock on another thread, this returns at once
+   * instead of waiting, and the next call catches up.
+   *
+   * @return number of users expired
+   * @throw UserSnapshot::Error the removal of a user cannot be logged
+   */
+  size_t
+  expire();
+
+  /**
+   * @brief load the users persisted in @p directory, and persist changes there from now on
+   *
+   * The snapshot is only mapped; the log is replayed, and a partially written record at its
+   * end is discarded.
+   *
+   * Expiry times are not persisted: users loaded from @p directory start a new TTL.
+   *
+   * @pre the table is empty and not open, and no other thread uses it
+   * @throw UserSnapshot::Error the snapshot or log cannot be read, or is malformed
+   */
+  void
+  open(const std::string& directory);
+
+  /**
+   * @brief write all users into a new snapshot, and drop the changes it holds from the log
+   *
+   * Lookups wait only while the new snapshot replaces the old one, and changes only while
+   * the users are collected and while they are replaced, not while the snapshot is written.
+   * Changes made meanwhile stay in the log. Users of the old snapshot that are not in memory
+   * still expire when they would have.
+   *
+   * @pre the table is open
+   * @throw UserSnapshot::Error the snapshot cannot be written
+   */
+  void
+  saveSnapshot();
+
+  /**
+   * @return number of users added or removed since the snapshot was saved
+   */
+  size_t
+  getNLoggedChanges() const
+  {
+    return m_nLoggedChanges.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return whether the snapshot still holds users that expired, which saveSnapshot() drops
+   */
+  bool
+  isSnapshotStale() const
+  {
+    return m_isSnapshotStale.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief add the user @p userId with @p publicKey of @p backend, replacing any user
+   *        with the same id
+   * @return false if a user was replaced
+   * @throw CryptoBackend::Error @p publicKey is not a key of @p backend
+   */
+  bool
+  add(const std::string& userId, shared_ptr<const CryptoPP::PublicKey> publicKey,
+      const CryptoBackend& backend = CryptoBackend::getDefault());
+
+  /**
+   * @return whether a user was removed
+   */
+  bool
+  remove(const std::string& userId);
+
+  /**
+   * @return the user @p userId, or nullptr
+   * @throw UserSnapshot::Error the user is in the snapshot, but cannot be decoded
+   */
+  shared_ptr<const User>
+  find(const std::string& userId) const;
+
+  /**
+   * @return the public key of the user @p userId, or nullptr
+   */
+  shared_ptr<const CryptoPP::PublicKey>
+  findPublicKeyByUserId(const std::string& userId) const
+  {
+    shared_ptr<const User> user = find(userId);
+    return user != nullptr ? user->publicKey : nullptr;
+  }
+
+  /**
+   * @return every user, in no particular order, decoding users of the snapshot
+   *
+   * Changes wait until the users are collected, so the result is the table at one instant.
+   *
+   * @throw UserSnapshot::Error a user of the snapshot cannot be decoded
+   */
+  std::vector<shared_ptr<const User>>
+  getUsers() const;
+
+  size_t
+  size() const
+  {
+    return m_size.load(std::memory_order_relaxed);
+  }
+
+public:
+  /**
+   * @brief granularity of TTLs
+   */
+  static const time::seconds EXPIRY_TICK;
+
+private:
+  struct Slot
+  {
+    uint32_t hash;
+    /**
+     * @brief position in Shard::users plus one; 0 if the slot is empty
+     */
+    uint32_t user;
+  };
+
+  /**
+   * @brief users in memory whose hash starts with the same bits
+   */
+  struct Shard
+  {
+    mutable SharedSpinLock lock;
+    std::vector<shared_ptr<const User>> users;
+    /**
+     * @brief entry of each user in the timing wheel, by position in users
+     */
+    std::vector<size_t> timers;
+    std::vector<Slot> slots;
+    size_t mask;
+  };
+
+  /**
+   * @brief a user of the snapshot once it is decoded, or nullptr
+   */
+  typedef std::atomic<const shared_ptr<const User>*> DecodedUser;
+
+  static uint32_t
+  hash(const std::string& userId)
+  {
+    return static_cast<uint32_t>(std::hash<std::string>()(userId));
+  }
+
+  /**
+   * @return the shard of @p hash; shards are picked by the high bits, slots by the low ones
+   */
+  Shard&
+  getShard(uint32_t hash)
+  {
+    return m_shards[hash >> (32 - SHARD_BITS)];
+  }
+
+  const Shard&
+  getShard(uint32_t hash) const
+  {
+    return m_shards[hash >> (32 - SHARD_BITS)];
+  }
+
+  uint64_t
+  getCurrentTick() const;
+
+  /**
+   * @brief stamp @p user as active at the current tick
+   */
   void
-  add(std::string uid, RSA::PublicKey &pubKey);
+  touch(const User& user) const
+  {
+    uint32_t now = m_now.load(std::memory_order_relaxed);
+    if (user.lastActive.load(std::memory_order_relaxed) < now) {
+      user.lastActive.store(now, std::memory_order_relaxed);
+    }
+  }
 
-  RSA::PublicKey
-  findPublicKeyByUserId(std::string uid);
+  static unique_ptr<User>
+  makeUser(const std::string& userId, shared_ptr<const CryptoPP::PublicKey> publicKey,
+           const CryptoBackend& backend);
+
+  /**
+   * @throw UserSnapshot::Error the backend is unknown, or the key cannot be decoded
+   */
+  static unique_ptr<User>
+  decodeUser(const UserSnapshot::Record& record);
+
+  size_t
+  getNSnapshotUsers() const
+  {
+    return m_snapshot != nullptr ? m_snapshot->size() : 0;
+  }
+
+  /**
+   * @return user number @p n of the snapshot, decoded on first use
+   * @pre a shard is held, so that the snapshot is not replaced meanwhile
+   */
+  shared_ptr<const User>
+  getSnapshotUser(size_t n) const;
+
+  /**
+   * @brief hide the user @p userId of the snapshot, if there is one
+   * @pre the shard of @p userId is held exclusively
+   * @return whether a user was hidden
+   */
+  bool
+  shadow(const std::string& userId);
+
+  bool
+  insert(shared_ptr<const User> user);
+
+  /**
+   * @brief erase @p userId and log the removal
+   */
+  bool
+  removeUser(const std::string& userId);
+
+  /**
+   * @brief expire @p userId, or schedule it again if it was active within the TTL
+   * @return whether the user expired
+   */
+  bool
+  expireUser(const std::string& userId, uint64_t tick);
+
+  /**
+   * @brief expire the users of the snapshot that were not looked up within the TTL
+   * @return number of users expired
+   */
+  size_t
+  expireSnapshot(uint64_t tick);
+
+  /**
+   * @brief keep in the log only the @p nChanges changes logged after @p offset
+   */
+  void
+  truncateLog(uint64_t offset, size_t nChanges);
+
+  bool
+  erase(const std::string& userId);
+
+  void
+  updateSize();
+
+  void
+  addToFilter(const std::string& userId);
+
+  void
+  removeFromFilter(const std::string& userId);
+
+  /**
+   * @brief make a new filter of all users, with room for as many again
+   */
+  void
+  rebuildFilter();
+
+  void
+  appendLog(const UserSnapshot::Record& record);
+
+  std::string
+  getSnapshotFile() const;
+
+  std::string
+  getLogFile() const;
+
+  /**
+   * @return position of the slot of @p userId in @p shard, or shard.slots.size() if there
+   *         is none
+   */
+  static size_t
+  findSlot(const Shard& shard, const std::string& userId, uint32_t hash);
+
+  static void
+  insertSlot(Shard& shard, uint32_t hash, uint32_t user);
+
+  static void
+  eraseSlot(Shard& shard, size_t position);
+
+  static void
+  rehash(Shard& shard, size_t nSlots);
+
+  static void
+  deleteDecoded(DecodedUser* decoded, size_t size);
 
 private:
-  std::unordered_map<std::string, RSA::PublicKey> aut;
+  static const size_t SHARD_BITS = 6;
+
+  std::array<Shard, 1 << SHARD_BITS> m_shards;
+  /**
+   * @brief serializes changes, which are rare, so that each holds only one shard
+   */
+  mutable std::mutex m_writeMutex;
+  /**
+   * @brief serializes saveSnapshot(), which writes the new snapshot without the write lock
+   */
+  std::mutex m_snapshotMutex;
+  size_t m_nMemoryUsers;
+  std::atomic<size_t> m_size;
+
+  std::string m_directory;
+  unique_ptr<UserSnapshot> m_snapshot;
+  /**
+   * @brief users of the snapshot decoded so far, by record number
+   */
+  unique_ptr<DecodedUser[]> m_decoded;
+  /**
+   * @brief whether each user of the snapshot was replaced or removed; an entry is changed
+   *        only while the shard of its user is held exclusively
+   */
+  std::vector<uint8_t> m_isShadowed;
+  size_t m_nShadowed;
+  std::ofstream m_log;
+  std::atomic<size_t> m_nLoggedChanges;
+
+  /**
+   * @brief TTL in ticks; 0 if users do not expire
+   */
+  uint32_t m_ttl;
+  time::steady_clock::TimePoint m_origin;
+  /**
+   * @brief the tick users found now are stamped with
+   */
+  std::atomic<uint32_t> m_now;
+  TimingWheel<std::string> m_wheel;
+  /**
+   * @brief tick at which the users of the snapshot expire; 0 if they do not
+   */
+  uint64_t m_snapshotDeadline;
+  /**
+   * @brief whether users of the snapshot expired since it was saved
+   */
+  std::atomic<bool> m_isSnapshotStale;
+
+  /**
+   * @brief false positive rate of the filter; 0 if there is none
+   */
+  double m_filterRate;
+  /**
+   * @brief ids of all users; changed only while the write lock is held
+   */
+  unique_ptr<CuckooFilter> m_filter;
+  std::atomic<uint64_t> m_nFilterChanges;
 };
-}
+
+} // namespace epac
 } // namespace ndn
 
-#endif
+#endif // NDN_EPAC_ACTIVE_USER_TABLE_HPP
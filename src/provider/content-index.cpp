@@ -0,0 +1,278 @@
+#include "content-index.hpp"
+
+namespace ndn {
+namespace epac {
+
+const name::Component ContentIndex::KEY_BUNDLE_COMPONENT("KEYS");
+
+ContentIndex::ContentIndex(ContentStore& store)
+  : m_store(store)
+  , m_lastId(0)
+{
+}
+
+ContentIndex::Entry&
+ContentIndex::resetEntry(const Name& name)
+{
+  const Entry* previous = m_publications.find(name);
+  if (previous != nullptr) {
+    eraseContent(*previous);
+  }
+
+  Entry& entry = m_publications[name];
+  entry = Entry();
+  entry.name = name;
+  entry.id = ++m_lastId;
+  return entry;
+}
+
+void
+ContentIndex::insert(const Publication& publication)
+{
+  BOOST_ASSERT(!publication.packets.empty());
+
+  Entry& entry = resetEntry(publication.name);
+  entry.nPackets = publication.packets.size();
+  entry.isSegmented = publication.isSegmented;
+
+  for (const auto& packet : publication.packets) {
+    m_store.insert(packet);
+  }
+  setKeyBundle(entry, publication.keyBundle);
+}
+
+void
+ContentIndex::insert(const Name& versionedName, size_t nSegments,
+                     const KeyBundleFactory& keyBundleFactory, const PacketFactory& factory)
+{
+  BOOST_ASSERT(nSegments > 0 && factory != nullptr);
+
+  Entry& entry = resetEntry(versionedName);
+  entry.nPackets = nSegments;
+  entry.isSegmented = true;
+  entry.keyBundleFactory = keyBundleFactory;
+  entry.factory = factory;
+}
+
+void
+ContentIndex::insertLive(const Name& versionedName,
+                         const std::vector<shared_ptr<const Data>>& keyBundle)
+{
+  Entry& entry = resetEntry(versionedName);
+  entry.isSegmented = true;
+  entry.isLive = true;
+  setKeyBundle(entry, keyBundle);
+}
+
+void
+ContentIndex::setKeyBundle(Entry& publication,
+                           const std::vector<shared_ptr<const Data>>& keyBundle)
+{
+  if (keyBundle.empty())
+    return;
+
+  // <name>/KEYS/<version>/<segment>
+  const Name& firstName = keyBundle.front()->getName();
+  BOOST_ASSERT(firstName.size() == publication.name.size() + 3 &&
+               firstName[publication.name.size()] == KEY_BUNDLE_COMPONENT);
+  publication.keyBundleName = firstName.getPrefix(-1);
+  publication.nKeyBundleSegments = keyBundle.size();
+
+  for (const auto& segment : keyBundle) {
+    m_store.insert(segment);
+  }
+}
+
+bool
+ContentIndex::appendSegment(const Name& versionedName, shared_ptr<const Data> segment,
+                            bool isLast)
+{
+  Entry* entry = m_publications.find(versionedName);
+  if (entry == nullptr || !entry->isLive)
+    return false;
+
+  BOOST_ASSERT(segment->getName() == Name(versionedName).appendSegment(entry->nPackets));
+  m_store.insert(std::move(segment));
+  ++entry->nPackets;
+  entry->isLive = !isLast;
+  return true;
+}
+
+bool
+ContentIndex::erase(const Name& name)
+{
+  const Entry* publication = m_publications.find(name);
+  if (publication == nullptr) {
+    return false;
+  }
+
+  eraseContent(*publication);
+  m_publications.erase(name);
+  return true;
+}
+
+void
+ContentIndex::eraseContent(const Entry& publication)
+{
+  if (publication.isSegmented) {
+    for (size_t i = 0; i < publication.nPackets; ++i) {
+      m_store.erase(Name(publication.name).appendSegment(i));
+    }
+  }
+  else {
+    m_store.erase(publication.name);
+  }
+
+  for (size_t i = 0; i < publication.nKeyBundleSegments; ++i) {
+    m_store.erase(Name(publication.keyBundleName).appendSegment(i));
+  }
+}
+
+const ContentIndex::Entry*
+ContentIndex::findPublication(const Name& name) const
+{
+  return m_publications.find(name);
+}
+
+shared_ptr<const Data>
+ContentIndex::find(const Interest& interest)
+{
+  Match match = this->match(interest);
+  if (match.keyBundleFactory != nullptr) {
+    if (!cacheKeyBundle(match, match.keyBundleFactory()))
+      return nullptr;
+    return this->match(interest).data;
+  }
+  if (match.data != nullptr || match.factory == nullptr)
+    return match.data;
+
+  shared_ptr<const Data> data = match.factory(match.dataName);
+  if (data == nullptr || !interest.matchesData(*data))
+    return nullptr;
+
+  cache(match, data);
+  return data;
+}
+
+ContentIndex::Match
+ContentIndex::match(const Interest& interest)
+{
+  const Name& name = interest.getName();
+  Match match;
+
+  // <name>, <name>/<segment>, or a name of the key bundle <name>/KEYS[/<version>[/<segment>]]
+  const Entry* publication = m_publications.findLongestPrefix(name);
+  if (publication != nullptr && publication->name.size() == name.size()) {
+    if (matchInPublication(*publication, interest, match))
+      return match;
+    publication = name.empty() ? nullptr : m_publications.find(name.getPrefix(-1));
+  }
+  if (publication != nullptr && publication->name.size() < name.size() &&
+      matchInPublication(*publication, interest, match))
+    return match;
+
+  // discovery: the last publication whose name starts with the Interest name
+  publication = m_publications.findLast(name);
+  if (publication != nullptr)
+    matchInPublication(*publication, interest, match);
+
+  return match;
+}
+
+bool
+ContentIndex::cache(const Match& match, shared_ptr<const Data> data)
+{
+  const Entry* publication = m_publications.find(match.publicationName);
+  if (publication == nullptr || publication->id != match.publicationId)
+    return false;
+
+  m_store.insert(std::move(data));
+  return true;
+}
+
+bool
+ContentIndex::cacheKeyBundle(const Match& match,
+                             const std::vector<shared_ptr<const Data>>& keyBundle)
+{
+  Entry* publication = m_publications.find(match.publicationName);
+  if (keyBundle.empty() || publication == nullptr || publication->id != match.publicationId)
+    return false;
+
+  // keep the segments already served if the bundle was made twice
+  if (publication->keyBundleName.empty())
+    setKeyBundle(*publication, keyBundle);
+  return true;
+}
+
+bool
+ContentIndex::matchInPublication(const Entry& publication, const Interest& interest,
+                                 Match& match)
+{
+  const Name& name = interest.getName();
+
+  if (name.size() > publication.name.size() &&
+      name[publication.name.size()] == KEY_BUNDLE_COMPONENT) {
+    matchKeyBundle(publication, name, match);
+  }
+  else if (publication.isSegmented && name.size() == publication.name.size() + 1 &&
+           name[-1].isSegment()) {
+    uint64_t segmentNo = name[-1].toSegment();
+    if (segmentNo < publication.nPackets)
+      matchPacket(publication, Name(publication.name).appendSegment(segmentNo), match);
+  }
+  else if (name.size() <= publication.name.size() && publication.nPackets > 0) {
+    // the Data itself, the first segment, or the latest segment of a live publication
+    if (publication.isLive)
+      matchPacket(publication, Name(publication.name).appendSegment(publication.nPackets - 1),
+                  match);
+    else if (publication.isSegmented)
+      matchPacket(publication, Name(publication.name).appendSegment(0), match);
+    else
+      matchPacket(publication, publication.name, match);
+  }
+
+  if (match.data != nullptr && !interest.matchesData(*match.data))
+    match = Match();
+
+  return match.data != nullptr || match.factory != nullptr || match.keyBundleFactory != nullptr;
+}
+
+void
+ContentIndex::matchPacket(const Entry& publication, const Name& dataName, Match& match)
+{
+  match.data = m_store.find(dataName);
+  if (match.data == nullptr && publication.factory != nullptr) {
+    match.dataName = dataName;
+    match.factory = publication.factory;
+    match.publicationName = publication.name;
+    match.publicationId = publication.id;
+  }
+}
+
+void
+ContentIndex::matchKeyBundle(const Entry& publication, const Name& name, Match& match)
+{
+  const Name& bundleName = publication.keyBundleName;
+  if (bundleName.empty()) {
+    // only an Interest without version can ask for a bundle that is not made yet
+    if (publication.keyBundleFactory != nullptr && name.size() == publication.name.size() + 1) {
+      match.dataName = name;
+      match.keyBundleFactory = publication.keyBundleFactory;
+      match.publicationName = publication.name;
+      match.publicationId = publication.id;
+    }
+    return;
+  }
+
+  if (name.size() <= bundleName.size()) {
+    if (name.isPrefixOf(bundleName))
+      match.data = m_store.find(Name(bundleName).appendSegment(0));
+  }
+  else if (name.size() == bundleName.size() + 1 && bundleName.isPrefixOf(name) &&
+           name[-1].isSegment() && name[-1].toSegment() < publication.nKeyBundleSegments) {
+    match.data = m_store.find(name);
+  }
+}
+
+} // namespace epac
+} // namespace ndn
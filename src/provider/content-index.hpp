@@ -0,0 +1,241 @@
+#ifndef NDN_EPAC_CONTENT_INDEX_HPP
+#define NDN_EPAC_CONTENT_INDEX_HPP
+
+#include "core/common.hpp"
+#include "content-store.hpp"
+#include "name-tree.hpp"
+
+#include <functional>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief in-memory index of published content, keyed by Name
+ *
+ * A publication is everything published under one name: either a single Data packet
+ * named by it, or segments <name>/<segment>, plus an optional KeyWrapBundle cut into
+ * segments <name>/KEYS/<version>/<segment>, since a bundle for many users does not fit
+ * into one packet.
+ * The index keeps the layout of every publication; the packets themselves are kept
+ * in a ContentStore. Packets of a lazy publication are made by its PacketFactory when they
+ * are first requested, and kept in the ContentStore from then on. Segments of a live
+ * publication are appended while it is being published.
+ *
+ * Publications are kept in a NameTree, so looking up an Interest costs one hash probe per
+ * name component, however many publications there are. This lets one provider serve any
+ * number of publications under a single registered prefix.
+ */
+class ContentIndex : noncopyable
+{
+public:
+  /**
+   * @brief makes the signed packet named @p dataName of a lazy publication
+   * @return the packet, or nullptr if it cannot be made
+   */
+  typedef std::function<shared_ptr<const Data>(const Name& dataName)> PacketFactory;
+
+  /**
+   * @brief makes the signed segments of the key bundle of a lazy publication
+   * @return the segments in order, or an empty vector if there is no bundle to make
+   */
+  typedef std::function<std::vector<shared_ptr<const Data>>()> KeyBundleFactory;
+
+  struct Publication
+  {
+    Name name;
+    /**
+     * @brief the single Data packet, or the segments in order
+     */
+    std::vector<shared_ptr<const Data>> packets;
+    bool isSegmented = false;
+    /**
+     * @brief segments of the key bundle in order; empty if there is none
+     */
+    std::vector<shared_ptr<const Data>> keyBundle;
+  };
+
+  /**
+   * @brief layout of a publication in the index
+   */
+  struct Entry
+  {
+    Name name;
+    size_t nPackets = 0;
+    bool isSegmented = false;
+    /**
+     * @brief versioned name of the key bundle; empty if there is none or it is not made yet
+     */
+    Name keyBundleName;
+    size_t nKeyBundleSegments = 0;
+    /**
+     * @brief makes the key bundle when it is first requested; empty if not lazy
+     */
+    KeyBundleFactory keyBundleFactory;
+    /**
+     * @brief makes packets that are not in the ContentStore; empty if not lazy
+     */
+    PacketFactory factory;
+    /**
+     * @brief whether segments are still being appended
+     */
+    bool isLive = false;
+    /**
+     * @brief distinguishes a publication from earlier ones under the same name
+     */
+    uint64_t id = 0;
+  };
+
+  /**
+   * @brief outcome of looking up an Interest
+   */
+  struct Match
+  {
+    /**
+     * @brief the packet, if it is in the ContentStore
+     */
+    shared_ptr<const Data> data;
+    /**
+     * @brief the packet to be made by factory, if it is not
+     */
+    Name dataName;
+    PacketFactory factory;
+    /**
+     * @brief the key bundle to be made, if the packet is part of one that is not made yet;
+     *        dataName is then <name>/KEYS
+     */
+    KeyBundleFactory keyBundleFactory;
+    Name publicationName;
+    uint64_t publicationId = 0;
+  };
+
+  explicit
+  ContentIndex(ContentStore& store);
+
+  /**
+   * @brief add @p publication, replacing any publication under the same name
+   */
+  void
+  insert(const Publication& publication);
+
+  /**
+   * @brief add a lazy publication of @p nSegments segments under @p versionedName,
+   *        replacing any publication under the same name
+   * @param keyBundleFactory makes the key bundle when it is first requested; nullptr if there
+   *                         is none
+   */
+  void
+  insert(const Name& versionedName, size_t nSegments, const KeyBundleFactory& keyBundleFactory,
+         const PacketFactory& factory);
+
+  /**
+   * @return whether a publication was removed
+   */
+  bool
+  erase(const Name& name);
+
+  /**
+   * @brief add a live publication under @p versionedName without segments,
+   *        replacing any publication under the same name
+   * @param keyBundle segments of the key bundle; empty if there is none
+   */
+  void
+  insertLive(const Name& versionedName, const std::vector<shared_ptr<const Data>>& keyBundle);
+
+  /**
+   * @brief append the next segment to the live publication under @p versionedName
+   * @param isLast whether @p segment ends the publication
+   * @return false if there is no such live publication
+   */
+  bool
+  appendSegment(const Name& versionedName, shared_ptr<const Data> segment, bool isLast);
+
+  /**
+   * @return the publication under exactly @p name, or nullptr
+   */
+  const Entry*
+  findPublication(const Name& name) const;
+
+  /**
+   * @brief find the Data answering @p interest
+   *
+   * Interests for a publication name, one of its segments, or its key bundle are answered
+   * from that publication; <name>/KEYS and <name>/KEYS/<version> are answered with the first
+   * segment of the key bundle. An Interest whose name is a proper prefix of publication names
+   * (e.g. without version) is answered with the first packet of the last such publication
+   * in canonical order, i.e. the latest version. While a publication is live, Interests
+   * without segment number are answered with its latest segment instead.
+   *
+   * @return the Data, or nullptr if none matches @p interest
+   */
+  shared_ptr<const Data>
+  find(const Interest& interest);
+
+  /**
+   * @brief look up @p interest without making packets
+   *
+   * If the answer is a packet of a lazy publication that is not in the ContentStore, the
+   * returned Match tells which packet to make; the caller can make it on any thread, and
+   * then add it with cache(), or with cacheKeyBundle() if it is a key bundle.
+   */
+  Match
+  match(const Interest& interest);
+
+  /**
+   * @brief add @p data made for @p match to the ContentStore
+   * @return false if the publication was removed or replaced meanwhile
+   */
+  bool
+  cache(const Match& match, shared_ptr<const Data> data);
+
+  /**
+   * @brief add @p keyBundle made for @p match to its publication
+   * @return false if @p keyBundle is empty, or the publication was removed or replaced meanwhile
+   */
+  bool
+  cacheKeyBundle(const Match& match, const std::vector<shared_ptr<const Data>>& keyBundle);
+
+  /**
+   * @return number of publications
+   */
+  size_t
+  size() const
+  {
+    return m_publications.size();
+  }
+
+public:
+  /**
+   * @brief name component appended to a publication name to name its key bundle
+   */
+  static const name::Component KEY_BUNDLE_COMPONENT;
+
+private:
+  Entry&
+  resetEntry(const Name& name);
+
+  bool
+  matchInPublication(const Entry& publication, const Interest& interest, Match& match);
+
+  void
+  matchPacket(const Entry& publication, const Name& dataName, Match& match);
+
+  void
+  matchKeyBundle(const Entry& publication, const Name& name, Match& match);
+
+  void
+  setKeyBundle(Entry& publication, const std::vector<shared_ptr<const Data>>& keyBundle);
+
+  void
+  eraseContent(const Entry& publication);
+
+private:
+  ContentStore& m_store;
+  NameTree<Entry> m_publications;
+  uint64_t m_lastId;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CONTENT_INDEX_HPP
@@ -0,0 +1,206 @@
+#include "content-store.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace epac {
+
+const size_t ContentStore::EXTENT_SIZE = 64 * 1024 * 1024;
+
+ContentStore::ContentStore(size_t capacity, const std::string& spillDirectory)
+  : m_capacity(capacity)
+  , m_spillDirectory(spillDirectory)
+  , m_memoryBytes(0)
+  , m_spillFd(-1)
+  , m_extentUsed(0)
+  , m_spilledBytes(0)
+  , m_freeSpillBytes(0)
+{
+}
+
+ContentStore::~ContentStore()
+{
+  for (const auto& extent : m_extents) {
+    ::munmap(extent.first, extent.second);
+  }
+  if (m_spillFd >= 0) {
+    ::close(m_spillFd);
+  }
+}
+
+void
+ContentStore::insert(shared_ptr<const Data> data)
+{
+  BOOST_ASSERT(data != nullptr);
+
+  auto it = m_entries.find(data->getName());
+  if (it == m_entries.end()) {
+    it = m_entries.emplace(data->getName(), Entry()).first;
+  }
+  else {
+    release(it->second);
+    it->second = Entry();
+  }
+
+  Entry& entry = it->second;
+  entry.size = data->wireEncode().size();
+  entry.data = std::move(data);
+  makeHot(entry);
+  evict();
+}
+
+shared_ptr<const Data>
+ContentStore::find(const Name& name)
+{
+  auto it = m_entries.find(name);
+  if (it == m_entries.end()) {
+    ++m_counters.nMisses;
+    return nullptr;
+  }
+
+  Entry& entry = it->second;
+  if (entry.data != nullptr) {
+    ++m_counters.nHits;
+    m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    return entry.data;
+  }
+
+  ++m_counters.nSpillHits;
+  BOOST_ASSERT(entry.spilled != nullptr);
+  auto data = make_shared<Data>(Block(entry.spilled, entry.size));
+  entry.data = data;
+  makeHot(entry);
+  evict();
+  return data;
+}
+
+bool
+ContentStore::erase(const Name& name)
+{
+  auto it = m_entries.find(name);
+  if (it == m_entries.end()) {
+    return false;
+  }
+
+  release(it->second);
+  m_entries.erase(it);
+  return true;
+}
+
+void
+ContentStore::release(Entry& entry)
+{
+  if (entry.data != nullptr) {
+    m_lru.erase(entry.lruPosition);
+    m_memoryBytes -= entry.size;
+  }
+  if (entry.spilled != nullptr) {
+    freeSpillRange(entry.spilled, entry.size);
+    m_spilledBytes -= entry.size;
+  }
+}
+
+void
+ContentStore::makeHot(Entry& entry)
+{
+  entry.lruPosition = m_lru.insert(m_lru.begin(), &entry);
+  m_memoryBytes += entry.size;
+}
+
+void
+ContentStore::evict()
+{
+  while (m_memoryBytes > m_capacity && !m_lru.empty()) {
+    Entry& entry = *m_lru.back();
+
+    // a packet that was spilled before is still in the scratch file
+    if (entry.spilled == nullptr) {
+      entry.spilled = spill(entry.data->wireEncode());
+    }
+
+    entry.data.reset();
+    m_memoryBytes -= entry.size;
+    m_lru.pop_back();
+    ++m_counters.nEvictions;
+  }
+}
+
+uint8_t*
+ContentStore::spill(const Block& wire)
+{
+  uint8_t* destination = nullptr;
+  auto range = m_freeSpillRanges.lower_bound(wire.size());
+  if (range != m_freeSpillRanges.end()) {
+    // smallest free range that fits; the rest of it stays free
+    destination = range->second;
+    size_t rest = range->first - wire.size();
+    m_freeSpillBytes -= range->first;
+    m_freeSpillRanges.erase(range);
+    if (rest > 0) {
+      freeSpillRange(destination + wire.size(), rest);
+    }
+  }
+  else {
+    if (m_extents.empty() || m_extentUsed + wire.size() > m_extents.back().second) {
+      addExtent((wire.size() + EXTENT_SIZE - 1) / EXTENT_SIZE * EXTENT_SIZE);
+    }
+    destination = m_extents.back().first + m_extentUsed;
+    m_extentUsed += wire.size();
+  }
+
+  std::memcpy(destination, wire.wire(), wire.size());
+  m_spilledBytes += wire.size();
+  return destination;
+}
+
+void
+ContentStore::freeSpillRange(uint8_t* begin, size_t size)
+{
+  m_freeSpillRanges.emplace(size, begin);
+  m_freeSpillBytes += size;
+}
+
+void
+ContentStore::addExtent(size_t size)
+{
+  if (m_spillFd < 0) {
+    std::string path = (boost::filesystem::path(m_spillDirectory) / "epac-spill-XXXXXX").string();
+    std::vector<char> filename(path.begin(), path.end());
+    filename.push_back('\0');
+
+    m_spillFd = ::mkstemp(filename.data());
+    if (m_spillFd < 0) {
+      BOOST_THROW_EXCEPTION(Error("Cannot create spill file in " + m_spillDirectory + ": " +
+                                  std::strerror(errno)));
+    }
+    // the file lives as long as its descriptor
+    ::unlink(filename.data());
+  }
+
+  off_t offset = 0;
+  for (const auto& extent : m_extents) {
+    offset += extent.second;
+  }
+
+  if (::ftruncate(m_spillFd, offset + size) != 0) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Cannot extend spill file: ") + std::strerror(errno)));
+  }
+
+  void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_spillFd, offset);
+  if (address == MAP_FAILED) {
+    BOOST_THROW_EXCEPTION(Error(std::string("Cannot map spill file: ") + std::strerror(errno)));
+  }
+
+  m_extents.emplace_back(static_cast<uint8_t*>(address), size);
+  m_extentUsed = 0;
+}
+
+} // namespace epac
+} // namespace ndn
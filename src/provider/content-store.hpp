@@ -0,0 +1,204 @@
+#ifndef NDN_EPAC_CONTENT_STORE_HPP
+#define NDN_EPAC_CONTENT_STORE_HPP
+
+#include "core/common.hpp"
+
+#include <limits>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief signed Data packets of a provider, kept within a memory budget
+ *
+ * Packets are stored by Data name. Hot packets are kept in memory as Data objects with their
+ * wire encoding, and the least recently used ones are evicted when the wires exceed the
+ * budget. An evicted packet is spilled once into a memory-mapped scratch file, and decoded
+ * from its wire when requested again, so it never needs to be encrypted or signed again.
+ *
+ * The scratch file is created in the spill directory on the first eviction and unlinked
+ * immediately. The range of a spilled packet that is erased or replaced is freed, and later
+ * spills take the smallest free range they fit in, so the file grows only when none fits.
+ * Free ranges are not merged.
+ *
+ * @note ContentStore is not thread-safe.
+ */
+class ContentStore : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct Counters
+  {
+    /**
+     * @brief lookups answered from memory
+     */
+    uint64_t nHits = 0;
+    /**
+     * @brief lookups answered from the scratch file
+     */
+    uint64_t nSpillHits = 0;
+    uint64_t nMisses = 0;
+    /**
+     * @brief packets moved out of memory
+     */
+    uint64_t nEvictions = 0;
+  };
+
+  /**
+   * @param capacity memory budget in octets of Data wire encoding
+   * @param spillDirectory directory of the scratch file
+   */
+  explicit
+  ContentStore(size_t capacity = std::numeric_limits<size_t>::max(),
+               const std::string& spillDirectory = "/tmp");
+
+  ~ContentStore();
+
+  /**
+   * @brief add @p data, replacing a packet of the same name
+   * @pre @p data is signed
+   * @throw Error the scratch file cannot be extended
+   */
+  void
+  insert(shared_ptr<const Data> data);
+
+  /**
+   * @return the packet named exactly @p name, or nullptr
+   * @throw Error the scratch file cannot be extended
+   */
+  shared_ptr<const Data>
+  find(const Name& name);
+
+  /**
+   * @return whether a packet was removed
+   */
+  bool
+  erase(const Name& name);
+
+  /**
+   * @return number of packets, in memory or spilled
+   */
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @return octets of wire encoding held in memory
+   */
+  size_t
+  getMemoryBytes() const
+  {
+    return m_memoryBytes;
+  }
+
+  /**
+   * @return octets of the scratch file holding the wires of stored packets
+   */
+  size_t
+  getSpilledBytes() const
+  {
+    return m_spilledBytes;
+  }
+
+  /**
+   * @return octets of the scratch file freed by erased or replaced packets, not yet reused
+   */
+  size_t
+  getFreeSpillBytes() const
+  {
+    return m_freeSpillBytes;
+  }
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+public:
+  /**
+   * @brief granularity in which the scratch file is extended and mapped
+   */
+  static const size_t EXTENT_SIZE;
+
+private:
+  struct Entry;
+  typedef std::list<Entry*> LruList;
+
+  struct Entry
+  {
+    /**
+     * @brief decoded packet; nullptr if evicted
+     */
+    shared_ptr<const Data> data;
+    size_t size = 0;
+    /**
+     * @brief wire in the scratch file; nullptr if never spilled
+     */
+    uint8_t* spilled = nullptr;
+    LruList::iterator lruPosition;
+  };
+
+  void
+  makeHot(Entry& entry);
+
+  /**
+   * @brief remove @p entry from memory and free its range of the scratch file
+   */
+  void
+  release(Entry& entry);
+
+  void
+  evict();
+
+  uint8_t*
+  spill(const Block& wire);
+
+  void
+  freeSpillRange(uint8_t* begin, size_t size);
+
+  void
+  addExtent(size_t size);
+
+private:
+  size_t m_capacity;
+  std::string m_spillDirectory;
+
+  std::map<Name, Entry> m_entries;
+  LruList m_lru;
+  size_t m_memoryBytes;
+
+  int m_spillFd;
+  std::vector<std::pair<uint8_t*, size_t>> m_extents;
+  size_t m_extentUsed;
+  size_t m_spilledBytes;
+  /**
+   * @brief free ranges of the scratch file by size
+   */
+  std::multimap<size_t, uint8_t*> m_freeSpillRanges;
+  size_t m_freeSpillBytes;
+
+  Counters m_counters;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_CONTENT_STORE_HPP
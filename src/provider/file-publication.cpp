@@ -0,0 +1,87 @@
+#include "file-publication.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/stream.hpp>
+
+namespace ndn {
+namespace epac {
+
+FilePublication::FilePublication(const std::string& path, uint64_t fileSize,
+                                 const Name& versionedName, size_t maxSegmentSize,
+                                 const CryptoBackend& backend,
+                                 shared_ptr<const CryptoPP::PublicKey> key)
+  : m_path(path)
+  , m_fileSize(fileSize)
+  , m_name(versionedName)
+  , m_maxSegmentSize(maxSegmentSize)
+  , m_nSegments(std::max<uint64_t>(1, (fileSize + maxSegmentSize - 1) / maxSegmentSize))
+  , m_backend(backend)
+  , m_key(std::move(key))
+{
+  BOOST_ASSERT(m_maxSegmentSize > 0);
+}
+
+Buffer
+FilePublication::getContentKey()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_contentKey.empty()) {
+    m_contentKey = envelope::generateContentKey();
+  }
+  return m_contentKey;
+}
+
+const envelope::Sealer&
+FilePublication::getSealer()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_sealer != nullptr) {
+    return *m_sealer;
+  }
+
+  if (m_contentKey.empty()) {
+    m_contentKey = envelope::generateContentKey();
+  }
+  m_sealer.reset(new envelope::Sealer(m_contentKey, m_backend, m_key));
+  return *m_sealer;
+}
+
+shared_ptr<Data>
+FilePublication::makeSegment(uint64_t segmentNo)
+{
+  BOOST_ASSERT(segmentNo < m_nSegments);
+  const envelope::Sealer& sealer = getSealer();
+
+  uint64_t offset = segmentNo * m_maxSegmentSize;
+  size_t size = static_cast<size_t>(std::min<uint64_t>(m_maxSegmentSize, m_fileSize - offset));
+  boost::system::error_code ec;
+  if (boost::filesystem::file_size(m_path, ec) != m_fileSize || ec) {
+    BOOST_THROW_EXCEPTION(Error(m_path + " has changed since it was published"));
+  }
+
+  // only the range of the segment is mapped, and only while it is sealed, so that a daemon
+  // publishing many files keeps no descriptor or mapping open between requests
+  boost::iostreams::mapped_file_source file;
+  const char* begin = nullptr;
+  if (size > 0) {
+    uint64_t alignedOffset = offset - offset % boost::iostreams::mapped_file_source::alignment();
+    try {
+      file.open(m_path, static_cast<size_t>(size + offset - alignedOffset), alignedOffset);
+    }
+    catch (const std::exception& e) {
+      BOOST_THROW_EXCEPTION(Error("Cannot map " + m_path + ": " + e.what()));
+    }
+    begin = file.data() + (offset - alignedOffset);
+  }
+  boost::iostreams::stream<boost::iostreams::array_source> input(begin, size);
+
+  auto segment = make_shared<Data>(Name(m_name).appendSegment(segmentNo));
+  segment->setContent(sealer.sealStream(input, m_maxSegmentSize, m_maxSegmentSize));
+  segment->setFinalBlockId(name::Component::fromSegment(m_nSegments - 1));
+  return segment;
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,94 @@
+#ifndef NDN_EPAC_FILE_PUBLICATION_HPP
+#define NDN_EPAC_FILE_PUBLICATION_HPP
+
+#include "core/common.hpp"
+#include "core/envelope.hpp"
+
+#include <mutex>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief a file published as segments <name>/<version>/<segment> that are sealed on request
+ *
+ * Nothing is read or encrypted when the publication is created. The content key is generated
+ * and wrapped when the first segment is requested, and each segment is sealed straight from
+ * a mapping of its range of the file, which is unmapped once the segment is made. Segments
+ * have the same layout as those of Segmenter.
+ *
+ * Segments may be made by several threads at once.
+ */
+class FilePublication : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @param fileSize size of the file when it is published
+   */
+  FilePublication(const std::string& path, uint64_t fileSize, const Name& versionedName,
+                  size_t maxSegmentSize, const CryptoBackend& backend,
+                  shared_ptr<const CryptoPP::PublicKey> key);
+
+  const Name&
+  getName() const
+  {
+    return m_name;
+  }
+
+  /**
+   * @return number of segments; an empty file has one segment with an empty payload
+   */
+  uint64_t
+  getNSegments() const
+  {
+    return m_nSegments;
+  }
+
+  /**
+   * @return content key of the publication, generated on first use
+   */
+  Buffer
+  getContentKey();
+
+  /**
+   * @return unsigned segment @p segmentNo with FinalBlockId set
+   * @throw Error the file cannot be mapped or has changed size since it was published
+   */
+  shared_ptr<Data>
+  makeSegment(uint64_t segmentNo);
+
+private:
+  /**
+   * @return the Sealer, made on first use
+   */
+  const envelope::Sealer&
+  getSealer();
+
+private:
+  std::string m_path;
+  uint64_t m_fileSize;
+  Name m_name;
+  size_t m_maxSegmentSize;
+  uint64_t m_nSegments;
+  const CryptoBackend& m_backend;
+  shared_ptr<const CryptoPP::PublicKey> m_key;
+
+  std::mutex m_mutex;
+  Buffer m_contentKey;
+  unique_ptr<envelope::Sealer> m_sealer;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_FILE_PUBLICATION_HPP
@@ -0,0 +1,35 @@
+#include "in-flight-table.hpp"
+
+namespace ndn {
+namespace epac {
+
+InFlightTable::InFlightTable()
+  : m_nCoalesced(0)
+{
+}
+
+bool
+InFlightTable::add(const Name& dataName, const Interest& interest)
+{
+  auto result = m_packets.emplace(dataName, std::vector<Interest>());
+  result.first->second.push_back(interest);
+  if (!result.second) {
+    ++m_nCoalesced;
+  }
+  return result.second;
+}
+
+std::vector<Interest>
+InFlightTable::remove(const Name& dataName)
+{
+  std::vector<Interest> interests;
+  auto it = m_packets.find(dataName);
+  if (it != m_packets.end()) {
+    interests = std::move(it->second);
+    m_packets.erase(it);
+  }
+  return interests;
+}
+
+} // namespace epac
+} // namespace ndn
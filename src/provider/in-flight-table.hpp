@@ -0,0 +1,69 @@
+#ifndef NDN_EPAC_IN_FLIGHT_TABLE_HPP
+#define NDN_EPAC_IN_FLIGHT_TABLE_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief Interests waiting for packets that are being made
+ *
+ * The first Interest for a packet starts making it; Interests for the same packet that
+ * arrive meanwhile are coalesced with it and answered from the same result.
+ */
+class InFlightTable : noncopyable
+{
+public:
+  InFlightTable();
+
+  /**
+   * @brief record that @p interest waits for the packet named @p dataName
+   * @return true if no packet of that name is being made yet, i.e. the caller must make it
+   */
+  bool
+  add(const Name& dataName, const Interest& interest);
+
+  /**
+   * @return the Interests waiting for the packet named @p dataName, forgetting them
+   */
+  std::vector<Interest>
+  remove(const Name& dataName);
+
+  /**
+   * @brief forget all waiting Interests
+   */
+  void
+  clear()
+  {
+    m_packets.clear();
+  }
+
+  /**
+   * @return number of packets being made
+   */
+  size_t
+  size() const
+  {
+    return m_packets.size();
+  }
+
+  /**
+   * @return number of Interests that did not start making a packet because it was already
+   *         being made
+   */
+  uint64_t
+  getNCoalesced() const
+  {
+    return m_nCoalesced;
+  }
+
+private:
+  std::map<Name, std::vector<Interest>> m_packets;
+  uint64_t m_nCoalesced;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_IN_FLIGHT_TABLE_HPP
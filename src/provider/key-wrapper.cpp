@@ -0,0 +1,55 @@
+#include "key-wrapper.hpp"
+#include "core/crypto-context.hpp"
+
+namespace ndn {
+namespace epac {
+
+KeyWrapper::KeyWrapper(WorkerPool& pool)
+  : m_pool(pool)
+{
+}
+
+KeyWrapBundle
+KeyWrapper::wrapForAll(const Buffer& contentKey, const ActiveUserTable& aut)
+{
+  return wrap(contentKey, aut.getUsers());
+}
+
+KeyWrapBundle
+KeyWrapper::wrapForUsers(const Buffer& contentKey, const ActiveUserTable& aut,
+                         const std::vector<std::string>& userIds)
+{
+  UserList users;
+  users.reserve(userIds.size());
+  for (const auto& uid : userIds) {
+    shared_ptr<const ActiveUserTable::User> user = aut.find(uid);
+    if (user != nullptr) {
+      users.push_back(std::move(user));
+    }
+  }
+  return wrap(contentKey, users);
+}
+
+KeyWrapBundle
+KeyWrapper::wrap(const Buffer& contentKey, const UserList& users)
+{
+  std::vector<KeyWrapBundle::Entry> entries(users.size());
+
+  m_pool.parallelFor(users.size(), [&] (size_t begin, size_t end) {
+    CryptoContext& context = CryptoContext::get();
+    for (size_t i = begin; i < end; ++i) {
+      const ActiveUserTable::User& user = *users[i];
+      KeyWrapBundle::Entry& entry = entries[i];
+      entry.userId = user.userId;
+      entry.algorithm = user.backend->getType();
+      entry.wrappedKey = Buffer(user.encryptor->CiphertextLength(contentKey.size()));
+      user.encryptor->Encrypt(context.getRng(), contentKey.data(), contentKey.size(),
+                              entry.wrappedKey.data());
+    }
+  });
+
+  return KeyWrapBundle(std::move(entries));
+}
+
+} // namespace epac
+} // namespace ndn
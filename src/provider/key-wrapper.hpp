@@ -0,0 +1,53 @@
+#ifndef NDN_EPAC_KEY_WRAPPER_HPP
+#define NDN_EPAC_KEY_WRAPPER_HPP
+
+#include "core/common.hpp"
+#include "core/crypto-backend.hpp"
+#include "core/key-wrap-bundle.hpp"
+#include "core/worker-pool.hpp"
+#include "active-user-table.hpp"
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief wraps one content key for many users of an ActiveUserTable
+ *
+ * Each user costs one public-key encryption, using the encryptor kept for the user by the
+ * ActiveUserTable, i.e. with the CryptoBackend the user registered with, which is recorded in
+ * the entry of the user; users are split across the threads of a WorkerPool.
+ */
+class KeyWrapper : noncopyable
+{
+public:
+  explicit
+  KeyWrapper(WorkerPool& pool);
+
+  /**
+   * @brief wrap @p contentKey for every user in @p aut
+   */
+  KeyWrapBundle
+  wrapForAll(const Buffer& contentKey, const ActiveUserTable& aut);
+
+  /**
+   * @brief wrap @p contentKey for the users in @p userIds
+   * @note user ids that are not in @p aut are skipped
+   */
+  KeyWrapBundle
+  wrapForUsers(const Buffer& contentKey, const ActiveUserTable& aut,
+               const std::vector<std::string>& userIds);
+
+private:
+  typedef std::vector<shared_ptr<const ActiveUserTable::User>> UserList;
+
+  KeyWrapBundle
+  wrap(const Buffer& contentKey, const UserList& users);
+
+private:
+  WorkerPool& m_pool;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_KEY_WRAPPER_HPP
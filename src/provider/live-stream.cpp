@@ -0,0 +1,89 @@
+#include "live-stream.hpp"
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+namespace ndn {
+namespace epac {
+
+LiveStream::LiveStream(const envelope::Sealer& sealer, const Name& versionedName,
+                       size_t segmentSize)
+  : m_sealer(sealer)
+  , m_name(versionedName)
+  , m_segmentSize(segmentSize)
+  , m_nPieces(0)
+  , m_isClosed(false)
+{
+  BOOST_ASSERT(m_segmentSize > 0);
+  m_pending.reserve(m_segmentSize);
+}
+
+std::vector<LiveStream::Piece>
+LiveStream::write(const uint8_t* input, size_t size)
+{
+  BOOST_ASSERT(!m_isClosed);
+
+  std::vector<Piece> pieces;
+  while (size > 0) {
+    size_t n = std::min(size, m_segmentSize - m_pending.size());
+    m_pending.insert(m_pending.end(), input, input + n);
+    input += n;
+    size -= n;
+
+    if (m_pending.size() == m_segmentSize) {
+      pieces.push_back(cut(false));
+    }
+  }
+  return pieces;
+}
+
+std::vector<LiveStream::Piece>
+LiveStream::flush()
+{
+  BOOST_ASSERT(!m_isClosed);
+
+  std::vector<Piece> pieces;
+  if (!m_pending.empty()) {
+    pieces.push_back(cut(false));
+  }
+  return pieces;
+}
+
+LiveStream::Piece
+LiveStream::close()
+{
+  BOOST_ASSERT(!m_isClosed);
+  m_isClosed = true;
+  return cut(true);
+}
+
+LiveStream::Piece
+LiveStream::cut(bool isLast)
+{
+  Piece piece;
+  piece.segmentNo = m_nPieces++;
+  piece.payload = make_shared<Buffer>(std::move(m_pending));
+  piece.isLast = isLast;
+
+  m_pending = Buffer();
+  m_pending.reserve(m_segmentSize);
+  return piece;
+}
+
+shared_ptr<Data>
+LiveStream::makeSegment(const Piece& piece) const
+{
+  const Buffer& payload = *piece.payload;
+  boost::iostreams::stream<boost::iostreams::array_source> input(
+    reinterpret_cast<const char*>(payload.data()), payload.size());
+
+  auto segment = make_shared<Data>(Name(m_name).appendSegment(piece.segmentNo));
+  segment->setContent(m_sealer.sealStream(input, m_segmentSize, m_segmentSize));
+  if (piece.isLast) {
+    segment->setFinalBlockId(name::Component::fromSegment(piece.segmentNo));
+  }
+  return segment;
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,103 @@
+#ifndef NDN_EPAC_LIVE_STREAM_HPP
+#define NDN_EPAC_LIVE_STREAM_HPP
+
+#include "core/common.hpp"
+#include "core/envelope.hpp"
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief cuts input that arrives over time into segments <name>/<version>/<segment>
+ *
+ * Input is cut into pieces of the segment size as soon as enough of it has arrived; flush
+ * cuts what has arrived so far, e.g. when the input pauses. Only the last piece, cut by
+ * close at the end of the input, is marked so that its segment carries FinalBlockId.
+ * Segments have the same envelope layout as those of Segmenter.
+ */
+class LiveStream : noncopyable
+{
+public:
+  struct Piece
+  {
+    uint64_t segmentNo;
+    shared_ptr<const Buffer> payload;
+    bool isLast;
+  };
+
+  LiveStream(const envelope::Sealer& sealer, const Name& versionedName, size_t segmentSize);
+
+  const Name&
+  getName() const
+  {
+    return m_name;
+  }
+
+  /**
+   * @return number of pieces cut so far
+   */
+  uint64_t
+  getNPieces() const
+  {
+    return m_nPieces;
+  }
+
+  bool
+  isClosed() const
+  {
+    return m_isClosed;
+  }
+
+  /**
+   * @return octets of input that are not in a piece yet
+   */
+  size_t
+  getPendingSize() const
+  {
+    return m_pending.size();
+  }
+
+  /**
+   * @brief append @p size octets of input
+   * @return the pieces completed by them
+   */
+  std::vector<Piece>
+  write(const uint8_t* input, size_t size);
+
+  /**
+   * @return the input that is not in a piece yet as a piece, if there is any
+   */
+  std::vector<Piece>
+  flush();
+
+  /**
+   * @brief end the input
+   * @return the last piece, holding the input that is not in a piece yet (possibly none)
+   */
+  Piece
+  close();
+
+  /**
+   * @return unsigned segment carrying @p piece
+   * @note may be called from several threads at once
+   */
+  shared_ptr<Data>
+  makeSegment(const Piece& piece) const;
+
+private:
+  Piece
+  cut(bool isLast);
+
+private:
+  const envelope::Sealer& m_sealer;
+  Name m_name;
+  size_t m_segmentSize;
+  Buffer m_pending;
+  uint64_t m_nPieces;
+  bool m_isClosed;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_LIVE_STREAM_HPP
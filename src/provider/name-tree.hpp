@@ -0,0 +1,272 @@
+#ifndef NDN_EPAC_NAME_TREE_HPP
+#define NDN_EPAC_NAME_TREE_HPP
+
+#include "core/common.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <limits>
+#include <unordered_map>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief maps Names to values through a tree of name components
+ *
+ * Lookups walk the Name one component at a time, so an exact match, a longest prefix match
+ * and finding the last name under a prefix all cost one hash probe per component, however
+ * many names are stored. Nodes are kept in one vector and linked by index; children are
+ * found through a single hash table keyed by parent and component, so a node costs no
+ * container of its own. A node without a value exists only while it has children.
+ *
+ * Values are allocated separately and keep their address until they are erased.
+ */
+template<typename T>
+class NameTree : noncopyable
+{
+public:
+  NameTree()
+    : m_nodes(1)
+    , m_size(0)
+  {
+  }
+
+  /**
+   * @return the value under exactly @p name, inserting a default-constructed one if there
+   *         is none
+   */
+  T&
+  operator[](const Name& name)
+  {
+    size_t id = ROOT;
+    for (const auto& component : name) {
+      size_t child = findChild(id, component);
+      id = child != NONE ? child : addChild(id, component);
+    }
+
+    Node& node = m_nodes[id];
+    if (node.value == nullptr) {
+      node.value.reset(new T());
+      ++m_size;
+    }
+    return *node.value;
+  }
+
+  /**
+   * @return the value under exactly @p name, or nullptr
+   */
+  T*
+  find(const Name& name)
+  {
+    size_t id = findNode(name);
+    return id != NONE ? m_nodes[id].value.get() : nullptr;
+  }
+
+  const T*
+  find(const Name& name) const
+  {
+    return const_cast<NameTree*>(this)->find(name);
+  }
+
+  /**
+   * @return the value under the longest prefix of @p name (@p name itself included)
+   *         that has one, or nullptr
+   */
+  T*
+  findLongestPrefix(const Name& name)
+  {
+    T* value = m_nodes[ROOT].value.get();
+    size_t id = ROOT;
+    for (const auto& component : name) {
+      id = findChild(id, component);
+      if (id == NONE)
+        break;
+      if (m_nodes[id].value != nullptr)
+        value = m_nodes[id].value.get();
+    }
+    return value;
+  }
+
+  /**
+   * @return the value under the last name in canonical order that @p prefix is a proper
+   *         prefix of, or nullptr
+   */
+  T*
+  findLast(const Name& prefix)
+  {
+    size_t id = findNode(prefix);
+    if (id == NONE || m_nodes[id].lastChild == NONE)
+      return nullptr;
+
+    // a name sorts after its prefixes, so the last name is the deepest on the rightmost path
+    while (m_nodes[id].lastChild != NONE)
+      id = m_nodes[id].lastChild;
+    return m_nodes[id].value.get();
+  }
+
+  /**
+   * @return whether a value was removed
+   */
+  bool
+  erase(const Name& name)
+  {
+    size_t id = findNode(name);
+    if (id == NONE || m_nodes[id].value == nullptr)
+      return false;
+
+    m_nodes[id].value.reset();
+    --m_size;
+
+    while (id != ROOT && m_nodes[id].value == nullptr && m_nodes[id].firstChild == NONE) {
+      size_t parent = m_nodes[id].parent;
+      removeChild(id);
+      id = parent;
+    }
+    return true;
+  }
+
+  /**
+   * @return number of values
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @return number of nodes in use, including the root and nodes without values
+   */
+  size_t
+  getNNodes() const
+  {
+    return m_nodes.size() - m_freeNodes.size();
+  }
+
+private:
+  static const size_t ROOT = 0;
+  static const size_t NONE = std::numeric_limits<size_t>::max();
+
+  struct Node
+  {
+    name::Component component;
+    size_t parent = NONE;
+    size_t firstChild = NONE;
+    size_t nextSibling = NONE;
+    size_t previousSibling = NONE;
+    /**
+     * @brief the child with the largest component in canonical order
+     */
+    size_t lastChild = NONE;
+    unique_ptr<T> value;
+  };
+
+  static size_t
+  hashChild(size_t parent, const name::Component& component)
+  {
+    size_t hash = boost::hash_range(component.wire(), component.wire() + component.size());
+    boost::hash_combine(hash, parent);
+    return hash;
+  }
+
+  size_t
+  findChild(size_t parent, const name::Component& component) const
+  {
+    auto range = m_children.equal_range(hashChild(parent, component));
+    for (auto it = range.first; it != range.second; ++it) {
+      const Node& node = m_nodes[it->second];
+      if (node.parent == parent && node.component == component)
+        return it->second;
+    }
+    return NONE;
+  }
+
+  size_t
+  findNode(const Name& name) const
+  {
+    size_t id = ROOT;
+    for (auto it = name.begin(); it != name.end() && id != NONE; ++it)
+      id = findChild(id, *it);
+    return id;
+  }
+
+  size_t
+  addChild(size_t parent, const name::Component& component)
+  {
+    size_t id;
+    if (m_freeNodes.empty()) {
+      id = m_nodes.size();
+      m_nodes.emplace_back();
+    }
+    else {
+      id = m_freeNodes.back();
+      m_freeNodes.pop_back();
+    }
+
+    Node& node = m_nodes[id];
+    Node& parentNode = m_nodes[parent];
+    node.component = component;
+    node.parent = parent;
+    node.nextSibling = parentNode.firstChild;
+    if (parentNode.firstChild != NONE)
+      m_nodes[parentNode.firstChild].previousSibling = id;
+    parentNode.firstChild = id;
+    if (parentNode.lastChild == NONE || m_nodes[parentNode.lastChild].component < component)
+      parentNode.lastChild = id;
+
+    m_children.emplace(hashChild(parent, component), id);
+    return id;
+  }
+
+  void
+  removeChild(size_t id)
+  {
+    Node& node = m_nodes[id];
+    Node& parentNode = m_nodes[node.parent];
+
+    auto range = m_children.equal_range(hashChild(node.parent, node.component));
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == id) {
+        m_children.erase(it);
+        break;
+      }
+    }
+
+    if (node.previousSibling != NONE)
+      m_nodes[node.previousSibling].nextSibling = node.nextSibling;
+    else
+      parentNode.firstChild = node.nextSibling;
+    if (node.nextSibling != NONE)
+      m_nodes[node.nextSibling].previousSibling = node.previousSibling;
+
+    if (parentNode.lastChild == id) {
+      parentNode.lastChild = parentNode.firstChild;
+      for (size_t child = parentNode.firstChild; child != NONE;
+           child = m_nodes[child].nextSibling) {
+        if (m_nodes[parentNode.lastChild].component < m_nodes[child].component)
+          parentNode.lastChild = child;
+      }
+    }
+
+    node = Node();
+    m_freeNodes.push_back(id);
+  }
+
+private:
+  std::vector<Node> m_nodes;
+  std::vector<size_t> m_freeNodes;
+  std::unordered_multimap<size_t, size_t> m_children;
+  size_t m_size;
+};
+
+template<typename T>
+const size_t NameTree<T>::ROOT;
+
+template<typename T>
+const size_t NameTree<T>::NONE;
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_NAME_TREE_HPP
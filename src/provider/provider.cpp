@@ -1,8 +1,38 @@
 #include "provider.hpp"
+#include "core/crypto-context.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <ndn-cxx/mgmt/control-response.hpp>
+#include <ndn-cxx/security/command-interest-signer.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <unistd.h>
 
 namespace ndn {
 namespace epac {
 
+const name::Component Provider::USER_FILTER_COMPONENT("USERS");
+const std::chrono::milliseconds Provider::LIVE_FLUSH_DELAY(100);
+const uint64_t Provider::MAX_AWAITED_SEGMENTS = 256;
+const size_t Provider::MAX_LOGGED_USER_CHANGES = 10000;
+
+static std::string
+getErrorMessage(std::exception_ptr e)
+{
+  try {
+    std::rethrow_exception(e);
+  }
+  catch (const std::exception& error) {
+    return error.what();
+  }
+  catch (...) {
+    return "unknown error";
+  }
+}
+
 Provider::Provider(char* programName)
   : m_programName(programName)
   , m_isForceDataSet(false)
@@ -11,75 +41,75 @@ Provider::Provider(char* programName)
   , m_freshnessPeriod(-1)
   , m_timeout(-1)
   , m_isDataSent(false)
+  , m_userTtl(0)
+  , m_scheduler(m_face.getIoService())
+  , m_expiryEvent(m_scheduler)
+  , m_isUserSnapshotPending(false)
+  , m_tokenLifetime(0)
+  , m_userFilterRate(0)
+  , m_userFilterEvent(m_scheduler)
+  , m_nUserFilterChanges(0)
+  , m_isUserFilterPending(false)
+  , m_keyDirectory(".")
+  , m_nThreads(0)
+  , m_backend(&CryptoBackend::getDefault())
+  , m_maxSegmentSize(0)
+  , m_memoryBudget(std::numeric_limits<size_t>::max())
+  , m_isDaemon(false)
+  , m_isLive(false)
+  , m_liveReadBuffer(envelope::DEFAULT_CHUNK_SIZE)
+  , m_isLiveFlushScheduled(false)
+  , m_nLiveSegments(0)
 {
-  AutoSeededRandomPool rng;
-  InvertibleRSAFunction params;
-
-  params.GenerateRandomWithKeySize(rng, 1024);
-
-  privateKey = new RSA::PrivateKey(params);
-  publicKey = new RSA::PublicKey(params);
-
-  saveKey("publicKey.key", *publicKey);
-  saveKey("privateKey.key", *privateKey);
 }
 
 void
-Provider::saveKey(const std::string &filename, const CryptoMaterial &key)
+Provider::loadKeys()
 {
-  ByteQueue queue;
-  key.Save(queue);
+  KeyStore keyStore(m_keyDirectory, *m_backend);
+  keyStore.loadOrGenerate();
 
-  FileSink file(filename.c_str());
-  queue.CopyTo(file);
-  file.MessageEnd();
+  m_publicKey = keyStore.getPublicKey();
+  m_privateKey = keyStore.getPrivateKey();
 }
 
-std::string
-Provider::encrypt(const std::string &payload)
+Buffer
+Provider::decrypt(const Buffer& cipher)
 {
-  std::string cipher;
-  AutoSeededRandomPool rng;
-  RSAES_OAEP_SHA_Encryptor e(*publicKey);
-
-  StringSource ss1(payload, true,
-    new PK_EncryptorFilter(rng, e,
-      new StringSink(cipher)
-    ) // PK_EncryptorFilter
-  ); // StringSource
-
-  return cipher;
-}
-
-std::string
-Provider::decrypt(const std::string &cipher)
-{
-  AutoSeededRandomPool rng;
-  std::string recovered;
-  RSAES_OAEP_SHA_Decryptor d(*privateKey);
-
-  StringSource ss2(cipher, true,
-    new PK_DecryptorFilter(rng, d,
-      new StringSink(recovered)
-    ) // PK_DecryptorFilter
-  ); // StringSource
-
-  return recovered;
+  return envelope::open(cipher.data(), cipher.size(), *m_backend, m_privateKey);
 }
 
 void
-Provider::doRegister(std::string uid, RSA::PublicKey &pubKey)
+Provider::doRegister(const std::string& uid, shared_ptr<const CryptoPP::PublicKey> pubKey,
+                     const CryptoBackend& backend)
 {
-  aut.add(uid, pubKey);
+  aut.add(uid, std::move(pubKey), backend);
 }
 
 void
 Provider::usage()
 {
+  std::string algorithms;
+  for (const auto& name : CryptoBackend::getNames()) {
+    algorithms += (algorithms.empty() ? "" : ", ") + name;
+  }
+
   std::cout << "\n Usage:\n " << m_programName << " "
-    "[-f] [-D] [-i identity] [-F] [-x freshness] [-w timeout] ndn:/name\n"
+    "[-f] [-D] [-i identity] [-F] [-x freshness] [-w timeout] [-k directory] [-j threads] "
+    "[-a algorithm] [-s size] [-m megabytes] [-R directory] [-r policy] [-e ttl] "
+    "[-t lifetime] [-u rate] [-d | -l] "
+    "ndn:/name\n"
     "   Reads payload from stdin and sends it to local NDN forwarder as a "
     "single Data packet\n"
+    "   With -d, serves content under ndn:/name until terminated, reading commands from stdin:\n"
+    "     publish <name> <file> [group] - publish the content of file under name,\n"
+    "                               readable by the members of group if given\n"
+    "     publish-tree <name> <directory> - publish the files under directory, as with -R\n"
+    "     unpublish <name>        - stop serving name\n"
+    "     group-add <group> <user-id> - add a registered user to group, publishing\n"
+    "                               the new keys under ndn:/name/REKEY/<group>\n"
+    "     group-remove <group> <user-id> - remove a user from group\n"
+    "     stats                   - print content store counters\n"
     "   [-f]          - force, send Data without waiting for Interest\n"
     "   [-D]          - use DigestSha256 signing method instead of "
     "SignatureSha256WithRsa\n"
@@ -87,6 +117,26 @@ Provider::usage()
     "   [-F]          - set FinalBlockId to the last component of Name\n"
     "   [-x]          - set FreshnessPeriod in time::milliseconds\n"
     "   [-w timeout]  - set Timeout in time::milliseconds\n"
+    "   [-k directory] - load the key pair and registered users from directory,\n"
+    "                    generating the key pair if absent\n"
+    "   [-j threads]  - number of worker threads, default one per CPU\n"
+    "   [-a algorithm] - key wrapping algorithm (" << algorithms << "), default "
+    << CryptoBackend::getDefault().getName() << "\n"
+    "   [-s size]     - publish <name>/<version>/<segment> Data of at most size payload octets\n"
+    "   [-m megabytes] - keep at most megabytes of Data in memory, spilling the rest to disk\n"
+    "   [-R directory] - publish every file under directory as <name>/<path>/<version>/<segment>,\n"
+    "                   encrypting and signing each segment when it is first requested\n"
+    "   [-r policy]   - register users by command Interests under ndn:/name/REGISTER,\n"
+    "                   validated by the validator configuration in file policy\n"
+    "   [-e ttl]      - users expire after ttl seconds without registration or lookup\n"
+    "   [-t lifetime] - with -r, grant registered users access tokens valid for lifetime\n"
+    "                   seconds, and serve only Interests carrying a valid token\n"
+    "   [-u rate]     - with -d or -l, publish the ids of the users as a cuckoo filter with\n"
+    "                   false positive rate rate under ndn:/name/USERS/<version>/<segment>,\n"
+    "                   and again each second in which users changed\n"
+    "   [-d]          - daemon, serve publications until terminated\n"
+    "   [-l]          - live, publish stdin as <name>/<version>/<segment> while it is read,\n"
+    "                   serving until terminated\n"
     "   [-h]          - print help and exit\n"
     "   [-V]          - print version and exit\n"
     "\n";
@@ -141,46 +191,979 @@ Provider::setPrefixName(char* prefixName)
   m_prefixName = Name(prefixName);
 }
 
+void
+Provider::setKeyDirectory(char* keyDirectory)
+{
+  m_keyDirectory = keyDirectory;
+}
+
+void
+Provider::setThreads(int nThreads)
+{
+  if (nThreads < 0)
+    usage();
+
+  m_nThreads = static_cast<size_t>(nThreads);
+}
+
+void
+Provider::setMaxSegmentSize(int maxSegmentSize)
+{
+  if (maxSegmentSize <= 0)
+    usage();
+
+  m_maxSegmentSize = static_cast<size_t>(maxSegmentSize);
+}
+
+void
+Provider::setMemoryBudget(int megabytes)
+{
+  if (megabytes <= 0)
+    usage();
+
+  m_memoryBudget = static_cast<size_t>(megabytes) * 1024 * 1024;
+}
+
+void
+Provider::setDirectory(char* directory)
+{
+  m_directory = directory;
+}
+
+void
+Provider::setRegistrationPolicy(char* filename)
+{
+  m_registrationPolicy = filename;
+}
+
+void
+Provider::setUserTtl(int ttl)
+{
+  if (ttl <= 0)
+    usage();
+
+  m_userTtl = time::seconds(ttl);
+}
+
+void
+Provider::setTokenLifetime(int lifetime)
+{
+  if (lifetime <= 0)
+    usage();
+
+  m_tokenLifetime = time::seconds(lifetime);
+}
+
+void
+Provider::setUserFilter(char* rate)
+{
+  char* end = nullptr;
+  double falsePositiveRate = std::strtod(rate, &end);
+  if (end == rate || *end != '\0' || !(falsePositiveRate > 0 && falsePositiveRate < 1))
+    usage();
+
+  m_userFilterRate = falsePositiveRate;
+}
+
+void
+Provider::scheduleExpiry()
+{
+  m_expiryEvent = m_scheduler.scheduleEvent(ActiveUserTable::EXPIRY_TICK, [this] {
+      try {
+        aut.expire();
+      }
+      catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+      }
+      checkUserSnapshot();
+      scheduleExpiry();
+    });
+}
+
+void
+Provider::checkUserSnapshot()
+{
+  // a long log would be replayed, key by key, by the next start after a crash
+  if (!m_isUserSnapshotPending &&
+      (aut.isSnapshotStale() || aut.getNLoggedChanges() >= MAX_LOGGED_USER_CHANGES))
+    saveUserSnapshot();
+}
+
+void
+Provider::saveUserSnapshot()
+{
+  // rewriting the snapshot takes time in the number of users, which the Face must not wait for
+  m_isUserSnapshotPending = true;
+  m_workers->dispatch<bool>(m_face.getIoService(),
+    [this] {
+      aut.saveSnapshot();
+      return true;
+    },
+    [this] (bool) {
+      m_isUserSnapshotPending = false;
+    },
+    [this] (std::exception_ptr e) {
+      m_isUserSnapshotPending = false;
+      std::cerr << "ERROR: " << getErrorMessage(e) << std::endl;
+    });
+}
+
+void
+Provider::scheduleUserFilter()
+{
+  m_userFilterEvent = m_scheduler.scheduleEvent(ActiveUserTable::EXPIRY_TICK, [this] {
+      // a filter still being made is published first, so that versions stay in order
+      if (!m_isUserFilterPending && aut.getNFilterChanges() != m_nUserFilterChanges)
+        publishUserFilter();
+      scheduleUserFilter();
+    });
+}
+
+void
+Provider::publishUserFilter()
+{
+  m_nUserFilterChanges = aut.getNFilterChanges();
+  Block filter = aut.exportFilter();
+  Name versionedName = Name(m_prefixName).append(USER_FILTER_COMPONENT)
+                         .appendVersion(time::toUnixTimestamp(time::system_clock::now()).count());
+
+  m_isUserFilterPending = true;
+  m_workers->dispatch<ContentIndex::Publication>(m_face.getIoService(),
+    [this, versionedName, filter] { return makeUserFilterPublication(versionedName, filter); },
+    [this] (const ContentIndex::Publication& publication) {
+      m_isUserFilterPending = false;
+      m_index->insert(publication);
+      if (!m_userFilterName.empty())
+        m_index->erase(m_userFilterName);
+      m_userFilterName = publication.name;
+    },
+    [this] (std::exception_ptr e) {
+      m_isUserFilterPending = false;
+      std::cerr << "ERROR: " << getErrorMessage(e) << std::endl;
+    });
+}
+
+ContentIndex::Publication
+Provider::makeUserFilterPublication(const Name& versionedName, const Block& filter)
+{
+  std::vector<shared_ptr<Data>> segments = splitAndSign(versionedName, filter);
+
+  ContentIndex::Publication publication;
+  publication.name = versionedName;
+  publication.packets.assign(segments.begin(), segments.end());
+  publication.isSegmented = true;
+  return publication;
+}
+
+void
+Provider::setDaemon()
+{
+  m_isDaemon = true;
+}
+
+void
+Provider::setLive()
+{
+  m_isLive = true;
+}
+
+void
+Provider::setAlgorithm(char* algorithm)
+{
+  try {
+    m_backend = &CryptoBackend::get(algorithm);
+  }
+  catch (const CryptoBackend::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    usage();
+  }
+}
+
 time::milliseconds
 Provider::getDefaultTimeout()
 {
   return time::seconds(10);
 }
 
+ContentIndex::Publication
+Provider::publish(const Name& name, std::istream& input)
+{
+  ContentIndex::Publication publication = makePublication(name, input);
+  m_index->insert(publication);
+  return publication;
+}
+
+ContentIndex::Publication
+Provider::makePublication(const Name& name, std::istream& input)
+{
+  Buffer contentKey = envelope::generateContentKey();
+  ContentIndex::Publication publication = sealPublication(name, input, contentKey);
+  if (aut.size() > 0)
+    publication.keyBundle = createKeyBundle(publication.name, contentKey);
+
+  return publication;
+}
+
+ContentIndex::Publication
+Provider::makeGroupPublication(const Name& name, std::istream& input, const Buffer& contentKey,
+                               const KeyWrapBundle::GroupEntry& groupEntry)
+{
+  ContentIndex::Publication publication = sealPublication(name, input, contentKey);
+  publication.keyBundle = createKeyBundle(publication.name, KeyWrapBundle({}, {groupEntry}));
+  return publication;
+}
+
+ContentIndex::Publication
+Provider::sealPublication(const Name& name, std::istream& input, const Buffer& contentKey)
+{
+  ContentIndex::Publication publication;
+  publication.name = name;
+  if (m_maxSegmentSize > 0) {
+    if (publication.name.empty() || !publication.name[-1].isVersion())
+      publication.name.appendVersion();
+
+    std::vector<shared_ptr<Data>> segments = createSegments(publication.name, input, contentKey);
+    publication.packets.assign(segments.begin(), segments.end());
+    publication.isSegmented = true;
+  }
+  else {
+    publication.packets.push_back(createDataPacket(publication.name, input, contentKey));
+  }
+
+  return publication;
+}
+
+size_t
+Provider::publishDirectory(const Name& prefix, const std::string& directory)
+{
+  namespace fs = boost::filesystem;
+
+  size_t segmentSize = m_maxSegmentSize > 0 ? m_maxSegmentSize : Segmenter::DEFAULT_SEGMENT_SIZE;
+  fs::path root = fs::canonical(directory);
+  auto rootDepth = std::distance(root.begin(), root.end());
+
+  size_t nFiles = 0;
+  for (fs::recursive_directory_iterator it(root), end; it != end; ++it) {
+    const fs::path& path = it->path();
+    if (!fs::is_regular_file(it->status()))
+      continue;
+
+    Name name = prefix;
+    auto element = path.begin();
+    std::advance(element, rootDepth);
+    for (; element != path.end(); ++element)
+      name.append(element->string());
+    name.appendVersion(static_cast<uint64_t>(fs::last_write_time(path)) * 1000);
+
+    auto file = make_shared<FilePublication>(path.string(), fs::file_size(path), name,
+                                             segmentSize, *m_backend, m_publicKey);
+    m_index->insert(name, file->getNSegments(),
+                    [this, file] () -> std::vector<shared_ptr<const Data>> {
+                      if (aut.size() == 0)
+                        return {};
+                      return createKeyBundle(file->getName(), file->getContentKey());
+                    },
+                    bind(&Provider::makeFilePacket, this, file, _1));
+    ++nFiles;
+  }
+  return nFiles;
+}
+
+shared_ptr<const Data>
+Provider::makeFilePacket(const shared_ptr<FilePublication>& file, const Name& dataName)
+{
+  try {
+    shared_ptr<Data> segment = file->makeSegment(dataName[-1].toSegment());
+    if (m_freshnessPeriod >= time::milliseconds::zero())
+      segment->setFreshnessPeriod(m_freshnessPeriod);
+    sign(*segment);
+    return segment;
+  }
+  catch (const FilePublication::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return nullptr;
+  }
+}
+
 shared_ptr<Data>
-Provider::createDataPacket()
+Provider::createDataPacket(const Name& name, std::istream& input, const Buffer& contentKey)
 {
-  auto dataPacket = make_shared<Data>(m_prefixName);
+  auto dataPacket = make_shared<Data>(name);
 
-  std::stringstream payloadStream;
-  payloadStream << std::cin.rdbuf();
-  std::string payloadPlain = payloadStream.str();
-  std::string payload = encrypt(payloadPlain);
-  dataPacket->setContent(reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length());
+  dataPacket->setContent(envelope::sealStream(input, contentKey, *m_backend, m_publicKey));
 
   if (m_freshnessPeriod >= time::milliseconds::zero())
     dataPacket->setFreshnessPeriod(m_freshnessPeriod);
 
   if (m_isLastAsFinalBlockIdSet) {
-    if (!m_prefixName.empty())
-      dataPacket->setFinalBlockId(m_prefixName.get(-1));
+    if (!name.empty())
+      dataPacket->setFinalBlockId(name.get(-1));
     else {
       std::cerr << "Name Provided Has 0 Components" << std::endl;
       exit(1);
     }
   }
 
+  sign(*dataPacket);
   return dataPacket;
 }
 
+std::vector<shared_ptr<Data>>
+Provider::createSegments(const Name& versionedName, std::istream& input,
+                         const Buffer& contentKey)
+{
+  envelope::Sealer sealer(contentKey, *m_backend, m_publicKey);
+  Segmenter segmenter(sealer, m_maxSegmentSize);
+  std::vector<shared_ptr<Data>> segments = segmenter.segment(versionedName, input);
+
+  if (m_freshnessPeriod >= time::milliseconds::zero()) {
+    for (const auto& segment : segments)
+      segment->setFreshnessPeriod(m_freshnessPeriod);
+  }
+  m_signer->signAll(segments);
+
+  return segments;
+}
+
+void
+Provider::sign(Data& data)
+{
+  m_signer->sign(data);
+}
+
+std::vector<shared_ptr<const Data>>
+Provider::createKeyBundle(const Name& contentName, const Buffer& contentKey)
+{
+  KeyWrapper wrapper(*m_workers);
+  return createKeyBundle(contentName, wrapper.wrapForAll(contentKey, aut));
+}
+
+std::vector<shared_ptr<const Data>>
+Provider::createKeyBundle(const Name& contentName, const KeyWrapBundle& bundle)
+{
+  Name versionedName = Name(contentName).append(ContentIndex::KEY_BUNDLE_COMPONENT)
+                                        .appendVersion();
+  std::vector<shared_ptr<Data>> segments = splitAndSign(versionedName, bundle.wireEncode());
+  return std::vector<shared_ptr<const Data>>(segments.begin(), segments.end());
+}
+
+std::vector<shared_ptr<Data>>
+Provider::splitAndSign(const Name& versionedName, const Block& wire)
+{
+  size_t segmentSize = m_maxSegmentSize > 0 ? m_maxSegmentSize : Segmenter::DEFAULT_SEGMENT_SIZE;
+  std::vector<shared_ptr<Data>> segments = Segmenter::split(versionedName, wire, segmentSize);
+
+  if (m_freshnessPeriod >= time::milliseconds::zero()) {
+    for (const auto& segment : segments)
+      segment->setFreshnessPeriod(m_freshnessPeriod);
+  }
+  m_signer->signAll(segments);
+
+  return segments;
+}
+
 void
 Provider::onInterest(const Name& name,
-           const Interest& interest,
-           shared_ptr<Data> dataPacket)
+           const Interest& interest)
 {
-  m_face.put(*dataPacket);
-  m_isDataSent = true;
-  // m_face.shutdown();
+  if (name.size() > m_prefixName.size() &&
+      name[m_prefixName.size()] == Registration::COMMAND_COMPONENT) {
+    onRegistrationInterest(interest);
+    return;
+  }
+
+  if (m_tokenVerifier != nullptr && !isAuthorized(interest))
+    return;
+
+  ContentIndex::Match match = m_index->match(interest);
+  if (match.data != nullptr) {
+    m_face.put(*match.data);
+    m_isDataSent = true;
+    return;
+  }
+
+  if (match.keyBundleFactory != nullptr) {
+    makeKeyBundle(match, interest);
+    return;
+  }
+
+  if (match.factory == nullptr) {
+    awaitLiveSegment(interest);
+    return;
+  }
+
+  // Interests for a packet that is already being made wait for the same result
+  if (!m_inFlight.add(match.dataName, interest))
+    return;
+
+  m_workers->dispatch<shared_ptr<const Data>>(m_face.getIoService(),
+    bind(match.factory, match.dataName),
+    bind(&Provider::onPacketMade, this, match, _1),
+    [this, match] (std::exception_ptr e) {
+      std::cerr << "ERROR: " << getErrorMessage(e) << std::endl;
+      m_inFlight.remove(match.dataName);
+    });
+}
+
+void
+Provider::onPacketMade(const ContentIndex::Match& match, const shared_ptr<const Data>& data)
+{
+  std::vector<Interest> interests = m_inFlight.remove(match.dataName);
+  if (data == nullptr)
+    return;
+
+  m_index->cache(match, data);
+
+  // one put satisfies every pending Interest the packet matches
+  bool isMatched = std::any_of(interests.begin(), interests.end(),
+                               [&data] (const Interest& interest) {
+                                 return interest.matchesData(*data);
+                               });
+  if (isMatched) {
+    m_face.put(*data);
+    m_isDataSent = true;
+  }
+}
+
+void
+Provider::makeKeyBundle(const ContentIndex::Match& match, const Interest& interest)
+{
+  if (!m_inFlight.add(match.dataName, interest))
+    return;
+
+  m_workers->dispatch<std::vector<shared_ptr<const Data>>>(m_face.getIoService(),
+    match.keyBundleFactory,
+    bind(&Provider::onKeyBundleMade, this, match, _1),
+    [this, match] (std::exception_ptr e) {
+      std::cerr << "ERROR: " << getErrorMessage(e) << std::endl;
+      m_inFlight.remove(match.dataName);
+    });
+}
+
+void
+Provider::onKeyBundleMade(const ContentIndex::Match& match,
+                          const std::vector<shared_ptr<const Data>>& keyBundle)
+{
+  std::vector<Interest> interests = m_inFlight.remove(match.dataName);
+  if (keyBundle.empty()) {
+    // the pending Interests all name <name>/KEYS, so one Nack answers them
+    Data nack(match.dataName);
+    nack.setContentType(ndn::tlv::ContentType_Nack);
+    nack.setFreshnessPeriod(time::milliseconds::zero());
+    sign(nack);
+    m_face.put(nack);
+    m_isDataSent = true;
+    return;
+  }
+
+  if (!m_index->cacheKeyBundle(match, keyBundle))
+    return;
+
+  // the Interests name the bundle without version, so its first segment answers them
+  const Data& first = *keyBundle.front();
+  bool isMatched = std::any_of(interests.begin(), interests.end(),
+                               [&first] (const Interest& interest) {
+                                 return interest.matchesData(first);
+                               });
+  if (isMatched) {
+    m_face.put(first);
+    m_isDataSent = true;
+  }
+}
+
+void
+Provider::onRegistrationInterest(const Interest& interest)
+{
+  if (m_registrationValidator == nullptr) {
+    putControlResponse(interest, 403, "Registration is disabled");
+    return;
+  }
+
+  m_registrationValidator->validate(interest,
+    bind(&Provider::onRegistrationValidated, this, _1),
+    [this] (const Interest& interest, const security::v2::ValidationError& error) {
+      putControlResponse(interest, 403, error.getInfo());
+    });
+}
+
+void
+Provider::onRegistrationValidated(const Interest& interest)
+{
+  // <prefix>/REGISTER/<Registration>, followed by the components of a command Interest
+  const Name& name = interest.getName();
+  if (name.size() != m_prefixName.size() + 2 + command_interest::MIN_SIZE) {
+    putControlResponse(interest, 400, "Malformed registration command");
+    return;
+  }
+
+  // keys are decoded and checked on a worker thread; users are added all at once
+  m_workers->dispatch<std::vector<Registrant>>(m_face.getIoService(),
+    bind(&Provider::decodeRegistration, name[m_prefixName.size() + 1]),
+    [this, interest] (const std::vector<Registrant>& registrants) {
+      try {
+        for (const auto& registrant : registrants)
+          doRegister(registrant.userId, registrant.publicKey, *registrant.backend);
+      }
+      catch (const std::exception& e) {
+        putControlResponse(interest, 500, e.what());
+        return;
+      }
+      checkUserSnapshot();
+      std::string text = "Registered " + std::to_string(registrants.size()) + " users";
+      if (m_tokenVerifier == nullptr) {
+        putControlResponse(interest, 200, text);
+        return;
+      }
+
+      // tokens are issued here, where the verifier lives; wrapping them is left to the worker
+      std::vector<AccessToken> tokens;
+      tokens.reserve(registrants.size());
+      for (const auto& registrant : registrants)
+        tokens.push_back(m_tokenVerifier->issue(registrant.userId));
+      putControlResponse(interest, 200, text, [registrants, tokens] {
+          Block grants(tlv::TokenGrants);
+          for (size_t i = 0; i < tokens.size(); ++i)
+            grants.push_back(tokens[i].wrap(*registrants[i].backend, registrants[i].publicKey));
+          grants.encode();
+          return grants;
+        });
+    },
+    [this, interest] (std::exception_ptr e) {
+      putControlResponse(interest, 400, getErrorMessage(e));
+    });
+}
+
+std::vector<Provider::Registrant>
+Provider::decodeRegistration(const name::Component& command)
+{
+  Registration registration(command.blockFromValue());
+
+  std::vector<Registrant> registrants;
+  registrants.reserve(registration.size());
+  for (const auto& entry : registration.getEntries()) {
+    const CryptoBackend& backend = CryptoBackend::get(entry.algorithm);
+    shared_ptr<CryptoPP::PublicKey> publicKey = backend.createPublicKey();
+
+    CryptoPP::ByteQueue queue;
+    queue.Put(entry.publicKey.data(), entry.publicKey.size());
+    queue.MessageEnd();
+    publicKey->Load(queue);
+    if (!publicKey->Validate(CryptoContext::get().getRng(), 2)) {
+      BOOST_THROW_EXCEPTION(Registration::Error("Invalid key of user " + entry.userId));
+    }
+
+    registrants.push_back({entry.userId, std::move(publicKey), &backend});
+  }
+  return registrants;
+}
+
+void
+Provider::putControlResponse(const Interest& interest, uint32_t code, const std::string& text,
+                             const std::function<Block()>& makeBody)
+{
+  auto response = make_shared<Data>(interest.getName());
+
+  m_workers->dispatch<shared_ptr<const Data>>(m_face.getIoService(),
+    [this, response, code, text, makeBody] () -> shared_ptr<const Data> {
+      mgmt::ControlResponse controlResponse(code, text);
+      if (makeBody != nullptr)
+        controlResponse.setBody(makeBody());
+      response->setContent(controlResponse.wireEncode());
+      sign(*response);
+      return response;
+    },
+    [this] (const shared_ptr<const Data>& data) {
+      m_face.put(*data);
+    },
+    [] (std::exception_ptr e) {
+      std::cerr << "ERROR: " << getErrorMessage(e) << std::endl;
+    });
+}
+
+bool
+Provider::isAuthorized(const Interest& interest)
+{
+  if (!interest.hasParameters())
+    return false;
+
+  try {
+    AccessToken token(interest.getParameters());
+    // a user that was removed or expired loses access before its token expires
+    return m_tokenVerifier->verify(token) && aut.find(token.getUserId()) != nullptr;
+  }
+  catch (const AccessToken::Error&) {
+    return false;
+  }
+  catch (const UserSnapshot::Error& e) {
+    // the user's record in the snapshot cannot be decoded; other users are still served
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return false;
+  }
+}
+
+void
+Provider::changeGroup(const std::string& groupId, const std::string& userId, bool isAdded)
+{
+  auto group = m_groups.find(groupId);
+  RekeyMessage message;
+  if (isAdded) {
+    shared_ptr<const ActiveUserTable::User> user = aut.find(userId);
+    if (user == nullptr) {
+      std::cout << "ERROR " << userId << " is not registered" << std::endl;
+      return;
+    }
+
+    if (group == m_groups.end()) {
+      // epochs continue from the current time, so keys of a restarted provider are newer
+      uint64_t epoch = time::toUnixTimestamp(time::system_clock::now()).count();
+      group = m_groups.emplace(groupId, make_unique<AccessGroup>(groupId, epoch)).first;
+    }
+    message = group->second->add(userId, *user->backend, user->publicKey);
+  }
+  else {
+    if (group == m_groups.end()) {
+      std::cout << "ERROR no group " << groupId << std::endl;
+      return;
+    }
+    message = group->second->remove(userId);
+  }
+
+  Name rekeyName = publishRekey(*group->second, message);
+  std::cout << "OK " << rekeyName << " " << group->second->size() << std::endl;
+}
+
+Name
+Provider::publishRekey(const AccessGroup& group, const RekeyMessage& message)
+{
+  auto rekeyPacket = make_shared<Data>(RekeyMessage::getName(m_prefixName, group.getId(),
+                                                             message.getEpoch()));
+  rekeyPacket->setContent(message.wireEncode());
+
+  if (m_freshnessPeriod >= time::milliseconds::zero())
+    rekeyPacket->setFreshnessPeriod(m_freshnessPeriod);
+
+  sign(*rekeyPacket);
+
+  ContentIndex::Publication publication;
+  publication.name = rekeyPacket->getName();
+  publication.packets.push_back(rekeyPacket);
+  m_index->insert(publication);
+  return publication.name;
+}
+
+void
+Provider::processCommand(const std::string& line)
+{
+  std::istringstream is(line);
+  std::string command;
+  std::string uri;
+  is >> command >> uri;
+  if (command.empty())
+    return;
+
+  if (command == "stats") {
+    const ContentStore::Counters& counters = m_store->getCounters();
+    std::cout << "OK publications=" << m_index->size()
+              << " packets=" << m_store->size()
+              << " memory=" << m_store->getMemoryBytes()
+              << " spilled=" << m_store->getSpilledBytes()
+              << " spill-free=" << m_store->getFreeSpillBytes()
+              << " hits=" << counters.nHits
+              << " spill-hits=" << counters.nSpillHits
+              << " misses=" << counters.nMisses
+              << " evictions=" << counters.nEvictions
+              << " in-flight=" << m_inFlight.size()
+              << " coalesced=" << m_inFlight.getNCoalesced();
+    if (m_tokenVerifier != nullptr)
+      std::cout << " token-hits=" << m_tokenVerifier->getNCacheHits()
+                << " token-rejected=" << m_tokenVerifier->getNRejected();
+    std::cout << std::endl;
+    return;
+  }
+
+  if (command == "group-add" || command == "group-remove") {
+    std::string userId;
+    is >> userId;
+    if (uri.empty() || userId.empty()) {
+      std::cout << "ERROR missing group or user" << std::endl;
+      return;
+    }
+
+    changeGroup(uri, userId, command == "group-add");
+    return;
+  }
+
+  if (uri.empty()) {
+    std::cout << "ERROR missing name" << std::endl;
+    return;
+  }
+  Name name(uri);
+  if (!m_prefixName.isPrefixOf(name)) {
+    std::cout << "ERROR " << name << " is not under " << m_prefixName << std::endl;
+    return;
+  }
+
+  if (command == "publish") {
+    std::string filename;
+    std::string groupId;
+    is >> filename >> groupId;
+    auto file = make_shared<std::ifstream>(filename, std::ios::binary);
+    if (filename.empty() || !*file) {
+      std::cout << "ERROR cannot open '" << filename << "'" << std::endl;
+      return;
+    }
+
+    std::function<ContentIndex::Publication()> make =
+      [this, name, file] { return makePublication(name, *file); };
+    if (!groupId.empty()) {
+      auto group = m_groups.find(groupId);
+      if (group == m_groups.end() || group->second->size() == 0) {
+        std::cout << "ERROR group " << groupId << " has no members" << std::endl;
+        return;
+      }
+
+      // the group key is read here, as the group may change while the content is sealed
+      Buffer contentKey = envelope::generateContentKey();
+      KeyWrapBundle::GroupEntry groupEntry = group->second->wrap(contentKey);
+      make = [this, name, file, contentKey, groupEntry] {
+        return makeGroupPublication(name, *file, contentKey, groupEntry);
+      };
+    }
+
+    m_workers->dispatch<ContentIndex::Publication>(m_face.getIoService(),
+      make,
+      [this] (const ContentIndex::Publication& publication) {
+        m_index->insert(publication);
+        std::cout << "OK " << publication.name << " " << publication.packets.size() << std::endl;
+      },
+      [] (std::exception_ptr e) {
+        std::cout << "ERROR " << getErrorMessage(e) << std::endl;
+      });
+  }
+  else if (command == "publish-tree") {
+    std::string directory;
+    is >> directory;
+    if (directory.empty()) {
+      std::cout << "ERROR missing directory" << std::endl;
+      return;
+    }
+
+    size_t nFiles = publishDirectory(name, directory);
+    std::cout << "OK " << name << " " << nFiles << std::endl;
+  }
+  else if (command == "unpublish") {
+    if (m_index->erase(name))
+      std::cout << "OK " << name << std::endl;
+    else
+      std::cout << "ERROR " << name << " is not published" << std::endl;
+  }
+  else {
+    std::cout << "ERROR unknown command '" << command << "'" << std::endl;
+  }
+}
+
+void
+Provider::startReadingCommands()
+{
+  m_commandInput.reset(new boost::asio::posix::stream_descriptor(m_face.getIoService()));
+  try {
+    m_commandInput->assign(::dup(STDIN_FILENO));
+  }
+  catch (const boost::system::system_error&) {
+    // regular files cannot be watched for readiness: execute them up front
+    m_commandInput.reset();
+    std::string line;
+    while (std::getline(std::cin, line)) {
+      try {
+        processCommand(line);
+      }
+      catch (const std::exception& e) {
+        std::cout << "ERROR " << e.what() << std::endl;
+      }
+    }
+    return;
+  }
+
+  readCommands();
+}
+
+void
+Provider::readCommands()
+{
+  boost::asio::async_read_until(*m_commandInput, m_commandBuffer, '\n',
+    [this] (const boost::system::error_code& error, size_t) {
+      if (error && m_commandBuffer.size() == 0) {
+        // keep serving after the end of the command stream
+        if (error != boost::asio::error::eof && error != boost::asio::error::operation_aborted)
+          std::cerr << "ERROR: cannot read commands: " << error.message() << std::endl;
+        return;
+      }
+
+      std::istream is(&m_commandBuffer);
+      std::string line;
+      std::getline(is, line);
+      try {
+        processCommand(line);
+      }
+      catch (const std::exception& e) {
+        std::cout << "ERROR " << e.what() << std::endl;
+      }
+
+      readCommands();
+    });
+}
+
+void
+Provider::startLive(const Name& name)
+{
+  Name versionedName = name;
+  if (versionedName.empty() || !versionedName[-1].isVersion())
+    versionedName.appendVersion();
+
+  Buffer contentKey = envelope::generateContentKey();
+  size_t segmentSize = m_maxSegmentSize > 0 ? m_maxSegmentSize : Segmenter::DEFAULT_SEGMENT_SIZE;
+  m_liveSealer.reset(new envelope::Sealer(contentKey, *m_backend, m_publicKey));
+  m_liveStream.reset(new LiveStream(*m_liveSealer, versionedName, segmentSize));
+
+  std::vector<shared_ptr<const Data>> keyBundle;
+  if (aut.size() > 0)
+    keyBundle = createKeyBundle(versionedName, contentKey);
+  m_index->insertLive(versionedName, keyBundle);
+
+  m_liveFlushTimer.reset(new boost::asio::steady_timer(m_face.getIoService()));
+  m_liveInput.reset(new boost::asio::posix::stream_descriptor(m_face.getIoService()));
+  try {
+    m_liveInput->assign(::dup(STDIN_FILENO));
+  }
+  catch (const boost::system::system_error&) {
+    // regular files cannot be watched for readiness, and are complete anyway
+    m_liveInput.reset();
+    char* buffer = reinterpret_cast<char*>(m_liveReadBuffer.data());
+    while (std::cin.read(buffer, m_liveReadBuffer.size()) || std::cin.gcount() > 0) {
+      makeLiveSegments(m_liveStream->write(m_liveReadBuffer.data(),
+                                           static_cast<size_t>(std::cin.gcount())));
+    }
+    makeLiveSegments({m_liveStream->close()});
+    return;
+  }
+
+  readLive();
+}
+
+void
+Provider::readLive()
+{
+  m_liveInput->async_read_some(boost::asio::buffer(m_liveReadBuffer.data(),
+                                                   m_liveReadBuffer.size()),
+    [this] (const boost::system::error_code& error, size_t nRead) {
+      if (error == boost::asio::error::operation_aborted)
+        return;
+
+      if (nRead > 0) {
+        makeLiveSegments(m_liveStream->write(m_liveReadBuffer.data(), nRead));
+        scheduleLiveFlush();
+      }
+
+      if (error) {
+        if (error != boost::asio::error::eof)
+          std::cerr << "ERROR: cannot read stdin: " << error.message() << std::endl;
+
+        // only the last segment carries FinalBlockId
+        m_liveFlushTimer->cancel();
+        makeLiveSegments({m_liveStream->close()});
+        return;
+      }
+
+      readLive();
+    });
+}
+
+void
+Provider::scheduleLiveFlush()
+{
+  // the first octet waiting for a segment is published at most LIVE_FLUSH_DELAY later
+  if (m_isLiveFlushScheduled || m_liveStream->getPendingSize() == 0)
+    return;
+
+  m_isLiveFlushScheduled = true;
+  m_liveFlushTimer->expires_from_now(LIVE_FLUSH_DELAY);
+  m_liveFlushTimer->async_wait([this] (const boost::system::error_code& error) {
+      m_isLiveFlushScheduled = false;
+      if (error || m_liveStream->isClosed())
+        return;
+      makeLiveSegments(m_liveStream->flush());
+    });
+}
+
+void
+Provider::makeLiveSegments(const std::vector<LiveStream::Piece>& pieces)
+{
+  for (const auto& piece : pieces) {
+    m_workers->dispatch<shared_ptr<const Data>>(m_face.getIoService(),
+      [this, piece] () -> shared_ptr<const Data> {
+        shared_ptr<Data> segment = m_liveStream->makeSegment(piece);
+        if (m_freshnessPeriod >= time::milliseconds::zero())
+          segment->setFreshnessPeriod(m_freshnessPeriod);
+        sign(*segment);
+        return segment;
+      },
+      bind(&Provider::onLiveSegmentMade, this, piece, _1),
+      [] (std::exception_ptr e) {
+        std::cerr << "ERROR: " << getErrorMessage(e) << std::endl;
+      });
+  }
+}
+
+void
+Provider::onLiveSegmentMade(const LiveStream::Piece& piece, const shared_ptr<const Data>& segment)
+{
+  // segments are made concurrently, but appended in order
+  m_liveReadySegments[piece.segmentNo] = std::make_pair(segment, piece.isLast);
+
+  for (auto it = m_liveReadySegments.begin();
+       it != m_liveReadySegments.end() && it->first == m_nLiveSegments;
+       it = m_liveReadySegments.erase(it)) {
+    const shared_ptr<const Data>& data = it->second.first;
+    bool isLast = it->second.second;
+    m_index->appendSegment(m_liveStream->getName(), data, isLast);
+    ++m_nLiveSegments;
+
+    std::vector<Interest> interests = m_awaitedSegments.remove(data->getName());
+    bool isMatched = std::any_of(interests.begin(), interests.end(),
+                                 [&data] (const Interest& interest) {
+                                   return interest.matchesData(*data);
+                                 });
+    if (isMatched) {
+      m_face.put(*data);
+      m_isDataSent = true;
+    }
+
+    // Interests beyond the last segment are never answered
+    if (isLast)
+      m_awaitedSegments.clear();
+  }
+}
+
+bool
+Provider::awaitLiveSegment(const Interest& interest)
+{
+  if (m_liveStream == nullptr)
+    return false;
+
+  const Name& name = interest.getName();
+  const Name& streamName = m_liveStream->getName();
+  if (name.size() != streamName.size() + 1 || !streamName.isPrefixOf(name) ||
+      !name[-1].isSegment())
+    return false;
+
+  uint64_t segmentNo = name[-1].toSegment();
+  bool isBeyondEnd = m_liveStream->isClosed() && segmentNo >= m_liveStream->getNPieces();
+  if (segmentNo < m_nLiveSegments || isBeyondEnd ||
+      segmentNo >= m_nLiveSegments + MAX_AWAITED_SEGMENTS)
+    return false;
+
+  m_awaitedSegments.add(name, interest);
+  return true;
 }
 
 void
@@ -193,15 +1176,87 @@ Provider::onRegisterFailed(const Name& prefix, const std::string& reason)
 void
 Provider::run()
 {
+  // without registration, no user could get a token
+  if (m_tokenLifetime > time::seconds::zero() && m_registrationPolicy.empty())
+    usage();
+
   try {
-    shared_ptr<Data> dataPacket = createDataPacket();
-    if (m_isForceDataSet) {
-      m_face.put(*dataPacket);
+    loadKeys();
+    aut.setTtl(m_userTtl);
+    aut.setFilterRate(m_userFilterRate);
+    aut.open(m_keyDirectory);
+    if (m_userTtl > time::seconds::zero())
+      scheduleExpiry();
+    m_workers.reset(new WorkerPool(m_nThreads));
+
+    security::SigningInfo signingInfo;
+    if (m_isUseDigestSha256Set)
+      signingInfo = security::signingWithSha256();
+    else if (m_identityName != nullptr)
+      signingInfo = security::signingByIdentity(*m_identityName);
+    m_signer.reset(new Signer(*m_workers, signingInfo));
+
+    m_store.reset(new ContentStore(m_memoryBudget,
+                                   boost::filesystem::temp_directory_path().string()));
+    m_index.reset(new ContentIndex(*m_store));
+
+    if (!m_registrationPolicy.empty()) {
+      m_registrationValidator.reset(new security::ValidatorConfig(m_face));
+      m_registrationValidator->load(m_registrationPolicy);
+    }
+    if (m_tokenLifetime > time::seconds::zero())
+      m_tokenVerifier.reset(new TokenVerifier(m_tokenLifetime));
+
+    if (!m_directory.empty())
+      publishDirectory(m_prefixName, m_directory);
+
+    if (m_isDaemon || m_isLive) {
+      if (m_userFilterRate > 0) {
+        publishUserFilter();
+        scheduleUserFilter();
+      }
+
+      m_face.setInterestFilter(m_prefixName,
+                               bind(&Provider::onInterest, this, _1, _2),
+                               RegisterPrefixSuccessCallback(),
+                               bind(&Provider::onRegisterFailed, this, _1, _2));
+
+      m_terminationSignals.reset(new boost::asio::signal_set(m_face.getIoService(),
+                                                             SIGINT, SIGTERM));
+      m_terminationSignals->async_wait([this] (const boost::system::error_code& error, int) {
+          if (error)
+            return;
+          m_face.shutdown();
+          m_face.getIoService().stop();
+        });
+
+      if (m_isDaemon)
+        startReadingCommands();
+      else
+        startLive(m_prefixName);
+      m_face.processEvents(time::milliseconds::zero(), true);
+
+      // the next start maps the snapshot instead of replaying the log
+      if (aut.getNLoggedChanges() > 0 || aut.isSnapshotStale())
+        aut.saveSnapshot();
+      return;
+    }
+
+    ContentIndex::Publication publication;
+    if (m_directory.empty())
+      publication = publish(m_prefixName, std::cin);
+
+    // packets of a directory are made on request, so there is nothing to force out
+    if (m_isForceDataSet && m_directory.empty()) {
+      for (const auto& packet : publication.packets)
+        m_face.put(*packet);
+      for (const auto& packet : publication.keyBundle)
+        m_face.put(*packet);
       m_isDataSent = true;
     }
     else {
       m_face.setInterestFilter(m_prefixName,
-                               bind(&Provider::onInterest, this, _1, _2, dataPacket),
+                               bind(&Provider::onInterest, this, _1, _2),
                                RegisterPrefixSuccessCallback(),
                                bind(&Provider::onRegisterFailed, this, _1, _2));
     }
@@ -228,7 +1283,7 @@ main(int argc, char* argv[])
 {
   int option;
   Provider program(argv[0]);
-  while ((option = getopt(argc, argv, "hfDi:Fx:w:V")) != -1) {
+  while ((option = getopt(argc, argv, "hfDi:Fx:w:k:j:a:s:m:R:r:e:t:u:dlV")) != -1) {
     switch (option) {
     case 'h':
       program.usage();
@@ -251,6 +1306,42 @@ main(int argc, char* argv[])
     case 'w':
       program.setTimeout(atoi(optarg));
       break;
+    case 'k':
+      program.setKeyDirectory(optarg);
+      break;
+    case 'j':
+      program.setThreads(atoi(optarg));
+      break;
+    case 'a':
+      program.setAlgorithm(optarg);
+      break;
+    case 's':
+      program.setMaxSegmentSize(atoi(optarg));
+      break;
+    case 'm':
+      program.setMemoryBudget(atoi(optarg));
+      break;
+    case 'R':
+      program.setDirectory(optarg);
+      break;
+    case 'r':
+      program.setRegistrationPolicy(optarg);
+      break;
+    case 'e':
+      program.setUserTtl(atoi(optarg));
+      break;
+    case 't':
+      program.setTokenLifetime(atoi(optarg));
+      break;
+    case 'u':
+      program.setUserFilter(optarg);
+      break;
+    case 'd':
+      program.setDaemon();
+      break;
+    case 'l':
+      program.setLive();
+      break;
     case 'V':
       std::cout << "ndnpoke " << tools::VERSION << std::endl;
       return 0;
@@ -260,6 +1351,10 @@ main(int argc, char* argv[])
     }
   }
 
+  // both read stdin
+  if (program.isDaemon() && program.isLive())
+    program.usage();
+
   argc -= optind;
   argv += optind;
 
@@ -269,7 +1364,7 @@ main(int argc, char* argv[])
   program.setPrefixName(argv[0]);
   program.run();
 
-  if (program.isDataSent())
+  if (program.isDataSent() || program.isDaemon() || program.isLive())
     return 0;
   else
     return 1;
@@ -3,7 +3,23 @@
 
 #include "core/version.hpp"
 #include "core/common.hpp"
+#include "core/envelope.hpp"
+#include "core/key-store.hpp"
+#include "core/registration.hpp"
+#include "core/worker-pool.hpp"
+#include "access-group.hpp"
 #include "active-user-table.hpp"
+#include "content-index.hpp"
+#include "file-publication.hpp"
+#include "in-flight-table.hpp"
+#include "live-stream.hpp"
+#include "key-wrapper.hpp"
+#include "segmenter.hpp"
+#include "signer.hpp"
+#include "token-verifier.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <ndn-cxx/security/validator-config.hpp>
 
 using namespace CryptoPP;
 
@@ -40,16 +56,233 @@ public:
   void
   setPrefixName(char* prefixName);
 
+  void
+  setKeyDirectory(char* keyDirectory);
+
+  void
+  setThreads(int nThreads);
+
+  /**
+   * @brief select the CryptoBackend used to wrap content keys, by name
+   */
+  void
+  setAlgorithm(char* algorithm);
+
+  /**
+   * @brief publish segments of at most @p maxSegmentSize payload octets under
+   *        <prefix>/<version>/<segment> instead of a single Data packet
+   */
+  void
+  setMaxSegmentSize(int maxSegmentSize);
+
+  /**
+   * @brief keep at most @p megabytes of packets in memory, spilling the rest to disk
+   */
+  void
+  setMemoryBudget(int megabytes);
+
+  /**
+   * @brief publish the files under @p directory instead of stdin
+   */
+  void
+  setDirectory(char* directory);
+
+  /**
+   * @brief accept commands registering users under <prefix>/REGISTER, if they are signed
+   *        as the validator configuration in @p filename requires
+   */
+  void
+  setRegistrationPolicy(char* filename);
+
+  /**
+   * @brief let registered users expire after @p ttl seconds without registration or lookup
+   */
+  void
+  setUserTtl(int ttl);
+
+  /**
+   * @brief grant registered users access tokens valid for @p lifetime seconds, and answer
+   *        only Interests that carry a valid token of a registered user
+   */
+  void
+  setTokenLifetime(int lifetime);
+
+  /**
+   * @brief publish the ids of the users as a filter with false positive rate @p rate under
+   *        <prefix>/USERS/<version>, and again whenever users change
+   */
+  void
+  setUserFilter(char* rate);
+
+  /**
+   * @brief serve until terminated, publishing content as commands read from stdin request
+   */
+  void
+  setDaemon();
+
+  bool
+  isDaemon() const
+  {
+    return m_isDaemon;
+  }
+
+  /**
+   * @brief publish stdin as a live stream, serving each segment as soon as its input arrives
+   */
+  void
+  setLive();
+
+  bool
+  isLive() const
+  {
+    return m_isLive;
+  }
+
+  /**
+   * @brief load the key pair from the key directory, generating it only when absent
+   * @note Called by run(), so that parsing arguments (-h, -V) never touches keys
+   */
+  void
+  loadKeys();
+
   time::milliseconds
   getDefaultTimeout();
 
+  /**
+   * @brief encrypt and sign @p input, and add it to the content index under @p name
+   *
+   * With -s, the content is published as segments under <name>/<version>, where the version
+   * is taken from @p name if its last component is a version, and from the current time
+   * otherwise. A KeyWrapBundle is published along if there are active users.
+   * An earlier publication under the same name is replaced.
+   */
+  ContentIndex::Publication
+  publish(const Name& name, std::istream& input);
+
+  /**
+   * @brief encrypt and sign @p input like publish, without adding it to the content index
+   * @note may be called from a worker thread
+   */
+  ContentIndex::Publication
+  makePublication(const Name& name, std::istream& input);
+
+  /**
+   * @brief encrypt and sign @p input like makePublication, under @p contentKey, whose key
+   *        bundle carries only @p groupEntry, the content key wrapped for an access group
+   * @note may be called from a worker thread
+   */
+  ContentIndex::Publication
+  makeGroupPublication(const Name& name, std::istream& input, const Buffer& contentKey,
+                       const KeyWrapBundle::GroupEntry& groupEntry);
+
   shared_ptr<Data>
-  createDataPacket();
+  createDataPacket(const Name& name, std::istream& input, const Buffer& contentKey);
+
+  /**
+   * @brief publish every regular file under @p directory as segments
+   *        <prefix>/<relative path>/<version>/<segment>, sealed and signed on first request
+   *
+   * The version of a file is its modification time, so a file keeps its names across restarts
+   * as long as it is not modified. The key bundle of a file is made for the users registered
+   * when it is first requested, however many there were at startup.
+   *
+   * @return number of files published
+   */
+  size_t
+  publishDirectory(const Name& prefix, const std::string& directory);
+
+  /**
+   * @brief make the signed segment named @p dataName of @p file
+   * @return the packet, or nullptr if the file cannot be read
+   */
+  shared_ptr<const Data>
+  makeFilePacket(const shared_ptr<FilePublication>& file, const Name& dataName);
+
+  /**
+   * @brief read @p input into encrypted segments under @p versionedName
+   */
+  std::vector<shared_ptr<Data>>
+  createSegments(const Name& versionedName, std::istream& input, const Buffer& contentKey);
 
+  /**
+   * @brief sign @p data with DigestSha256 (-D), the given identity (-i),
+   *        or the default identity of the KeyChain
+   */
+  void
+  sign(Data& data);
+
+  /**
+   * @brief wrap @p contentKey for every active user
+   * @return signed segments <contentName>/KEYS/<version>/<segment> carrying a KeyWrapBundle
+   */
+  std::vector<shared_ptr<const Data>>
+  createKeyBundle(const Name& contentName, const Buffer& contentKey);
+
+  /**
+   * @return signed segments <contentName>/KEYS/<version>/<segment> carrying @p bundle
+   */
+  std::vector<shared_ptr<const Data>>
+  createKeyBundle(const Name& contentName, const KeyWrapBundle& bundle);
+
+  /**
+   * @brief cut @p wire into signed segments under @p versionedName
+   */
+  std::vector<shared_ptr<Data>>
+  splitAndSign(const Name& versionedName, const Block& wire);
+
+  /**
+   * @brief answer @p interest from the content index
+   *
+   * A packet that has to be made first (see publishDirectory) is made on a worker thread,
+   * and put by onPacketMade on the Face thread. Interests arriving while the packet is
+   * being made are coalesced with the one that started it.
+   */
   void
   onInterest(const Name& name,
-             const Interest& interest,
-             shared_ptr<Data> dataPacket);
+             const Interest& interest);
+
+  void
+  onPacketMade(const ContentIndex::Match& match, const shared_ptr<const Data>& data);
+
+  /**
+   * @brief make the key bundle of a lazy publication on a worker thread, and answer
+   *        @p interest with its first segment
+   *
+   * While no user is registered there is no bundle to make, and @p interest is answered with
+   * an application-level Nack, a Data of ContentType Nack that is stale at once, so that the
+   * bundle is made when it is asked for again after users have registered.
+   */
+  void
+  makeKeyBundle(const ContentIndex::Match& match, const Interest& interest);
+
+  void
+  onKeyBundleMade(const ContentIndex::Match& match,
+                  const std::vector<shared_ptr<const Data>>& keyBundle);
+
+  /**
+   * @brief register the users carried by the command Interest @p interest
+   *
+   * The command is validated on the Face thread; its keys are decoded on a worker thread,
+   * and the users are added to the ActiveUserTable on the Face thread. The outcome is
+   * answered with a signed ControlResponse: 200 when every user is registered, 400 when the
+   * command is malformed (no user is registered then), 403 when it is not authorized.
+   * With tokens, the response to 200 carries TokenGrants, wrapped on a worker thread.
+   */
+  void
+  onRegistrationInterest(const Interest& interest);
+
+  /**
+   * @brief execute one command line of the daemon
+   *
+   * Commands are "publish <name> <file> [group]", "publish-tree <name> <directory>",
+   * "unpublish <name>", "group-add <group> <user-id>", "group-remove <group> <user-id>"
+   * and "stats"; names must be under the registered prefix. Content of "publish" is encrypted
+   * and signed on a worker thread, and is reported when it has been added to the index;
+   * with a group, its content key is wrapped only under the group key. A change of group
+   * publishes its RekeyMessage. The outcome is reported on stdout as "OK ..." or "ERROR ...".
+   */
+  void
+  processCommand(const std::string& line);
 
   void
   onRegisterFailed(const Name& prefix, const std::string& reason);
@@ -60,17 +293,159 @@ public:
   bool
   isDataSent() const;
 
+  Buffer
+  decrypt(const Buffer& cipher);
+
+  void
+  doRegister(const std::string& uid, shared_ptr<const CryptoPP::PublicKey> pubKey,
+             const CryptoBackend& backend);
+
+public:
+  /**
+   * @brief name component appended to the prefix to name the filter of the users
+   */
+  static const name::Component USER_FILTER_COMPONENT;
+
+  /**
+   * @brief delay after which input that does not fill a segment is published anyway
+   */
+  static const std::chrono::milliseconds LIVE_FLUSH_DELAY;
+
+  /**
+   * @brief how far beyond the latest live segment Interests wait for their segment
+   */
+  static const uint64_t MAX_AWAITED_SEGMENTS;
+
+  /**
+   * @brief number of users added or removed after which the snapshot of the users is saved
+   */
+  static const size_t MAX_LOGGED_USER_CHANGES;
+
+private:
+  struct Registrant
+  {
+    std::string userId;
+    shared_ptr<const CryptoPP::PublicKey> publicKey;
+    const CryptoBackend* backend;
+  };
+
+  /**
+   * @brief decode the users of the Registration in @p command, checking their keys
+   * @throw std::exception the Registration or one of its keys is malformed
+   */
+  static std::vector<Registrant>
+  decodeRegistration(const name::Component& command);
+
+  /**
+   * @brief encrypt and sign @p input under @p contentKey, without key bundle
+   */
+  ContentIndex::Publication
+  sealPublication(const Name& name, std::istream& input, const Buffer& contentKey);
+
+  void
+  onRegistrationValidated(const Interest& interest);
+
+  /**
+   * @brief answer @p interest with a ControlResponse, signed on a worker thread
+   * @param makeBody makes the body of the response on the worker thread, if given
+   */
+  void
+  putControlResponse(const Interest& interest, uint32_t code, const std::string& text,
+                     const std::function<Block()>& makeBody = nullptr);
+
+  /**
+   * @return whether @p interest carries a valid token of a registered user; false also if
+   *         the user's record in the snapshot cannot be decoded
+   */
+  bool
+  isAuthorized(const Interest& interest);
+
+  /**
+   * @brief add @p userId, who must be registered, to access group @p groupId, creating the
+   *        group if needed, or remove @p userId from it
+   */
+  void
+  changeGroup(const std::string& groupId, const std::string& userId, bool isAdded);
+
+  /**
+   * @brief sign the rekey message @p message of @p group, and add it to the content index
+   * @return name of the message
+   */
+  Name
+  publishRekey(const AccessGroup& group, const RekeyMessage& message);
+
+  /**
+   * @brief expire users every ActiveUserTable::EXPIRY_TICK
+   */
   void
-  saveKey(const std::string &filename, const CryptoMaterial &key);
+  scheduleExpiry();
 
-  std::string
-  encrypt(const std::string &payload);
+  /**
+   * @brief save the snapshot of the users if it holds users that expired, or if the log has
+   *        MAX_LOGGED_USER_CHANGES changes, and no save is running
+   */
+  void
+  checkUserSnapshot();
+
+  /**
+   * @brief save the snapshot of the users on the worker pool, dropping the users that expired
+   */
+  void
+  saveUserSnapshot();
+
+  /**
+   * @brief publish the filter of the users every ActiveUserTable::EXPIRY_TICK in which
+   *        users changed
+   */
+  void
+  scheduleUserFilter();
+
+  /**
+   * @brief export the filter of the users, and replace its previous version in the content
+   *        index once its segments are signed on the worker pool
+   */
+  void
+  publishUserFilter();
+
+  /**
+   * @brief cut @p filter into signed segments under @p versionedName
+   */
+  ContentIndex::Publication
+  makeUserFilterPublication(const Name& versionedName, const Block& filter);
+
+  void
+  startReadingCommands();
+
+  /**
+   * @brief start publishing stdin as live segments under <name>/<version>
+   *
+   * Segments are sealed and signed on the worker pool as pieces of input are cut, and
+   * appended to the content index in order. Interests for segments that do not exist yet
+   * wait for them.
+   */
+  void
+  startLive(const Name& name);
 
-  std::string
-  decrypt(const std::string &cipher);
+  void
+  readLive();
+
+  void
+  scheduleLiveFlush();
+
+  void
+  makeLiveSegments(const std::vector<LiveStream::Piece>& pieces);
+
+  void
+  onLiveSegmentMade(const LiveStream::Piece& piece, const shared_ptr<const Data>& segment);
+
+  /**
+   * @return whether @p interest waits for a live segment that does not exist yet
+   */
+  bool
+  awaitLiveSegment(const Interest& interest);
 
   void
-  doRegister(std::string uid, RSA::PublicKey &pubKey);
+  readCommands();
 
 private:
   std::string m_programName;
@@ -85,9 +460,59 @@ private:
   Face m_face;
 
   ActiveUserTable aut;
+  std::string m_registrationPolicy;
+  unique_ptr<security::ValidatorConfig> m_registrationValidator;
+  time::seconds m_userTtl;
+  scheduler::Scheduler m_scheduler;
+  scheduler::ScopedEventId m_expiryEvent;
+  bool m_isUserSnapshotPending;
+  time::seconds m_tokenLifetime;
+  unique_ptr<TokenVerifier> m_tokenVerifier;
+  double m_userFilterRate;
+  scheduler::ScopedEventId m_userFilterEvent;
+  /**
+   * @brief number of filter changes at the last publication of the filter
+   */
+  uint64_t m_nUserFilterChanges;
+  bool m_isUserFilterPending;
+  /**
+   * @brief name of the published filter; empty if there is none
+   */
+  Name m_userFilterName;
+  std::map<std::string, unique_ptr<AccessGroup>> m_groups;
+
+  std::string m_keyDirectory;
+  size_t m_nThreads;
+  const CryptoBackend* m_backend;
+  size_t m_maxSegmentSize;
+  unique_ptr<Signer> m_signer;
+  size_t m_memoryBudget;
+  std::string m_directory;
+  unique_ptr<ContentStore> m_store;
+  unique_ptr<ContentIndex> m_index;
+  InFlightTable m_inFlight;
+
+  bool m_isDaemon;
+  unique_ptr<boost::asio::posix::stream_descriptor> m_commandInput;
+  boost::asio::streambuf m_commandBuffer;
+  unique_ptr<boost::asio::signal_set> m_terminationSignals;
+
+  bool m_isLive;
+  unique_ptr<envelope::Sealer> m_liveSealer;
+  unique_ptr<LiveStream> m_liveStream;
+  unique_ptr<boost::asio::posix::stream_descriptor> m_liveInput;
+  Buffer m_liveReadBuffer;
+  unique_ptr<boost::asio::steady_timer> m_liveFlushTimer;
+  bool m_isLiveFlushScheduled;
+  std::map<uint64_t, std::pair<shared_ptr<const Data>, bool>> m_liveReadySegments;
+  uint64_t m_nLiveSegments;
+  InFlightTable m_awaitedSegments;
+  shared_ptr<const CryptoPP::PublicKey> m_publicKey;
+  shared_ptr<const CryptoPP::PrivateKey> m_privateKey;
 
-  RSA::PrivateKey *privateKey;
-  RSA::PublicKey * publicKey;
+  // declared last so that it is destroyed first, finishing the tasks that still use the
+  // members above
+  unique_ptr<WorkerPool> m_workers;
 };
 
 int main(int argc, char** argv);
@@ -0,0 +1,56 @@
+#include "segmenter.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace epac {
+
+const size_t Segmenter::DEFAULT_SEGMENT_SIZE = 4096;
+
+Segmenter::Segmenter(const envelope::Sealer& sealer, size_t maxSegmentSize)
+  : m_sealer(sealer)
+  , m_maxSegmentSize(maxSegmentSize)
+{
+  BOOST_ASSERT(m_maxSegmentSize > 0);
+}
+
+std::vector<shared_ptr<Data>>
+Segmenter::segment(const Name& versionedPrefix, std::istream& input)
+{
+  std::vector<shared_ptr<Data>> segments;
+  std::streambuf& in = *input.rdbuf();
+  do {
+    auto segment = make_shared<Data>(Name(versionedPrefix).appendSegment(segments.size()));
+    segment->setContent(m_sealer.sealStream(input, m_maxSegmentSize, m_maxSegmentSize));
+    segments.push_back(segment);
+  } while (in.sgetc() != std::char_traits<char>::eof());
+
+  auto finalBlockId = name::Component::fromSegment(segments.size() - 1);
+  for (const auto& segment : segments) {
+    segment->setFinalBlockId(finalBlockId);
+  }
+  return segments;
+}
+
+std::vector<shared_ptr<Data>>
+Segmenter::split(const Name& versionedPrefix, const Block& wire, size_t maxSegmentSize)
+{
+  BOOST_ASSERT(maxSegmentSize > 0);
+
+  size_t nSegments = std::max<size_t>((wire.size() + maxSegmentSize - 1) / maxSegmentSize, 1);
+  auto finalBlockId = name::Component::fromSegment(nSegments - 1);
+
+  std::vector<shared_ptr<Data>> segments;
+  segments.reserve(nSegments);
+  for (size_t i = 0; i < nSegments; ++i) {
+    auto segment = make_shared<Data>(Name(versionedPrefix).appendSegment(i));
+    size_t begin = i * maxSegmentSize;
+    segment->setContent(wire.wire() + begin, std::min(maxSegmentSize, wire.size() - begin));
+    segment->setFinalBlockId(finalBlockId);
+    segments.push_back(segment);
+  }
+  return segments;
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,55 @@
+#ifndef NDN_EPAC_SEGMENTER_HPP
+#define NDN_EPAC_SEGMENTER_HPP
+
+#include "core/common.hpp"
+#include "core/envelope.hpp"
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief splits a payload into encrypted segments named <prefix>/<version>/<segment>
+ *
+ * Every segment carries its own envelope under the content key of the Sealer, so a consumer
+ * unwraps the content key once per version and decrypts each segment on its own.
+ * All segments carry FinalBlockId, as expected by ndncatchunks. Segments are not signed.
+ */
+class Segmenter : noncopyable
+{
+public:
+  /**
+   * @brief default payload octets per segment, leaving room for the envelope header,
+   *        name and signature within the NDN packet size limit
+   */
+  static const size_t DEFAULT_SEGMENT_SIZE;
+
+  Segmenter(const envelope::Sealer& sealer, size_t maxSegmentSize = DEFAULT_SEGMENT_SIZE);
+
+  /**
+   * @brief read @p input until its end and seal it into segments under @p versionedPrefix
+   * @return segments in order; an empty input yields one segment with an empty payload
+   */
+  std::vector<shared_ptr<Data>>
+  segment(const Name& versionedPrefix, std::istream& input);
+
+  /**
+   * @brief cut @p wire into segments under @p versionedPrefix without encrypting it
+   *
+   * This is how packets too large for one Data, such as key bundles and user filters, are
+   * published. Segments carry FinalBlockId and are not signed.
+   *
+   * @return segments in order
+   */
+  static std::vector<shared_ptr<Data>>
+  split(const Name& versionedPrefix, const Block& wire,
+        size_t maxSegmentSize = DEFAULT_SEGMENT_SIZE);
+
+private:
+  const envelope::Sealer& m_sealer;
+  size_t m_maxSegmentSize;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_SEGMENTER_HPP
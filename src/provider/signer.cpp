@@ -0,0 +1,70 @@
+#include "signer.hpp"
+
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/security/digest-sha256.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @return KeyChain of the calling thread
+ */
+static KeyChain&
+getKeyChain()
+{
+  static thread_local unique_ptr<KeyChain> keyChain;
+  if (keyChain == nullptr) {
+    keyChain.reset(new KeyChain);
+  }
+  return *keyChain;
+}
+
+/**
+ * @brief sign @p data with DigestSha256 the way KeyChain does, without a KeyChain
+ */
+static void
+signWithSha256(Data& data)
+{
+  data.setSignature(DigestSha256());
+
+  EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  ConstBufferPtr digest = util::Sha256::computeDigest(encoder.buf(), encoder.size());
+  data.wireEncode(encoder, Block(ndn::tlv::SignatureValue, digest));
+}
+
+Signer::Signer(WorkerPool& pool, const security::SigningInfo& params)
+  : m_pool(pool)
+  , m_params(params)
+  , m_isDigestSha256(params.getSignerType() == security::SigningInfo::SIGNER_TYPE_SHA256)
+{
+}
+
+void
+Signer::sign(Data& data) const
+{
+  if (m_isDigestSha256)
+    signWithSha256(data);
+  else
+    getKeyChain().sign(data, m_params);
+}
+
+void
+Signer::signAll(const std::vector<shared_ptr<Data>>& packets) const
+{
+  if (packets.size() == 1) {
+    sign(*packets.front());
+    return;
+  }
+
+  m_pool.parallelFor(packets.size(), [&] (size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      sign(*packets[i]);
+    }
+  });
+}
+
+} // namespace epac
+} // namespace ndn
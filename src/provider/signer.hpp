@@ -0,0 +1,51 @@
+#ifndef NDN_EPAC_SIGNER_HPP
+#define NDN_EPAC_SIGNER_HPP
+
+#include "core/common.hpp"
+#include "core/worker-pool.hpp"
+
+#include <ndn-cxx/security/signing-info.hpp>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief signs Data packets of a provider, in parallel across a WorkerPool
+ *
+ * KeyChain is not thread-safe, so every thread signing with a key uses its own KeyChain,
+ * opened on first use. DigestSha256 does not involve the KeyChain at all: the signature
+ * is computed directly, which makes it the cheap choice when no key signature is required.
+ */
+class Signer : noncopyable
+{
+public:
+  Signer(WorkerPool& pool, const security::SigningInfo& params);
+
+  const security::SigningInfo&
+  getSigningInfo() const
+  {
+    return m_params;
+  }
+
+  /**
+   * @brief sign @p data on the calling thread
+   */
+  void
+  sign(Data& data) const;
+
+  /**
+   * @brief sign every packet of @p packets across the pool, and wait
+   */
+  void
+  signAll(const std::vector<shared_ptr<Data>>& packets) const;
+
+private:
+  WorkerPool& m_pool;
+  security::SigningInfo m_params;
+  bool m_isDigestSha256;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_SIGNER_HPP
@@ -0,0 +1,244 @@
+#ifndef NDN_EPAC_TIMING_WHEEL_HPP
+#define NDN_EPAC_TIMING_WHEEL_HPP
+
+#include "core/common.hpp"
+
+#include <array>
+#include <limits>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief hierarchical timing wheel of values that expire at a tick
+ *
+ * Four levels of 256 slots each cover 2^32 ticks ahead: a value due within 256 ticks goes
+ * into a slot of the first level, one due later into a coarser level, and is moved down
+ * a level each time the finer level wraps around. Scheduling, cancelling and expiring cost
+ * a constant number of list operations per value, however many values are scheduled and
+ * however far ahead they are due.
+ *
+ * Entries are kept in one vector and linked into the lists of their slots by index.
+ */
+template<typename T>
+class TimingWheel : noncopyable
+{
+public:
+  static const size_t NONE = std::numeric_limits<size_t>::max();
+
+  /**
+   * @param now the first tick that advance() will process
+   */
+  explicit
+  TimingWheel(uint64_t now = 0)
+    : m_now(now)
+    , m_size(0)
+  {
+    m_heads.fill(NONE);
+  }
+
+  /**
+   * @return the next tick that advance() will process
+   */
+  uint64_t
+  getNow() const
+  {
+    return m_now;
+  }
+
+  /**
+   * @return number of scheduled values
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief schedule @p value to expire at tick @p deadline, or at the next tick processed
+   *        if @p deadline has passed
+   * @return id of the entry, which stays valid until the value expires or is cancelled
+   */
+  size_t
+  schedule(uint64_t deadline, T value)
+  {
+    size_t id;
+    if (m_freeEntries.empty()) {
+      id = m_entries.size();
+      m_entries.emplace_back();
+    }
+    else {
+      id = m_freeEntries.back();
+      m_freeEntries.pop_back();
+    }
+
+    Entry& entry = m_entries[id];
+    entry.deadline = std::max(deadline, m_now);
+    entry.value = std::move(value);
+    link(id);
+    ++m_size;
+    return id;
+  }
+
+  /**
+   * @brief cancel the entry @p id, dropping its value
+   */
+  void
+  cancel(size_t id)
+  {
+    unlink(id);
+    release(id);
+  }
+
+  uint64_t
+  getDeadline(size_t id) const
+  {
+    return m_entries[id].deadline;
+  }
+
+  /**
+   * @brief process the ticks up to @p now included, invoking @p onExpired with the value of
+   *        each entry that expires
+   *
+   * An entry is released before @p onExpired is invoked, which may schedule and cancel
+   * entries; those that it schedules at or before @p now expire in this call as well.
+   */
+  template<typename F>
+  void
+  advance(uint64_t now, const F& onExpired)
+  {
+    while (m_now <= now) {
+      uint64_t tick = m_now;
+
+      // move the values of coarser levels that fall within the next ticks down a level
+      for (size_t level = N_LEVELS - 1; level > 0; --level) {
+        if ((tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+          cascade(level * N_SLOTS + getSlot(tick, level));
+        }
+      }
+
+      // values due now are moved to the list of expiring values, so that values scheduled
+      // by onExpired go into the next ticks
+      size_t slot = getSlot(tick, 0);
+      m_heads[EXPIRING] = m_heads[slot];
+      m_heads[slot] = NONE;
+      for (size_t id = m_heads[EXPIRING]; id != NONE; id = m_entries[id].next) {
+        m_entries[id].list = EXPIRING;
+      }
+      ++m_now;
+
+      while (m_heads[EXPIRING] != NONE) {
+        size_t id = m_heads[EXPIRING];
+        unlink(id);
+        T value = std::move(m_entries[id].value);
+        release(id);
+        onExpired(std::move(value));
+      }
+    }
+  }
+
+private:
+  static const size_t SLOT_BITS = 8;
+  static const size_t N_SLOTS = 1 << SLOT_BITS;
+  static const size_t N_LEVELS = 4;
+  /**
+   * @brief the list of values expiring in advance(), after the lists of all slots
+   */
+  static const size_t EXPIRING = N_LEVELS * N_SLOTS;
+
+  struct Entry
+  {
+    uint64_t deadline = 0;
+    size_t list = NONE;
+    size_t previous = NONE;
+    size_t next = NONE;
+    T value = T();
+  };
+
+  static size_t
+  getSlot(uint64_t tick, size_t level)
+  {
+    return (tick >> (SLOT_BITS * level)) & (N_SLOTS - 1);
+  }
+
+  void
+  link(size_t id)
+  {
+    Entry& entry = m_entries[id];
+    uint64_t delta = entry.deadline - m_now;
+
+    size_t level = 0;
+    while (level < N_LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+      ++level;
+    }
+    // values due beyond the last level wait in its farthest slot, and are placed again
+    // when that slot is cascaded
+    uint64_t tick = entry.deadline;
+    if (delta >= (uint64_t(1) << (SLOT_BITS * N_LEVELS))) {
+      tick = m_now + (uint64_t(1) << (SLOT_BITS * N_LEVELS)) - 1;
+    }
+
+    entry.list = level * N_SLOTS + getSlot(tick, level);
+    entry.previous = NONE;
+    entry.next = m_heads[entry.list];
+    if (entry.next != NONE) {
+      m_entries[entry.next].previous = id;
+    }
+    m_heads[entry.list] = id;
+  }
+
+  void
+  unlink(size_t id)
+  {
+    Entry& entry = m_entries[id];
+    if (entry.previous != NONE) {
+      m_entries[entry.previous].next = entry.next;
+    }
+    else {
+      m_heads[entry.list] = entry.next;
+    }
+    if (entry.next != NONE) {
+      m_entries[entry.next].previous = entry.previous;
+    }
+    entry.list = NONE;
+  }
+
+  void
+  release(size_t id)
+  {
+    m_entries[id] = Entry();
+    m_freeEntries.push_back(id);
+    --m_size;
+  }
+
+  void
+  cascade(size_t list)
+  {
+    size_t id = m_heads[list];
+    m_heads[list] = NONE;
+    while (id != NONE) {
+      size_t next = m_entries[id].next;
+      link(id);
+      id = next;
+    }
+  }
+
+private:
+  std::vector<Entry> m_entries;
+  std::vector<size_t> m_freeEntries;
+  std::array<size_t, N_LEVELS * N_SLOTS + 1> m_heads;
+  uint64_t m_now;
+  size_t m_size;
+};
+
+template<typename T>
+const size_t TimingWheel<T>::NONE;
+
+template<typename T>
+const size_t TimingWheel<T>::EXPIRING;
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_TIMING_WHEEL_HPP
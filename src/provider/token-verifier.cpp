@@ -0,0 +1,105 @@
+#include "token-verifier.hpp"
+#include "core/crypto-context.hpp"
+
+#include <cryptopp/misc.h>
+
+#include <cstring>
+
+namespace ndn {
+namespace epac {
+
+const size_t TokenVerifier::CACHE_SIZE = 4096;
+
+static const size_t SECRET_SIZE = 32;
+
+static Buffer
+generateSecret()
+{
+  Buffer secret(SECRET_SIZE);
+  CryptoContext::get().getRng().GenerateBlock(secret.data(), secret.size());
+  return secret;
+}
+
+static uint64_t
+getNow()
+{
+  return time::toUnixTimestamp(time::system_clock::now()).count();
+}
+
+TokenVerifier::TokenVerifier(time::milliseconds lifetime)
+  : TokenVerifier(lifetime, generateSecret())
+{
+}
+
+TokenVerifier::TokenVerifier(time::milliseconds lifetime, const Buffer& secret)
+  : m_lifetime(lifetime)
+  , m_hmac(secret.data(), secret.size())
+  , m_cache(CACHE_SIZE)
+  , m_nCacheHits(0)
+  , m_nRejected(0)
+{
+  BOOST_ASSERT(lifetime > time::milliseconds::zero());
+}
+
+AccessToken
+TokenVerifier::issue(const std::string& userId)
+{
+  uint64_t expiry = getNow() + m_lifetime.count();
+  return AccessToken(userId, expiry, computeMac(userId, expiry));
+}
+
+bool
+TokenVerifier::verify(const AccessToken& token)
+{
+  if (token.getExpiry() <= getNow()) {
+    ++m_nRejected;
+    return false;
+  }
+
+  // only verified tokens are cached; MACs are compared in constant time, so that a forged
+  // token does not learn how much of a cached MAC it guessed
+  CacheEntry& entry = getCacheEntry(token.getMac());
+  if (entry.expiry == token.getExpiry() && entry.userId == token.getUserId() &&
+      CryptoPP::VerifyBufsEqual(entry.mac.data(), token.getMac().data(), entry.mac.size())) {
+    ++m_nCacheHits;
+    return true;
+  }
+
+  Buffer mac = computeMac(token.getUserId(), token.getExpiry());
+  if (!CryptoPP::VerifyBufsEqual(mac.data(), token.getMac().data(), mac.size())) {
+    ++m_nRejected;
+    return false;
+  }
+
+  entry.userId = token.getUserId();
+  entry.expiry = token.getExpiry();
+  std::copy(mac.begin(), mac.end(), entry.mac.begin());
+  return true;
+}
+
+Buffer
+TokenVerifier::computeMac(const std::string& userId, uint64_t expiry)
+{
+  uint8_t expiryOctets[8];
+  for (size_t i = 0; i < sizeof(expiryOctets); ++i) {
+    expiryOctets[i] = static_cast<uint8_t>(expiry >> (8 * (sizeof(expiryOctets) - 1 - i)));
+  }
+
+  m_hmac.Update(expiryOctets, sizeof(expiryOctets));
+  m_hmac.Update(reinterpret_cast<const uint8_t*>(userId.data()), userId.size());
+  Buffer mac(AccessToken::MAC_SIZE);
+  m_hmac.TruncatedFinal(mac.data(), mac.size());
+  return mac;
+}
+
+TokenVerifier::CacheEntry&
+TokenVerifier::getCacheEntry(const Buffer& mac)
+{
+  // MACs are uniformly distributed: their first octets pick the entry
+  uint64_t index = 0;
+  std::memcpy(&index, mac.data(), sizeof(index));
+  return m_cache[index % CACHE_SIZE];
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,99 @@
+#ifndef NDN_EPAC_TOKEN_VERIFIER_HPP
+#define NDN_EPAC_TOKEN_VERIFIER_HPP
+
+#include "core/common.hpp"
+#include "core/access-token.hpp"
+
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
+
+#include <array>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief issues AccessTokens and checks those attached to Interests
+ *
+ * The MAC of a token is HMAC-SHA256, under a secret of the verifier, of the expiry as eight
+ * octets in network order followed by the user id, truncated to AccessToken::MAC_SIZE.
+ * Tokens that were verified are kept in a direct-mapped cache indexed by their MAC, so the
+ * Interests of a user that come after the first are checked by a comparison instead of an
+ * HMAC. A verifier is not thread-safe; the provider uses it from the Face thread.
+ */
+class TokenVerifier : noncopyable
+{
+public:
+  /**
+   * @brief issue tokens valid for @p lifetime under a random secret
+   */
+  explicit
+  TokenVerifier(time::milliseconds lifetime);
+
+  TokenVerifier(time::milliseconds lifetime, const Buffer& secret);
+
+  /**
+   * @return a token for @p userId, valid for the lifetime from now
+   */
+  AccessToken
+  issue(const std::string& userId);
+
+  /**
+   * @return whether @p token was issued by this verifier and has not expired
+   */
+  bool
+  verify(const AccessToken& token);
+
+  /**
+   * @return number of tokens found in the cache
+   */
+  uint64_t
+  getNCacheHits() const
+  {
+    return m_nCacheHits;
+  }
+
+  /**
+   * @return number of tokens rejected
+   */
+  uint64_t
+  getNRejected() const
+  {
+    return m_nRejected;
+  }
+
+public:
+  /**
+   * @brief number of tokens the cache holds
+   */
+  static const size_t CACHE_SIZE;
+
+private:
+  struct CacheEntry
+  {
+    std::string userId;
+    /**
+     * @brief expiry of the token; 0 if the entry is empty
+     */
+    uint64_t expiry = 0;
+    std::array<uint8_t, AccessToken::MAC_SIZE> mac;
+  };
+
+  Buffer
+  computeMac(const std::string& userId, uint64_t expiry);
+
+  CacheEntry&
+  getCacheEntry(const Buffer& mac);
+
+private:
+  time::milliseconds m_lifetime;
+  CryptoPP::HMAC<CryptoPP::SHA256> m_hmac;
+  std::vector<CacheEntry> m_cache;
+  uint64_t m_nCacheHits;
+  uint64_t m_nRejected;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_TOKEN_VERIFIER_HPP
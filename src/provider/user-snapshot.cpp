@@ -0,0 +1,200 @@
+#include "user-snapshot.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace ndn {
+namespace epac {
+
+static const char MAGIC[8] = {'E', 'P', 'A', 'C', 'A', 'U', 'T', '1'};
+
+struct SnapshotHeader
+{
+  char magic[8];
+  uint64_t nUsers;
+  uint64_t nSlots;
+};
+
+struct RecordHeader
+{
+  uint32_t userIdSize;
+  uint32_t keySize;
+  uint64_t backendType;
+};
+
+static size_t
+pad(size_t size)
+{
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+UserSnapshot::UserSnapshot(const std::string& filename)
+{
+  try {
+    m_file.open(filename);
+  }
+  catch (const std::exception& e) {
+    BOOST_THROW_EXCEPTION(Error("Cannot map " + filename + ": " + e.what()));
+  }
+
+  m_begin = reinterpret_cast<const uint8_t*>(m_file.data());
+  m_end = m_begin + m_file.size();
+
+  SnapshotHeader header;
+  if (m_file.size() < sizeof(header)) {
+    BOOST_THROW_EXCEPTION(Error(filename + " is not a user snapshot"));
+  }
+  std::memcpy(&header, m_begin, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    BOOST_THROW_EXCEPTION(Error(filename + " is not a user snapshot"));
+  }
+
+  // bound the counts by the file size first, so that the sizes below cannot overflow
+  size_t maxEntries = m_file.size() / sizeof(uint64_t);
+  if (header.nSlots == 0 || (header.nSlots & (header.nSlots - 1)) != 0 ||
+      header.nSlots > maxEntries || header.nUsers >= header.nSlots ||
+      sizeof(header) + (header.nSlots + header.nUsers) * sizeof(uint64_t) > m_file.size()) {
+    BOOST_THROW_EXCEPTION(Error(filename + " has a malformed index"));
+  }
+
+  m_nUsers = header.nUsers;
+  m_mask = header.nSlots - 1;
+  m_slots = reinterpret_cast<const Slot*>(m_begin + sizeof(header));
+  m_offsets = reinterpret_cast<const uint64_t*>(m_slots + header.nSlots);
+}
+
+size_t
+UserSnapshot::find(const std::string& userId) const
+{
+  uint32_t h = hash(userId.data(), userId.size());
+  size_t position = h & m_mask;
+  for (size_t i = 0; i <= m_mask && m_slots[position].record != 0; ++i) {
+    const Slot& slot = m_slots[position];
+    if (slot.hash == h) {
+      Record record = getRecord(slot.record - 1);
+      if (record.userIdSize == userId.size() &&
+          std::memcmp(record.userId, userId.data(), userId.size()) == 0) {
+        return slot.record - 1;
+      }
+    }
+    position = (position + 1) & m_mask;
+  }
+  return m_nUsers;
+}
+
+UserSnapshot::Record
+UserSnapshot::getRecord(size_t n) const
+{
+  Record record;
+  const uint8_t* recordsBegin = reinterpret_cast<const uint8_t*>(m_offsets + m_nUsers);
+  if (n >= m_nUsers || m_offsets[n] < static_cast<uint64_t>(recordsBegin - m_begin) ||
+      m_offsets[n] >= static_cast<uint64_t>(m_end - m_begin) ||
+      decodeRecord(m_begin + m_offsets[n], m_end, record) == 0) {
+    BOOST_THROW_EXCEPTION(Error("Malformed record " + std::to_string(n) + " in user snapshot"));
+  }
+  return record;
+}
+
+void
+UserSnapshot::write(const std::string& filename, const std::vector<Record>& records)
+{
+  size_t nSlots = 16;
+  while (nSlots < records.size() * 2) {
+    nSlots *= 2;
+  }
+
+  SnapshotHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.nUsers = records.size();
+  header.nSlots = nSlots;
+
+  std::vector<Slot> slots(nSlots, Slot{0, 0});
+  std::vector<uint64_t> offsets(records.size());
+  uint64_t offset = sizeof(header) + (nSlots + records.size()) * sizeof(uint64_t);
+  for (size_t i = 0; i < records.size(); ++i) {
+    const Record& record = records[i];
+    uint32_t h = hash(record.userId, record.userIdSize);
+    size_t position = h & (nSlots - 1);
+    while (slots[position].record != 0) {
+      position = (position + 1) & (nSlots - 1);
+    }
+    slots[position] = Slot{h, static_cast<uint32_t>(i + 1)};
+
+    offsets[i] = offset;
+    offset += pad(sizeof(RecordHeader) + record.userIdSize + record.keySize);
+  }
+
+  std::string tmpFilename = filename + ".tmp";
+  {
+    std::ofstream os(tmpFilename, std::ios::binary | std::ios::trunc);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(Slot));
+    os.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    for (const auto& record : records) {
+      encodeRecord(os, record);
+    }
+    os.close();
+    if (!os) {
+      BOOST_THROW_EXCEPTION(Error("Cannot write " + tmpFilename));
+    }
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpFilename, filename, ec);
+  if (ec) {
+    BOOST_THROW_EXCEPTION(Error("Cannot write " + filename + ": " + ec.message()));
+  }
+}
+
+void
+UserSnapshot::encodeRecord(std::ostream& os, const Record& record)
+{
+  RecordHeader header;
+  header.userIdSize = static_cast<uint32_t>(record.userIdSize);
+  header.keySize = static_cast<uint32_t>(record.keySize);
+  header.backendType = record.backendType;
+
+  static const char PADDING[8] = {};
+  size_t size = sizeof(header) + record.userIdSize + record.keySize;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.write(record.userId, record.userIdSize);
+  os.write(reinterpret_cast<const char*>(record.key), record.keySize);
+  os.write(PADDING, pad(size) - size);
+}
+
+size_t
+UserSnapshot::decodeRecord(const uint8_t* begin, const uint8_t* end, Record& record)
+{
+  RecordHeader header;
+  if (static_cast<size_t>(end - begin) < sizeof(header)) {
+    return 0;
+  }
+  std::memcpy(&header, begin, sizeof(header));
+
+  size_t size = pad(sizeof(header) + static_cast<size_t>(header.userIdSize) + header.keySize);
+  if (static_cast<size_t>(end - begin) < size) {
+    return 0;
+  }
+
+  record.userId = reinterpret_cast<const char*>(begin + sizeof(header));
+  record.userIdSize = header.userIdSize;
+  record.backendType = header.backendType;
+  record.key = begin + sizeof(header) + header.userIdSize;
+  record.keySize = header.keySize;
+  return size;
+}
+
+uint32_t
+UserSnapshot::hash(const char* userId, size_t size)
+{
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    h = (h ^ static_cast<uint8_t>(userId[i])) * 16777619u;
+  }
+  return h;
+}
+
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,132 @@
+#ifndef NDN_EPAC_USER_SNAPSHOT_HPP
+#define NDN_EPAC_USER_SNAPSHOT_HPP
+
+#include "core/common.hpp"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace ndn {
+namespace epac {
+
+/**
+ * @brief read-only table of users in a memory-mapped file
+ *
+ * A snapshot holds one record per user (user id, backend type and DER-encoded public key)
+ * and an open-addressing index over the user ids, so it can be used as soon as it is
+ * mapped: opening reads only the header, and a record is read when it is looked up.
+ *
+ * Layout, in host byte order:
+ *  - header: magic "EPACAUT1", number of users, number of index slots (a power of two)
+ *  - index slots: FNV-1a hash of the user id (32 bits), record number plus one (32 bits; 0 if
+ *    the slot is empty)
+ *  - offset of each record from the start of the file (64 bits)
+ *  - records: user id size (32 bits), key size (32 bits), backend type (64 bits), user id,
+ *    key, padded to a multiple of 8 octets
+ *
+ * The same record encoding is used by the append log of ActiveUserTable.
+ */
+class UserSnapshot : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @brief a record; the pointers refer to memory owned by someone else
+   */
+  struct Record
+  {
+    const char* userId = nullptr;
+    size_t userIdSize = 0;
+    uint64_t backendType = 0;
+    const uint8_t* key = nullptr;
+    size_t keySize = 0;
+  };
+
+  /**
+   * @brief map the snapshot in @p filename
+   * @throw Error the file cannot be mapped or its header or index is malformed
+   */
+  explicit
+  UserSnapshot(const std::string& filename);
+
+  /**
+   * @return number of records
+   */
+  size_t
+  size() const
+  {
+    return m_nUsers;
+  }
+
+  /**
+   * @return the number of the record of @p userId, or size() if there is none
+   * @throw Error a record on the way is malformed
+   */
+  size_t
+  find(const std::string& userId) const;
+
+  /**
+   * @return record number @p n, pointing into the mapping
+   * @throw Error the record is malformed
+   */
+  Record
+  getRecord(size_t n) const;
+
+  /**
+   * @brief write a snapshot of @p records into @p filename
+   *
+   * Record n of the snapshot is @p records[n].
+   *
+   * The snapshot is written into a temporary file that is then renamed over @p filename,
+   * so a snapshot that is mapped meanwhile stays intact.
+   *
+   * @throw Error the file cannot be written
+   */
+  static void
+  write(const std::string& filename, const std::vector<Record>& records);
+
+  /**
+   * @brief append the encoding of @p record to @p os
+   */
+  static void
+  encodeRecord(std::ostream& os, const Record& record);
+
+  /**
+   * @brief decode the record at @p begin
+   * @return size of the encoded record, or 0 if [@p begin, @p end) does not hold a whole one
+   */
+  static size_t
+  decodeRecord(const uint8_t* begin, const uint8_t* end, Record& record);
+
+private:
+  struct Slot
+  {
+    uint32_t hash;
+    uint32_t record;
+  };
+
+  static uint32_t
+  hash(const char* userId, size_t size);
+
+private:
+  boost::iostreams::mapped_file_source m_file;
+  const uint8_t* m_begin;
+  const uint8_t* m_end;
+  size_t m_nUsers;
+  size_t m_mask;
+  const Slot* m_slots;
+  const uint64_t* m_offsets;
+};
+
+} // namespace epac
+} // namespace ndn
+
+#endif // NDN_EPAC_USER_SNAPSHOT_HPP
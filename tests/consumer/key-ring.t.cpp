@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "consumer/key-ring.hpp"
+#include "core/key-store.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class KeyRingFixture
+{
+protected:
+  KeyRingFixture()
+    : directory(boost::filesystem::path(TMP_TESTS_PATH) / "key-ring")
+    , text("HELLO WORLD")
+  {
+    boost::filesystem::remove_all(directory);
+    KeyStore keyStore(directory.string(), backend);
+    keyStore.loadOrGenerate();
+    publicKey = keyStore.getPublicKey();
+    privateKeyFile = keyStore.getPrivateKeyFile();
+  }
+
+  ~KeyRingFixture()
+  {
+    boost::filesystem::remove_all(directory);
+  }
+
+  Buffer
+  seal(const Buffer& contentKey)
+  {
+    return envelope::seal(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                          contentKey, backend, publicKey);
+  }
+
+  std::string
+  open(KeyRing& keyRing, const Name& name, const Buffer& sealed)
+  {
+    Buffer opened = keyRing.open(name, sealed.data(), sealed.size());
+    return std::string(opened.begin(), opened.end());
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  boost::filesystem::path directory;
+  std::string text;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+  std::string privateKeyFile;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacConsumer)
+BOOST_FIXTURE_TEST_SUITE(TestKeyRing, KeyRingFixture)
+
+BOOST_AUTO_TEST_CASE(ContentKeyName)
+{
+  BOOST_CHECK_EQUAL(KeyRing::getContentKeyName("/a/b"), Name("/a/b"));
+  BOOST_CHECK_EQUAL(KeyRing::getContentKeyName(Name("/a/b").appendSegment(3)), Name("/a/b"));
+
+  Name versioned = Name("/a/b").appendVersion(7);
+  BOOST_CHECK_EQUAL(KeyRing::getContentKeyName(versioned), versioned);
+  BOOST_CHECK_EQUAL(KeyRing::getContentKeyName(Name(versioned).appendSegment(0)), versioned);
+  BOOST_CHECK_EQUAL(KeyRing::getContentKeyName(Name(versioned).append("KEYS")), versioned);
+}
+
+BOOST_AUTO_TEST_CASE(CachedContentKey)
+{
+  KeyRing keyRing(backend);
+  keyRing.loadPrivateKey(privateKeyFile);
+  BOOST_CHECK_EQUAL(keyRing.getNPrivateKeys(), 1);
+
+  Name version = Name("/epac/content").appendVersion(1);
+  Buffer contentKey = envelope::generateContentKey();
+  Buffer sealed = seal(contentKey);
+
+  BOOST_CHECK_EQUAL(open(keyRing, Name(version).appendSegment(0), sealed), text);
+  BOOST_CHECK_EQUAL(keyRing.getNUnwraps(), 1);
+
+  // another segment of the same version, and a repeated fetch, skip the unwrap
+  BOOST_CHECK_EQUAL(open(keyRing, Name(version).appendSegment(1), seal(contentKey)), text);
+  BOOST_CHECK_EQUAL(open(keyRing, Name(version).appendSegment(0), sealed), text);
+  BOOST_CHECK_EQUAL(keyRing.getNUnwraps(), 1);
+  BOOST_CHECK_EQUAL(keyRing.getNCachedKeys(), 1);
+
+  // a new version is a new content key
+  BOOST_CHECK_EQUAL(open(keyRing, Name("/epac/content").appendVersion(2),
+                         seal(envelope::generateContentKey())), text);
+  BOOST_CHECK_EQUAL(keyRing.getNUnwraps(), 2);
+  BOOST_CHECK_EQUAL(keyRing.getNCachedKeys(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Republished)
+{
+  KeyRing keyRing(backend);
+  keyRing.loadPrivateKey(privateKeyFile);
+
+  // unversioned content republished with a new content key under the same name
+  BOOST_CHECK_EQUAL(open(keyRing, "/epac/hello", seal(envelope::generateContentKey())), text);
+  BOOST_CHECK_EQUAL(open(keyRing, "/epac/hello", seal(envelope::generateContentKey())), text);
+  BOOST_CHECK_EQUAL(keyRing.getNUnwraps(), 2);
+  BOOST_CHECK_EQUAL(keyRing.getNCachedKeys(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(SeveralPrivateKeys)
+{
+  KeyRing keyRing(backend);
+  CryptoPP::AutoSeededRandomPool rng;
+  keyRing.addPrivateKey(backend.generatePrivateKey(rng));
+
+  Buffer sealed = seal(envelope::generateContentKey());
+  BOOST_CHECK_THROW(keyRing.open("/epac/hello", sealed.data(), sealed.size()), KeyRing::Error);
+  BOOST_CHECK_EQUAL(keyRing.getNCachedKeys(), 0);
+
+  keyRing.loadPrivateKey(privateKeyFile);
+  BOOST_CHECK_EQUAL(open(keyRing, "/epac/hello", sealed), text);
+}
+
+BOOST_AUTO_TEST_CASE(Errors)
+{
+  KeyRing keyRing(backend);
+  Buffer sealed = seal(envelope::generateContentKey());
+  BOOST_CHECK_THROW(keyRing.open("/epac/hello", sealed.data(), sealed.size()), KeyRing::Error);
+  BOOST_CHECK_THROW(keyRing.loadPrivateKey((directory / "missing.key").string()),
+                    KeyRing::Error);
+
+  KeyRing otherAlgorithm(CryptoBackend::get("ecies"));
+  BOOST_CHECK_THROW(otherAlgorithm.open("/epac/hello", sealed.data(), sealed.size()),
+                    KeyRing::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestKeyRing
+BOOST_AUTO_TEST_SUITE_END() // EpacConsumer
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/access-token.hpp"
+
+#include "tests/test-common.hpp"
+
+#include "core/envelope.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_AUTO_TEST_SUITE(TestAccessToken)
+
+BOOST_AUTO_TEST_CASE(Encoding)
+{
+  AccessToken token("alice", 1500000000000, Buffer(AccessToken::MAC_SIZE));
+  AccessToken decoded(token.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getUserId(), "alice");
+  BOOST_CHECK_EQUAL(decoded.getExpiry(), 1500000000000);
+  BOOST_CHECK(decoded.getMac() == token.getMac());
+
+  // the token travels as the parameters of an Interest
+  Interest interest("/epac/provider/file");
+  token.attachTo(interest);
+  BOOST_REQUIRE(interest.hasParameters());
+  Interest received(interest.wireEncode());
+  BOOST_CHECK_EQUAL(AccessToken(received.getParameters()).getUserId(), "alice");
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  BOOST_CHECK_THROW(AccessToken(makeStringBlock(tlv::UserId, "alice")), AccessToken::Error);
+
+  auto makeWire = [] (size_t macSize) {
+    Block wire(tlv::AccessToken);
+    wire.push_back(makeStringBlock(tlv::UserId, "alice"));
+    wire.push_back(makeNonNegativeIntegerBlock(tlv::TokenExpiry, 1));
+    Buffer mac(macSize);
+    wire.push_back(makeBinaryBlock(tlv::TokenMac, mac.data(), mac.size()));
+    wire.encode();
+    return wire;
+  };
+  BOOST_CHECK_NO_THROW(AccessToken(makeWire(AccessToken::MAC_SIZE)));
+  BOOST_CHECK_THROW(AccessToken(makeWire(AccessToken::MAC_SIZE - 1)), AccessToken::Error);
+
+  Block noExpiry(tlv::AccessToken);
+  noExpiry.push_back(makeStringBlock(tlv::UserId, "alice"));
+  noExpiry.encode();
+  BOOST_CHECK_THROW(AccessToken{noExpiry}, AccessToken::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Grant)
+{
+  const CryptoBackend& backend = CryptoBackend::get("ecies");
+  CryptoPP::AutoSeededRandomPool rng;
+  auto privateKey = backend.generatePrivateKey(rng);
+  auto otherKey = backend.generatePrivateKey(rng);
+
+  AccessToken token("alice", 1500000000000, envelope::generateContentKey());
+  Block grant = token.wrap(backend, backend.makePublicKey(*privateKey));
+  BOOST_CHECK_EQUAL(grant.type(), tlv::TokenGrant);
+
+  // the MAC is hidden from everyone but its user
+  AccessToken unwrapped = AccessToken::unwrap(grant, backend, privateKey);
+  BOOST_CHECK_EQUAL(unwrapped.getUserId(), "alice");
+  BOOST_CHECK_EQUAL(unwrapped.getExpiry(), 1500000000000);
+  BOOST_CHECK(unwrapped.getMac() == token.getMac());
+  BOOST_CHECK_THROW(AccessToken::unwrap(grant, backend, otherKey), envelope::Error);
+
+  BOOST_CHECK_THROW(AccessToken::unwrap(token.wireEncode(), backend, privateKey),
+                    AccessToken::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestAccessToken
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/crypto-backend.hpp"
+#include "core/envelope.hpp"
+#include "core/key-store.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_AUTO_TEST_SUITE(TestCryptoBackend)
+
+BOOST_AUTO_TEST_CASE(Registry)
+{
+  BOOST_CHECK_EQUAL(CryptoBackend::getDefault().getName(), "rsa");
+  BOOST_CHECK_EQUAL(CryptoBackend::get("ecies").getType(), CryptoBackend::ECIES_P256);
+  BOOST_CHECK_EQUAL(&CryptoBackend::get(CryptoBackend::RSA_OAEP), &CryptoBackend::get("rsa"));
+  BOOST_CHECK_THROW(CryptoBackend::get("unknown"), CryptoBackend::Error);
+  BOOST_CHECK_THROW(CryptoBackend::get(static_cast<uint64_t>(0)), CryptoBackend::Error);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  const std::string text = "HELLO WORLD";
+  for (const auto& name : CryptoBackend::getNames()) {
+    BOOST_TEST_MESSAGE(name);
+    const CryptoBackend& backend = CryptoBackend::get(name);
+
+    CryptoPP::AutoSeededRandomPool rng;
+    shared_ptr<const CryptoPP::PrivateKey> privateKey = backend.generatePrivateKey(rng);
+    shared_ptr<const CryptoPP::PublicKey> publicKey = backend.makePublicKey(*privateKey);
+
+    Buffer sealed = envelope::seal(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                                   backend, publicKey);
+    Buffer opened = envelope::open(sealed.data(), sealed.size(), backend, privateKey);
+    BOOST_CHECK_EQUAL(std::string(opened.begin(), opened.end()), text);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WrappedKeySize)
+{
+  CryptoPP::AutoSeededRandomPool rng;
+  Buffer contentKey = envelope::generateContentKey();
+  std::map<std::string, size_t> sizes;
+  for (const auto& name : CryptoBackend::getNames()) {
+    const CryptoBackend& backend = CryptoBackend::get(name);
+    auto publicKey = backend.makePublicKey(*backend.generatePrivateKey(rng));
+    sizes[name] = envelope::wrapKey(contentKey, backend, publicKey).size();
+    BOOST_TEST_MESSAGE(name << " wrapped key: " << sizes[name] << " octets");
+  }
+  BOOST_CHECK_LT(sizes["ecies"], sizes["rsa"]);
+}
+
+BOOST_AUTO_TEST_CASE(AlgorithmMismatch)
+{
+  CryptoPP::AutoSeededRandomPool rng;
+  const CryptoBackend& rsa = CryptoBackend::get("rsa");
+  const CryptoBackend& ecies = CryptoBackend::get("ecies");
+  shared_ptr<const CryptoPP::PrivateKey> rsaKey = rsa.generatePrivateKey(rng);
+  shared_ptr<const CryptoPP::PrivateKey> eciesKey = ecies.generatePrivateKey(rng);
+
+  Buffer sealed = envelope::seal(nullptr, 0, ecies, ecies.makePublicKey(*eciesKey));
+  BOOST_CHECK_THROW(envelope::open(sealed.data(), sealed.size(), rsa, rsaKey), envelope::Error);
+
+  // a key of another backend is rejected rather than misinterpreted
+  BOOST_CHECK_THROW(rsa.makeDecryptor(*eciesKey), CryptoBackend::Error);
+}
+
+BOOST_AUTO_TEST_CASE(KeyStorePersistence)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "crypto-backend";
+  for (const auto& name : CryptoBackend::getNames()) {
+    BOOST_TEST_MESSAGE(name);
+    boost::filesystem::remove_all(directory);
+    const CryptoBackend& backend = CryptoBackend::get(name);
+
+    KeyStore first(directory.string(), backend);
+    first.loadOrGenerate();
+    BOOST_CHECK(first.isGenerated());
+
+    KeyStore second(directory.string(), backend);
+    second.loadOrGenerate();
+    BOOST_CHECK(!second.isGenerated());
+
+    Buffer sealed = envelope::seal(nullptr, 0, backend, first.getPublicKey());
+    BOOST_CHECK_NO_THROW(envelope::open(sealed.data(), sealed.size(), backend,
+                                        second.getPrivateKey()));
+  }
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCryptoBackend
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/crypto-context.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <thread>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class CryptoContextFixture
+{
+protected:
+  CryptoContextFixture()
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    privateKey = backend.generatePrivateKey(rng);
+    publicKey = backend.makePublicKey(*privateKey);
+    CryptoContext::get().clear();
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  shared_ptr<const CryptoPP::PrivateKey> privateKey;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+};
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_FIXTURE_TEST_SUITE(TestCryptoContext, CryptoContextFixture)
+
+BOOST_AUTO_TEST_CASE(Caching)
+{
+  CryptoContext& context = CryptoContext::get();
+  BOOST_CHECK_EQUAL(context.size(), 0);
+
+  const CryptoPP::PK_Encryptor& e1 = context.getEncryptor(backend, publicKey);
+  const CryptoPP::PK_Encryptor& e2 = context.getEncryptor(backend, publicKey);
+  BOOST_CHECK_EQUAL(&e1, &e2);
+
+  // an equal key in a different object is a different identity
+  shared_ptr<const CryptoPP::PublicKey> copy = backend.makePublicKey(*privateKey);
+  BOOST_CHECK_NE(&context.getEncryptor(backend, copy), &e1);
+
+  context.getDecryptor(backend, privateKey);
+  BOOST_CHECK_EQUAL(context.size(), 3);
+
+  context.clear();
+  BOOST_CHECK_EQUAL(context.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(PerThread)
+{
+  CryptoContext* other = nullptr;
+  std::thread t([&other] { other = &CryptoContext::get(); });
+  t.join();
+  BOOST_CHECK_NE(other, &CryptoContext::get());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCryptoContext
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
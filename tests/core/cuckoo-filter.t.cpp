@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/cuckoo-filter.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_AUTO_TEST_SUITE(TestCuckooFilter)
+
+BOOST_AUTO_TEST_CASE(InsertRemove)
+{
+  CuckooFilter filter(100, 0.01);
+  BOOST_CHECK_EQUAL(filter.getFingerprintSize(), 10);
+  BOOST_CHECK_EQUAL(filter.getNBuckets(), 32);
+  BOOST_CHECK(!filter.contains("alice"));
+
+  BOOST_CHECK(filter.insert("alice"));
+  BOOST_CHECK(filter.insert("bob"));
+  BOOST_CHECK_EQUAL(filter.size(), 2);
+  BOOST_CHECK(filter.contains("alice"));
+  BOOST_CHECK(filter.contains("bob"));
+
+  BOOST_CHECK(filter.remove("alice"));
+  BOOST_CHECK_EQUAL(filter.size(), 1);
+  BOOST_CHECK(!filter.contains("alice"));
+  BOOST_CHECK(filter.contains("bob"));
+  BOOST_CHECK(!filter.remove("alice"));
+}
+
+BOOST_AUTO_TEST_CASE(FalsePositiveRate)
+{
+  const size_t N_USERS = 10000;
+  CuckooFilter filter(N_USERS, 0.01);
+  for (size_t i = 0; i < N_USERS; ++i) {
+    BOOST_REQUIRE(filter.insert("user" + std::to_string(i)));
+  }
+
+  // no user that was inserted is missed
+  size_t nMissed = 0;
+  for (size_t i = 0; i < N_USERS; ++i) {
+    nMissed += !filter.contains("user" + std::to_string(i));
+  }
+  BOOST_CHECK_EQUAL(nMissed, 0);
+
+  size_t nFalsePositives = 0;
+  for (size_t i = 0; i < 100000; ++i) {
+    nFalsePositives += filter.contains("other" + std::to_string(i));
+  }
+  BOOST_CHECK_LE(nFalsePositives, 2000);
+
+  // 10-bit fingerprints, and at most two slots per user as buckets are a power of two
+  BOOST_CHECK_LE(filter.getTableSize(), N_USERS * 10 * 2 / 8 + 8);
+}
+
+BOOST_AUTO_TEST_CASE(Full)
+{
+  CuckooFilter filter(8, 0.5);
+  size_t nInserted = 0;
+  while (filter.insert("user" + std::to_string(nInserted))) {
+    ++nInserted;
+  }
+  BOOST_CHECK_EQUAL(filter.size(), nInserted);
+  BOOST_CHECK_LE(nInserted, filter.getNBuckets() * CuckooFilter::BUCKET_SIZE);
+
+  // the fingerprints moved by a failed insertion are back in place
+  for (size_t i = 0; i < nInserted; ++i) {
+    BOOST_CHECK(filter.contains("user" + std::to_string(i)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Encoding)
+{
+  CuckooFilter filter(1000, 0.001);
+  for (size_t i = 0; i < 700; ++i) {
+    filter.insert("user" + std::to_string(i));
+  }
+  filter.remove("user5");
+
+  Block wire = filter.wireEncode();
+  BOOST_CHECK_EQUAL(wire.type(), tlv::UserFilter);
+  CuckooFilter decoded(wire);
+  BOOST_CHECK_EQUAL(decoded.size(), filter.size());
+  BOOST_CHECK_EQUAL(decoded.getNBuckets(), filter.getNBuckets());
+  BOOST_CHECK_EQUAL(decoded.getFingerprintSize(), filter.getFingerprintSize());
+  for (size_t i = 0; i < 1000; ++i) {
+    std::string userId = "user" + std::to_string(i);
+    BOOST_CHECK_EQUAL(decoded.contains(userId), filter.contains(userId));
+  }
+  BOOST_CHECK(decoded.wireEncode() == wire);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  BOOST_CHECK_THROW(CuckooFilter(makeStringBlock(tlv::UserId, "alice")), CuckooFilter::Error);
+
+  auto makeWire = [] (uint64_t fingerprintSize, uint64_t nBuckets, size_t tableSize) {
+    Block wire(tlv::UserFilter);
+    wire.push_back(makeNonNegativeIntegerBlock(tlv::FingerprintSize, fingerprintSize));
+    wire.push_back(makeNonNegativeIntegerBlock(tlv::BucketCount, nBuckets));
+    std::vector<uint8_t> table(tableSize);
+    wire.push_back(makeBinaryBlock(tlv::FilterTable, table.data(), table.size()));
+    wire.encode();
+    return wire;
+  };
+  BOOST_CHECK_NO_THROW(CuckooFilter(makeWire(8, 4, 16)));
+  BOOST_CHECK_THROW(CuckooFilter(makeWire(2, 4, 4)), CuckooFilter::Error);
+  BOOST_CHECK_THROW(CuckooFilter(makeWire(8, 3, 12)), CuckooFilter::Error);
+  BOOST_CHECK_THROW(CuckooFilter(makeWire(8, 4, 15)), CuckooFilter::Error);
+
+  Block noTable(tlv::UserFilter);
+  noTable.push_back(makeNonNegativeIntegerBlock(tlv::FingerprintSize, 8));
+  noTable.push_back(makeNonNegativeIntegerBlock(tlv::BucketCount, 4));
+  noTable.encode();
+  BOOST_CHECK_THROW(CuckooFilter{noTable}, CuckooFilter::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCuckooFilter
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
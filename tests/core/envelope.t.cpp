@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/envelope.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class EnvelopeFixture
+{
+protected:
+  EnvelopeFixture()
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    privateKey = backend.generatePrivateKey(rng);
+    publicKey = backend.makePublicKey(*privateKey);
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  shared_ptr<const CryptoPP::PrivateKey> privateKey;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+};
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_FIXTURE_TEST_SUITE(TestEnvelope, EnvelopeFixture)
+
+BOOST_AUTO_TEST_CASE(HeaderEncoding)
+{
+  envelope::Header header;
+  BOOST_CHECK_EQUAL(header.getAlgorithm(), CryptoBackend::RSA_OAEP);
+  header.setAlgorithm(CryptoBackend::ECIES_P256);
+  header.setWrappedKey(Buffer(128));
+  header.setInitialVector(envelope::generateInitialVector());
+
+  envelope::Header decoded(header.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getAlgorithm(), CryptoBackend::ECIES_P256);
+  BOOST_CHECK(decoded.getWrappedKey() == header.getWrappedKey());
+  BOOST_CHECK(decoded.getInitialVector() == header.getInitialVector());
+
+  // headers written before Algorithm existed are RSA-OAEP
+  Buffer iv = envelope::generateInitialVector();
+  EncodingBuffer encoder;
+  size_t length = encoding::prependByteArrayBlock(encoder, tlv::InitialVector, iv.data(), iv.size());
+  length += encoding::prependByteArrayBlock(encoder, tlv::WrappedKey, iv.data(), iv.size());
+  encoder.prependVarNumber(length);
+  encoder.prependVarNumber(tlv::EnvelopeHeader);
+  BOOST_CHECK_EQUAL(envelope::Header(encoder.block()).getAlgorithm(), CryptoBackend::RSA_OAEP);
+
+  BOOST_CHECK_THROW(envelope::Header(makeBinaryBlock(tlv::WrappedKey, nullptr, 0)),
+                    envelope::Error);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  // a payload much larger than a single RSA block
+  Buffer payload(4 * 1024 * 1024);
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<uint8_t>(i * 31);
+  }
+
+  Buffer sealed = envelope::seal(payload.data(), payload.size(), backend, publicKey);
+  BOOST_CHECK_LT(sealed.size(), payload.size() + 256);
+
+  Buffer opened = envelope::open(sealed.data(), sealed.size(), backend, privateKey);
+  BOOST_CHECK(opened == payload);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyPayload)
+{
+  Buffer sealed = envelope::seal(nullptr, 0, backend, publicKey);
+  Buffer opened = envelope::open(sealed.data(), sealed.size(), backend, privateKey);
+  BOOST_CHECK_EQUAL(opened.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Tampered)
+{
+  const std::string text = "HELLO WORLD";
+  Buffer sealed = envelope::seal(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                                 backend, publicKey);
+  sealed.back() ^= 0x01;
+  BOOST_CHECK_THROW(envelope::open(sealed.data(), sealed.size(), backend, privateKey), envelope::Error);
+}
+
+BOOST_AUTO_TEST_CASE(WrongKey)
+{
+  CryptoPP::AutoSeededRandomPool rng;
+  shared_ptr<const CryptoPP::PrivateKey> otherKey = backend.generatePrivateKey(rng);
+
+  const std::string text = "HELLO WORLD";
+  Buffer sealed = envelope::seal(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                                 backend, publicKey);
+  BOOST_CHECK_THROW(envelope::open(sealed.data(), sealed.size(), backend, otherKey), envelope::Error);
+}
+
+BOOST_AUTO_TEST_CASE(SymmetricWrap)
+{
+  Buffer key = envelope::generateContentKey();
+  Buffer wrappingKey = envelope::generateContentKey();
+  Buffer wrapped = envelope::wrapKey(key, wrappingKey);
+  BOOST_CHECK_EQUAL(wrapped.size(), envelope::IV_SIZE + key.size() + envelope::TAG_SIZE);
+  BOOST_CHECK(envelope::unwrapKey(wrapped, wrappingKey) == key);
+
+  // the initial vector is random
+  BOOST_CHECK(envelope::wrapKey(key, wrappingKey) != wrapped);
+
+  BOOST_CHECK_THROW(envelope::unwrapKey(wrapped, envelope::generateContentKey()),
+                    envelope::Error);
+  wrapped[envelope::IV_SIZE] ^= 1;
+  BOOST_CHECK_THROW(envelope::unwrapKey(wrapped, wrappingKey), envelope::Error);
+  BOOST_CHECK_THROW(envelope::unwrapKey(Buffer(8), wrappingKey), envelope::Error);
+}
+
+BOOST_AUTO_TEST_CASE(SealStream)
+{
+  const size_t chunkSize = 1000;
+  for (size_t size : {0, 1, 999, 1000, 1001, 3000, 12345}) {
+    BOOST_TEST_MESSAGE("payload size " << size);
+    std::string payload(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+      payload[i] = static_cast<char>(i * 31);
+    }
+
+    std::istringstream input(payload);
+    Block content = envelope::sealStream(input, envelope::generateContentKey(), backend,
+                                         publicKey, chunkSize);
+    BOOST_CHECK_EQUAL(content.type(), ndn::tlv::Content);
+    BOOST_CHECK_NO_THROW(Block(content.wire(), content.size()));
+
+    size_t headerSize = 0;
+    envelope::Header header = envelope::decodeHeader(content.value(), content.value_size(),
+                                                     headerSize);
+    BOOST_CHECK_EQUAL(header.getChunkSize(), chunkSize);
+    size_t nChunks = std::max<size_t>(1, (size + chunkSize - 1) / chunkSize);
+    BOOST_CHECK_EQUAL(content.value_size(), headerSize + size + nChunks * envelope::TAG_SIZE);
+
+    Buffer opened = envelope::open(content.value(), content.value_size(), backend, privateKey);
+    BOOST_CHECK_EQUAL(std::string(opened.begin(), opened.end()), payload);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedSink)
+{
+  std::string payload(2500, 'x');
+  std::istringstream input(payload);
+  Buffer contentKey = envelope::generateContentKey();
+  Block content = envelope::sealStream(input, contentKey, backend, publicKey, 1000);
+
+  size_t headerSize = 0;
+  envelope::Header header = envelope::decodeHeader(content.value(), content.value_size(),
+                                                   headerSize);
+  std::vector<size_t> chunks;
+  std::string output;
+  envelope::openPayload(header, contentKey, content.value() + headerSize,
+                        content.value_size() - headerSize,
+                        [&] (const uint8_t* data, size_t size) {
+                          chunks.push_back(size);
+                          output.append(reinterpret_cast<const char*>(data), size);
+                        });
+  BOOST_CHECK_EQUAL(output, payload);
+  std::vector<size_t> expectedChunks{1000, 1000, 500};
+  BOOST_CHECK_EQUAL_COLLECTIONS(chunks.begin(), chunks.end(),
+                                expectedChunks.begin(), expectedChunks.end());
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedTampering)
+{
+  std::string payload(3000, 'x');
+  std::istringstream input(payload);
+  Buffer contentKey = envelope::generateContentKey();
+  Block content = envelope::sealStream(input, contentKey, backend, publicKey, 1000);
+
+  size_t headerSize = 0;
+  envelope::Header header = envelope::decodeHeader(content.value(), content.value_size(),
+                                                   headerSize);
+  Buffer chunks(content.value() + headerSize, content.value_end());
+  const size_t encryptedChunkSize = 1000 + envelope::TAG_SIZE;
+
+  // truncated at a chunk boundary: the new last chunk was not sealed as the last one
+  BOOST_CHECK_THROW(envelope::openPayload(header, contentKey, chunks.data(),
+                                          2 * encryptedChunkSize),
+                    envelope::Error);
+
+  // reordered chunks
+  Buffer reordered(chunks);
+  std::swap_ranges(reordered.begin(), reordered.begin() + encryptedChunkSize,
+                   reordered.begin() + encryptedChunkSize);
+  BOOST_CHECK_THROW(envelope::openPayload(header, contentKey, reordered.data(), reordered.size()),
+                    envelope::Error);
+
+  // a partial chunk shorter than the tag
+  BOOST_CHECK_THROW(envelope::openPayload(header, contentKey, chunks.data(),
+                                          encryptedChunkSize + envelope::TAG_SIZE - 1),
+                    envelope::Error);
+
+  BOOST_CHECK(envelope::openPayload(header, contentKey, chunks.data(), chunks.size()) ==
+              Buffer(payload.data(), payload.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestEnvelope
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
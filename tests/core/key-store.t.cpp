@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/key-store.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class KeyStoreFixture
+{
+protected:
+  KeyStoreFixture()
+    : directory(boost::filesystem::path(TMP_TESTS_PATH) / "key-store")
+  {
+    boost::filesystem::remove_all(directory);
+  }
+
+  ~KeyStoreFixture()
+  {
+    boost::filesystem::remove_all(directory);
+  }
+
+protected:
+  boost::filesystem::path directory;
+};
+
+static std::string
+encodeKey(const CryptoPP::CryptoMaterial& key)
+{
+  std::string der;
+  CryptoPP::StringSink sink(der);
+  key.Save(sink);
+  return der;
+}
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_FIXTURE_TEST_SUITE(TestKeyStore, KeyStoreFixture)
+
+BOOST_AUTO_TEST_CASE(GenerateThenLoad)
+{
+  KeyStore first(directory.string());
+  first.loadOrGenerate();
+
+  BOOST_CHECK(first.isGenerated());
+  BOOST_CHECK(boost::filesystem::exists(first.getPublicKeyFile()));
+  BOOST_CHECK(boost::filesystem::exists(first.getPrivateKeyFile()));
+
+  KeyStore second(directory.string());
+  second.loadOrGenerate();
+
+  BOOST_CHECK(!second.isGenerated());
+  BOOST_CHECK(encodeKey(*second.getPublicKey()) == encodeKey(*first.getPublicKey()));
+  BOOST_CHECK(encodeKey(*second.getPrivateKey()) == encodeKey(*first.getPrivateKey()));
+}
+
+BOOST_AUTO_TEST_CASE(PrivateKeyMode)
+{
+  namespace fs = boost::filesystem;
+
+  // a temporary file left readable by others does not make the new private key readable
+  KeyStore store(directory.string());
+  fs::create_directories(directory);
+  std::string tmpFile = store.getPrivateKeyFile() + ".tmp";
+  std::ofstream(tmpFile) << "leftover";
+  fs::permissions(tmpFile, fs::owner_read | fs::owner_write | fs::group_read | fs::others_read);
+  store.loadOrGenerate();
+
+  BOOST_CHECK(store.isGenerated());
+  BOOST_CHECK((fs::status(store.getPrivateKeyFile()).permissions() & fs::all_all) ==
+              (fs::owner_read | fs::owner_write));
+  BOOST_CHECK(!fs::exists(tmpFile));
+}
+
+BOOST_AUTO_TEST_CASE(MissingPrivateKey)
+{
+  KeyStore first(directory.string());
+  first.loadOrGenerate();
+  boost::filesystem::remove(first.getPrivateKeyFile());
+
+  KeyStore second(directory.string());
+  BOOST_CHECK_THROW(second.loadOrGenerate(), KeyStore::Error);
+  BOOST_CHECK(boost::filesystem::exists(first.getPublicKeyFile()));
+}
+
+BOOST_AUTO_TEST_CASE(MismatchedKeys)
+{
+  KeyStore first(directory.string());
+  first.loadOrGenerate();
+
+  CryptoPP::AutoSeededRandomPool rng;
+  const CryptoBackend& backend = first.getBackend();
+  KeyStore::saveKey(first.getPublicKeyFile(),
+                    *backend.makePublicKey(*backend.generatePrivateKey(rng)));
+
+  KeyStore second(directory.string());
+  BOOST_CHECK_THROW(second.loadOrGenerate(), KeyStore::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestKeyStore
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
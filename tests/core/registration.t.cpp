@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/registration.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class RegistrationFixture
+{
+protected:
+  RegistrationFixture()
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    rsaKey = rsa.makePublicKey(*rsa.generatePrivateKey(rng));
+    eciesKey = ecies.makePublicKey(*ecies.generatePrivateKey(rng));
+  }
+
+protected:
+  const CryptoBackend& rsa = CryptoBackend::get("rsa");
+  const CryptoBackend& ecies = CryptoBackend::get("ecies");
+  shared_ptr<const CryptoPP::PublicKey> rsaKey;
+  shared_ptr<const CryptoPP::PublicKey> eciesKey;
+};
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_FIXTURE_TEST_SUITE(TestRegistration, RegistrationFixture)
+
+BOOST_AUTO_TEST_CASE(Encoding)
+{
+  Registration registration;
+  registration.add("alice", *rsaKey, rsa);
+  registration.add("bob", *eciesKey, ecies);
+  registration.add("carol", *rsaKey, rsa);
+  BOOST_CHECK_EQUAL(registration.size(), 3);
+
+  Registration decoded(registration.wireEncode());
+  BOOST_REQUIRE_EQUAL(decoded.size(), 3);
+  const auto& entries = decoded.getEntries();
+  BOOST_CHECK_EQUAL(entries[0].userId, "alice");
+  BOOST_CHECK_EQUAL(entries[0].algorithm, CryptoBackend::RSA_OAEP);
+  BOOST_CHECK_EQUAL(entries[1].userId, "bob");
+  BOOST_CHECK_EQUAL(entries[1].algorithm, CryptoBackend::ECIES_P256);
+  BOOST_CHECK_EQUAL(entries[2].userId, "carol");
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const Buffer& key = registration.getEntries()[i].publicKey;
+    BOOST_CHECK_EQUAL_COLLECTIONS(entries[i].publicKey.begin(), entries[i].publicKey.end(),
+                                  key.begin(), key.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DefaultAlgorithm)
+{
+  Block entry(tlv::UserRegistration);
+  entry.push_back(makeStringBlock(tlv::UserId, "alice"));
+  entry.push_back(makeBinaryBlock(tlv::PublicKey, "\x30\x00", 2));
+  entry.encode();
+  Block wire(tlv::Registration);
+  wire.push_back(entry);
+  wire.encode();
+
+  Registration decoded(wire);
+  BOOST_REQUIRE_EQUAL(decoded.size(), 1);
+  BOOST_CHECK_EQUAL(decoded.getEntries()[0].userId, "alice");
+  BOOST_CHECK_EQUAL(decoded.getEntries()[0].algorithm, CryptoBackend::RSA_OAEP);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  BOOST_CHECK_THROW(Registration(makeStringBlock(tlv::UserId, "alice")), Registration::Error);
+
+  // a registration must carry at least one user
+  Block empty(tlv::Registration);
+  empty.encode();
+  BOOST_CHECK_THROW(Registration{empty}, Registration::Error);
+
+  // a user without a key
+  Block entry(tlv::UserRegistration);
+  entry.push_back(makeStringBlock(tlv::UserId, "alice"));
+  entry.encode();
+  Block wire(tlv::Registration);
+  wire.push_back(entry);
+  wire.encode();
+  BOOST_CHECK_THROW(Registration{wire}, Registration::Error);
+}
+
+BOOST_AUTO_TEST_CASE(CommandName)
+{
+  Registration registration;
+  registration.add("alice", *rsaKey, rsa);
+
+  Name prefix("/epac/provider");
+  Name name = registration.getCommandName(prefix);
+  BOOST_REQUIRE_EQUAL(name.size(), prefix.size() + 2);
+  BOOST_CHECK(prefix.isPrefixOf(name));
+  BOOST_CHECK_EQUAL(name[prefix.size()], Registration::COMMAND_COMPONENT);
+
+  Registration decoded(name[prefix.size() + 1].blockFromValue());
+  BOOST_REQUIRE_EQUAL(decoded.size(), 1);
+  BOOST_CHECK_EQUAL(decoded.getEntries()[0].userId, "alice");
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestRegistration
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
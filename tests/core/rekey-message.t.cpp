@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/rekey-message.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_AUTO_TEST_SUITE(TestRekeyMessage)
+
+BOOST_AUTO_TEST_CASE(Encoding)
+{
+  RekeyMessage message(1500000000000);
+  message.addForUser(3, "alice", Buffer(256));
+  message.addForNode(4294967297, 3, 1500000000000, Buffer(44));
+  message.addForNode(4294967297, 2, 1499999999999, Buffer(44));
+  BOOST_CHECK_EQUAL(message.size(), 3);
+
+  RekeyMessage decoded(message.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getEpoch(), 1500000000000);
+  BOOST_REQUIRE_EQUAL(decoded.size(), 3);
+  const auto& entries = decoded.getEntries();
+  BOOST_CHECK_EQUAL(entries[0].node, 3);
+  BOOST_CHECK_EQUAL(entries[0].userId, "alice");
+  BOOST_CHECK_EQUAL(entries[0].wrappedKey.size(), 256);
+  BOOST_CHECK_EQUAL(entries[1].node, 4294967297);
+  BOOST_CHECK(entries[1].userId.empty());
+  BOOST_CHECK_EQUAL(entries[1].wrappingNode, 3);
+  BOOST_CHECK_EQUAL(entries[1].wrappingVersion, 1500000000000);
+  BOOST_CHECK_EQUAL(entries[2].wrappingNode, 2);
+  BOOST_CHECK_EQUAL(entries[2].wrappingVersion, 1499999999999);
+  BOOST_CHECK_EQUAL(entries[2].wrappedKey.size(), 44);
+
+  // a change that leaves a group empty carries no keys
+  RekeyMessage empty(7);
+  BOOST_CHECK_EQUAL(RekeyMessage(empty.wireEncode()).size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  BOOST_CHECK_THROW(RekeyMessage(makeStringBlock(tlv::UserId, "alice")), RekeyMessage::Error);
+
+  // a message without epoch
+  Block noEpoch(tlv::RekeyMessage);
+  noEpoch.encode();
+  BOOST_CHECK_THROW(RekeyMessage{noEpoch}, RekeyMessage::Error);
+
+  // an entry wrapped neither for a user nor under a node
+  Block entry(tlv::RekeyEntry);
+  entry.push_back(makeNonNegativeIntegerBlock(tlv::KeyNode, 1));
+  entry.push_back(makeBinaryBlock(tlv::WrappedKey, "\x00", 1));
+  entry.encode();
+  Block wire(tlv::RekeyMessage);
+  wire.push_back(makeNonNegativeIntegerBlock(tlv::KeyVersion, 1));
+  wire.push_back(entry);
+  wire.encode();
+  BOOST_CHECK_THROW(RekeyMessage{wire}, RekeyMessage::Error);
+}
+
+BOOST_AUTO_TEST_CASE(DataName)
+{
+  Name prefix("/epac/provider");
+  Name name = RekeyMessage::getName(prefix, "staff", 42);
+  BOOST_REQUIRE_EQUAL(name.size(), prefix.size() + 3);
+  BOOST_CHECK(prefix.isPrefixOf(name));
+  BOOST_CHECK_EQUAL(name[prefix.size()], RekeyMessage::NAME_COMPONENT);
+  BOOST_CHECK_EQUAL(name[prefix.size() + 1].toUri(), "staff");
+  BOOST_CHECK_EQUAL(name[-1].toVersion(), 42);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestRekeyMessage
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "core/worker-pool.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <atomic>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Core)
+BOOST_AUTO_TEST_SUITE(TestWorkerPool)
+
+BOOST_AUTO_TEST_CASE(ParallelFor)
+{
+  WorkerPool pool(4);
+  std::vector<int> values(1000, 0);
+  std::atomic<size_t> nOutsidePool(0);
+  pool.parallelFor(values.size(), [&] (size_t begin, size_t end) {
+    if (!pool.isWorkerThread()) {
+      ++nOutsidePool;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      values[i] = static_cast<int>(i);
+    }
+  });
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    BOOST_REQUIRE_EQUAL(values[i], static_cast<int>(i));
+  }
+  BOOST_CHECK_EQUAL(nOutsidePool, 0);
+  BOOST_CHECK(!pool.isWorkerThread());
+
+  BOOST_CHECK_THROW(pool.parallelFor(10, [] (size_t, size_t) {
+                      throw std::runtime_error("task failed");
+                    }),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch)
+{
+  WorkerPool pool(2);
+  boost::asio::io_service io;
+  std::thread::id ioThread = std::this_thread::get_id();
+
+  int result = 0;
+  std::atomic<size_t> nInner(0);
+  pool.dispatch<int>(io,
+    [&] {
+      // parallelFor from a dispatched task runs on the calling worker instead of deadlocking
+      pool.parallelFor(100, [&] (size_t begin, size_t end) { nInner += end - begin; });
+      return 42;
+    },
+    [&] (const int& value) {
+      BOOST_CHECK(std::this_thread::get_id() == ioThread);
+      result = value;
+    },
+    [] (std::exception_ptr) {
+      BOOST_ERROR("unexpected error");
+    });
+
+  std::string error;
+  pool.dispatch<int>(io,
+    [] () -> int { throw std::runtime_error("task failed"); },
+    [] (const int&) {
+      BOOST_ERROR("unexpected result");
+    },
+    [&] (std::exception_ptr e) {
+      try {
+        std::rethrow_exception(e);
+      }
+      catch (const std::runtime_error& e) {
+        error = e.what();
+      }
+    });
+
+  // one callback of each dispatch
+  boost::asio::io_service::work work(io);
+  io.run_one();
+  io.run_one();
+  BOOST_CHECK_EQUAL(result, 42);
+  BOOST_CHECK_EQUAL(nInner, 100);
+  BOOST_CHECK_EQUAL(error, "task failed");
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestWorkerPool
+BOOST_AUTO_TEST_SUITE_END() // Core
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/access-group.hpp"
+
+#include "tests/test-common.hpp"
+
+#include "core/envelope.hpp"
+#include "core/group-key-ring.hpp"
+
+#include <random>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class AccessGroupFixture
+{
+protected:
+  AccessGroupFixture()
+    : group("staff", 1000)
+  {
+    // users share one key pair: the rings tell them apart by user id
+    CryptoPP::AutoSeededRandomPool rng;
+    privateKey = backend.generatePrivateKey(rng);
+    publicKey = backend.makePublicKey(*privateKey);
+  }
+
+  GroupKeyRing&
+  getRing(const std::string& userId)
+  {
+    auto& ring = rings[userId];
+    if (ring == nullptr) {
+      ring = make_unique<GroupKeyRing>(userId, backend, privateKey);
+    }
+    return *ring;
+  }
+
+  /**
+   * @brief deliver @p message to every user that has been a member, as published
+   */
+  void
+  deliver(const RekeyMessage& message)
+  {
+    RekeyMessage decoded(message.wireEncode());
+    for (auto& ring : rings) {
+      ring.second->apply(decoded);
+    }
+  }
+
+  void
+  add(const std::string& userId)
+  {
+    getRing(userId);
+    RekeyMessage message = group.add(userId, backend, publicKey);
+    BOOST_CHECK_EQUAL(message.getEpoch(), group.getEpoch());
+    BOOST_CHECK_LE(message.size(), 2 * group.getDepth() + 1);
+    deliver(message);
+  }
+
+  void
+  remove(const std::string& userId)
+  {
+    RekeyMessage message = group.remove(userId);
+    BOOST_CHECK_LE(message.size(), 2 * group.getDepth());
+    deliver(message);
+  }
+
+  /**
+   * @return whether @p userId can unwrap a content key wrapped for the group now
+   */
+  bool
+  canUnwrap(const std::string& userId)
+  {
+    Buffer contentKey = envelope::generateContentKey();
+    KeyWrapBundle bundle({}, {group.wrap(contentKey)});
+    const KeyWrapBundle::GroupEntry* entry = KeyWrapBundle(bundle.wireEncode()).findGroup("staff");
+    BOOST_REQUIRE(entry != nullptr);
+    try {
+      return getRing(userId).unwrapContentKey(*entry) == contentKey;
+    }
+    catch (const envelope::Error&) {
+      return false;
+    }
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::get("ecies");
+  shared_ptr<const CryptoPP::PrivateKey> privateKey;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+  AccessGroup group;
+  std::map<std::string, unique_ptr<GroupKeyRing>> rings;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestAccessGroup, AccessGroupFixture)
+
+BOOST_AUTO_TEST_CASE(Join)
+{
+  BOOST_CHECK_THROW(group.wrap(envelope::generateContentKey()), AccessGroup::Error);
+
+  // a single member holds the group key as its leaf key
+  add("alice");
+  BOOST_CHECK_EQUAL(group.getDepth(), 0);
+  BOOST_CHECK(canUnwrap("alice"));
+
+  // the tree grows a level each time its leaves are full
+  add("bob");
+  BOOST_CHECK_EQUAL(group.getDepth(), 1);
+  add("carol");
+  add("dave");
+  BOOST_CHECK_EQUAL(group.getDepth(), 2);
+  add("erin");
+  BOOST_CHECK_EQUAL(group.getDepth(), 3);
+  BOOST_CHECK_EQUAL(group.size(), 5);
+  BOOST_CHECK_EQUAL(group.getEpoch(), 1005);
+
+  for (const auto& userId : {"alice", "bob", "carol", "dave", "erin"}) {
+    BOOST_CHECK(canUnwrap(userId));
+  }
+  BOOST_CHECK(!canUnwrap("mallory"));
+
+  BOOST_CHECK_THROW(group.add("alice", backend, publicKey), AccessGroup::Error);
+}
+
+BOOST_AUTO_TEST_CASE(BackwardSecrecy)
+{
+  add("alice");
+  add("bob");
+  Buffer contentKey = envelope::generateContentKey();
+  KeyWrapBundle::GroupEntry before = group.wrap(contentKey);
+
+  add("carol");
+  BOOST_CHECK_THROW(getRing("carol").unwrapContentKey(before), envelope::Error);
+  BOOST_CHECK(getRing("alice").unwrapContentKey(before) == contentKey);
+  BOOST_CHECK(canUnwrap("carol"));
+}
+
+BOOST_AUTO_TEST_CASE(Revoke)
+{
+  for (const auto& userId : {"alice", "bob", "carol", "dave", "erin"}) {
+    add(userId);
+  }
+
+  remove("carol");
+  BOOST_CHECK(!group.contains("carol"));
+  BOOST_CHECK(!canUnwrap("carol"));
+  for (const auto& userId : {"alice", "bob", "dave", "erin"}) {
+    BOOST_CHECK(canUnwrap(userId));
+  }
+  BOOST_CHECK_THROW(group.remove("carol"), AccessGroup::Error);
+
+  // the leaf of a member that left is taken by the next one
+  add("frank");
+  BOOST_CHECK_EQUAL(group.getDepth(), 3);
+  BOOST_CHECK(canUnwrap("frank"));
+  BOOST_CHECK(!canUnwrap("carol"));
+
+  // the last member leaving empties the group
+  for (const auto& userId : {"alice", "bob", "dave", "erin", "frank"}) {
+    remove(userId);
+  }
+  BOOST_CHECK_EQUAL(group.size(), 0);
+  BOOST_CHECK_THROW(group.wrap(envelope::generateContentKey()), AccessGroup::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Random)
+{
+  std::mt19937 random(11);
+  std::set<std::string> members;
+  std::set<std::string> former;
+  for (int i = 0; i < 300; ++i) {
+    std::string userId = "user" + std::to_string(random() % 100);
+    if (members.count(userId) > 0) {
+      remove(userId);
+      members.erase(userId);
+      former.insert(userId);
+    }
+    else {
+      add(userId);
+      members.insert(userId);
+      former.erase(userId);
+    }
+  }
+  BOOST_CHECK_EQUAL(group.size(), members.size());
+  BOOST_CHECK_LE(group.getDepth(), 7);
+
+  for (const auto& userId : members) {
+    BOOST_CHECK(canUnwrap(userId));
+  }
+  for (const auto& userId : former) {
+    BOOST_CHECK(!canUnwrap(userId));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestAccessGroup
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,477 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/active-user-table.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <set>
+#include <thread>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ActiveUserTableFixture : public UnitTestTimeFixture
+{
+protected:
+  ActiveUserTableFixture()
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    publicKey = backend.makePublicKey(*backend.generatePrivateKey(rng));
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+  ActiveUserTable aut;
+};
+
+static std::string
+encodeKey(const CryptoPP::PublicKey& key)
+{
+  std::string der;
+  CryptoPP::StringSink sink(der);
+  key.Save(sink);
+  return der;
+}
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestActiveUserTable, ActiveUserTableFixture)
+
+BOOST_AUTO_TEST_CASE(AddFind)
+{
+  BOOST_CHECK(aut.find("alice") == nullptr);
+  BOOST_CHECK(aut.findPublicKeyByUserId("alice") == nullptr);
+
+  BOOST_CHECK(aut.add("alice", publicKey, backend));
+  BOOST_CHECK(aut.add("bob", publicKey, backend));
+  BOOST_CHECK_EQUAL(aut.size(), 2);
+
+  shared_ptr<const ActiveUserTable::User> alice = aut.find("alice");
+  BOOST_REQUIRE(alice != nullptr);
+  BOOST_CHECK_EQUAL(alice->userId, "alice");
+  BOOST_CHECK(alice->publicKey == publicKey);
+  BOOST_CHECK(alice->backend == &backend);
+  BOOST_REQUIRE(alice->encryptor != nullptr);
+  BOOST_CHECK(aut.findPublicKeyByUserId("bob") == publicKey);
+
+  // a user added again is replaced
+  CryptoPP::AutoSeededRandomPool rng;
+  auto otherKey = backend.makePublicKey(*backend.generatePrivateKey(rng));
+  BOOST_CHECK(!aut.add("alice", otherKey, backend));
+  BOOST_CHECK_EQUAL(aut.size(), 2);
+  BOOST_CHECK(aut.findPublicKeyByUserId("alice") == otherKey);
+}
+
+BOOST_AUTO_TEST_CASE(WrongBackend)
+{
+  const CryptoBackend& rsa = CryptoBackend::get("rsa");
+  const CryptoBackend& ecies = CryptoBackend::get("ecies");
+  CryptoPP::AutoSeededRandomPool rng;
+  auto eciesKey = ecies.makePublicKey(*ecies.generatePrivateKey(rng));
+
+  BOOST_CHECK_THROW(aut.add("alice", eciesKey, rsa), CryptoBackend::Error);
+  BOOST_CHECK_EQUAL(aut.size(), 0);
+  BOOST_CHECK(aut.find("alice") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Remove)
+{
+  const size_t N_USERS = 1000;
+  for (size_t i = 0; i < N_USERS; ++i) {
+    aut.add("user" + std::to_string(i), publicKey, backend);
+  }
+  BOOST_CHECK_EQUAL(aut.size(), N_USERS);
+
+  // remove every third user; the others stay reachable after slots are shifted back
+  for (size_t i = 0; i < N_USERS; i += 3) {
+    BOOST_CHECK(aut.remove("user" + std::to_string(i)));
+  }
+  BOOST_CHECK(!aut.remove("user0"));
+  BOOST_CHECK(!aut.remove("nobody"));
+  BOOST_CHECK_EQUAL(aut.size(), N_USERS - (N_USERS + 2) / 3);
+
+  for (size_t i = 0; i < N_USERS; ++i) {
+    std::string userId = "user" + std::to_string(i);
+    shared_ptr<const ActiveUserTable::User> user = aut.find(userId);
+    if (i % 3 == 0) {
+      BOOST_CHECK(user == nullptr);
+    }
+    else {
+      BOOST_REQUIRE(user != nullptr);
+      BOOST_CHECK_EQUAL(user->userId, userId);
+    }
+  }
+
+  std::set<std::string> iterated;
+  for (const auto& user : aut.getUsers()) {
+    iterated.insert(user->userId);
+  }
+  BOOST_CHECK_EQUAL(iterated.size(), aut.size());
+}
+
+BOOST_AUTO_TEST_CASE(Persistence)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "users";
+  boost::filesystem::remove_all(directory);
+
+  CryptoPP::AutoSeededRandomPool rng;
+  auto otherKey = backend.makePublicKey(*backend.generatePrivateKey(rng));
+  {
+    ActiveUserTable table;
+    table.open(directory.string());
+    for (int i = 0; i < 10; ++i) {
+      table.add("user" + std::to_string(i), publicKey, backend);
+    }
+    table.saveSnapshot();
+    BOOST_CHECK_EQUAL(table.getNLoggedChanges(), 0);
+
+    // changes after the snapshot go to the log
+    table.remove("user3");
+    table.add("user4", otherKey, backend);
+    table.add("user10", otherKey, backend);
+    BOOST_CHECK_EQUAL(table.getNLoggedChanges(), 3);
+    BOOST_CHECK_EQUAL(table.size(), 10);
+  }
+
+  ActiveUserTable table;
+  table.open(directory.string());
+  BOOST_CHECK_EQUAL(table.size(), 10);
+  BOOST_CHECK_EQUAL(table.getNLoggedChanges(), 3);
+  BOOST_CHECK(table.find("user3") == nullptr);
+
+  // users of the snapshot are decoded when looked up
+  shared_ptr<const ActiveUserTable::User> user = table.find("user5");
+  BOOST_REQUIRE(user != nullptr);
+  BOOST_CHECK_EQUAL(user->userId, "user5");
+  BOOST_CHECK(user->backend == &backend);
+  BOOST_CHECK(user->encryptor != nullptr);
+  BOOST_CHECK_EQUAL(encodeKey(*user->publicKey), encodeKey(*publicKey));
+  BOOST_CHECK(table.find("user5") == user);
+  BOOST_CHECK_EQUAL(encodeKey(*table.findPublicKeyByUserId("user4")), encodeKey(*otherKey));
+
+  std::set<std::string> iterated;
+  for (const auto& item : table.getUsers()) {
+    iterated.insert(item->userId);
+  }
+  BOOST_CHECK_EQUAL(iterated.size(), 10);
+  BOOST_CHECK_EQUAL(iterated.count("user3"), 0);
+  BOOST_CHECK_EQUAL(iterated.count("user10"), 1);
+
+  // removing a user of the snapshot hides it
+  BOOST_CHECK(table.remove("user5"));
+  BOOST_CHECK(!table.remove("user5"));
+  BOOST_CHECK(table.find("user5") == nullptr);
+  BOOST_CHECK_EQUAL(table.size(), 9);
+
+  table.saveSnapshot();
+  BOOST_CHECK_EQUAL(table.size(), 9);
+  BOOST_CHECK(table.find("user5") == nullptr);
+  BOOST_CHECK(table.find("user10") != nullptr);
+
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  aut.setTtl(time::seconds(10));
+  aut.add("alice", publicKey, backend);
+  aut.add("bob", publicKey, backend);
+  aut.add("carol", publicKey, backend);
+
+  size_t nExpired = 0;
+  for (int i = 0; i < 8; ++i) {
+    steadyClock->advance(time::seconds(1));
+    nExpired += aut.expire();
+  }
+  BOOST_CHECK_EQUAL(nExpired, 0);
+
+  // bob is looked up and carol registered again, so only alice expires at 10s
+  BOOST_CHECK(aut.find("bob") != nullptr);
+  BOOST_CHECK(!aut.add("carol", publicKey, backend));
+  for (int i = 0; i < 2; ++i) {
+    steadyClock->advance(time::seconds(1));
+    nExpired += aut.expire();
+  }
+  BOOST_CHECK_EQUAL(nExpired, 1);
+  BOOST_CHECK(aut.find("alice") == nullptr);
+  BOOST_CHECK_EQUAL(aut.size(), 2);
+
+  // the others expire 10s after they were last active
+  steadyClock->advance(time::seconds(7));
+  BOOST_CHECK_EQUAL(aut.expire(), 0);
+  steadyClock->advance(time::seconds(1));
+  BOOST_CHECK_EQUAL(aut.expire(), 2);
+  BOOST_CHECK_EQUAL(aut.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SnapshotExpiry)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "users";
+  boost::filesystem::remove_all(directory);
+  {
+    ActiveUserTable table;
+    table.open(directory.string());
+    for (int i = 0; i < 5; ++i) {
+      table.add("user" + std::to_string(i), publicKey, backend);
+    }
+    table.saveSnapshot();
+  }
+
+  // users of the snapshot expire together, except those looked up meanwhile
+  aut.setTtl(time::seconds(10));
+  aut.open(directory.string());
+  steadyClock->advance(time::seconds(5));
+  BOOST_CHECK_EQUAL(aut.expire(), 0);
+  BOOST_CHECK(aut.find("user1") != nullptr);
+
+  steadyClock->advance(time::seconds(5));
+  BOOST_CHECK_EQUAL(aut.expire(), 4);
+  BOOST_CHECK_EQUAL(aut.size(), 1);
+  BOOST_CHECK(aut.find("user0") == nullptr);
+  BOOST_CHECK(aut.find("user1") != nullptr);
+  BOOST_CHECK_EQUAL(aut.getNLoggedChanges(), 0);
+
+  // the expiry is persisted once the snapshot is saved
+  BOOST_CHECK(aut.isSnapshotStale());
+  aut.saveSnapshot();
+  BOOST_CHECK(!aut.isSnapshotStale());
+  {
+    ActiveUserTable table;
+    table.open(directory.string());
+    BOOST_CHECK_EQUAL(table.size(), 1);
+    BOOST_CHECK(table.find("user0") == nullptr);
+  }
+
+  steadyClock->advance(time::seconds(10));
+  BOOST_CHECK_EQUAL(aut.expire(), 1);
+  BOOST_CHECK_EQUAL(aut.size(), 0);
+
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(SaveSnapshotExpiry)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "users";
+  boost::filesystem::remove_all(directory);
+  {
+    ActiveUserTable table;
+    table.open(directory.string());
+    for (int i = 0; i < 5; ++i) {
+      table.add("user" + std::to_string(i), publicKey, backend);
+    }
+    table.saveSnapshot();
+  }
+
+  // a snapshot saved meanwhile keeps the users of the old one, and when they expire
+  aut.setTtl(time::seconds(10));
+  aut.open(directory.string());
+  steadyClock->advance(time::seconds(5));
+  BOOST_CHECK(aut.find("user1") != nullptr);
+  aut.add("dave", publicKey, backend);
+  aut.saveSnapshot();
+  BOOST_CHECK_EQUAL(aut.size(), 6);
+
+  steadyClock->advance(time::seconds(5));
+  BOOST_CHECK_EQUAL(aut.expire(), 4);
+  BOOST_CHECK_EQUAL(aut.size(), 2);
+  BOOST_CHECK(aut.find("user0") == nullptr);
+  BOOST_CHECK(aut.find("user1") != nullptr);
+  BOOST_CHECK(aut.find("dave") != nullptr);
+
+  steadyClock->advance(time::seconds(10));
+  BOOST_CHECK_EQUAL(aut.expire(), 2);
+  BOOST_CHECK_EQUAL(aut.size(), 0);
+
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(Filter)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "users";
+  boost::filesystem::remove_all(directory);
+  {
+    ActiveUserTable table;
+    table.open(directory.string());
+    for (int i = 0; i < 5; ++i) {
+      table.add("user" + std::to_string(i), publicKey, backend);
+    }
+    table.saveSnapshot();
+    table.add("user5", publicKey, backend);
+  }
+
+  // users of the snapshot and of the log are in the filter once the table is opened
+  aut.setTtl(time::seconds(10));
+  aut.setFilterRate(0.001);
+  aut.open(directory.string());
+  CuckooFilter filter(aut.exportFilter());
+  BOOST_CHECK_EQUAL(filter.size(), 6);
+  for (int i = 0; i < 6; ++i) {
+    BOOST_CHECK(filter.contains("user" + std::to_string(i)));
+  }
+
+  uint64_t nChanges = aut.getNFilterChanges();
+  aut.add("alice", publicKey, backend);
+  aut.remove("user2");
+  BOOST_CHECK_EQUAL(aut.getNFilterChanges(), nChanges + 2);
+  filter.wireDecode(aut.exportFilter());
+  BOOST_CHECK_EQUAL(filter.size(), 6);
+  BOOST_CHECK(filter.contains("alice"));
+  BOOST_CHECK(!filter.contains("user2"));
+
+  // replacing a user leaves the filter as it is
+  nChanges = aut.getNFilterChanges();
+  aut.add("alice", publicKey, backend);
+  aut.add("user3", publicKey, backend);
+  BOOST_CHECK_EQUAL(aut.getNFilterChanges(), nChanges);
+
+  // expired users leave the filter, whether in memory or in the snapshot
+  steadyClock->advance(time::seconds(5));
+  aut.expire();
+  BOOST_CHECK(aut.find("user1") != nullptr);
+  steadyClock->advance(time::seconds(5));
+  BOOST_CHECK_EQUAL(aut.expire(), 5);
+  BOOST_CHECK_EQUAL(aut.size(), 1);
+  filter.wireDecode(aut.exportFilter());
+  BOOST_CHECK_EQUAL(filter.size(), aut.size());
+  BOOST_CHECK(filter.contains("user1"));
+  BOOST_CHECK(!filter.contains("user0"));
+
+  // the filter grows with the table
+  for (int i = 0; i < 5000; ++i) {
+    aut.add("bulk" + std::to_string(i), publicKey, backend);
+  }
+  filter.wireDecode(aut.exportFilter());
+  BOOST_CHECK_EQUAL(filter.size(), aut.size());
+  for (int i = 0; i < 5000; ++i) {
+    BOOST_CHECK(filter.contains("bulk" + std::to_string(i)));
+  }
+
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentAccess)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "users";
+  boost::filesystem::remove_all(directory);
+
+  // stable users are never changed, and must be found throughout; volatile users are added,
+  // replaced and removed meanwhile, and the snapshot is saved again and again
+  const int N_STABLE = 500;
+  const int N_VOLATILE = 100;
+  const int N_ROUNDS = 20;
+  aut.open(directory.string());
+  for (int i = 0; i < N_STABLE; ++i) {
+    aut.add("stable" + std::to_string(i), publicKey, backend);
+  }
+  aut.saveSnapshot();
+
+  std::atomic<bool> isDone(false);
+  std::atomic<size_t> nErrors(0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&, t] {
+      size_t n = t;
+      while (!isDone) {
+        std::string stableId = "stable" + std::to_string(n % N_STABLE);
+        auto stable = aut.find(stableId);
+        if (stable == nullptr || stable->userId != stableId || stable->encryptor == nullptr) {
+          ++nErrors;
+        }
+
+        std::string volatileId = "volatile" + std::to_string(n % N_VOLATILE);
+        auto user = aut.find(volatileId);
+        if (user != nullptr && user->userId != volatileId) {
+          ++nErrors;
+        }
+
+        if (n % 1000 == 0) {
+          auto users = aut.getUsers();
+          if (users.size() < static_cast<size_t>(N_STABLE)) {
+            ++nErrors;
+          }
+        }
+        n += 7;
+      }
+    });
+  }
+
+  CryptoPP::AutoSeededRandomPool rng;
+  auto otherKey = backend.makePublicKey(*backend.generatePrivateKey(rng));
+  for (int round = 0; round < N_ROUNDS; ++round) {
+    for (int i = 0; i < N_VOLATILE; ++i) {
+      aut.add("volatile" + std::to_string(i), (round + i) % 2 == 0 ? publicKey : otherKey,
+              backend);
+    }
+    for (int i = round % 3; i < N_VOLATILE; i += 3) {
+      aut.remove("volatile" + std::to_string(i));
+    }
+    if (round % 5 == 4) {
+      aut.saveSnapshot();
+    }
+  }
+  isDone = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  BOOST_CHECK_EQUAL(nErrors, 0);
+  // the last round removed every third volatile user
+  int nVolatile = N_VOLATILE - (N_VOLATILE - (N_ROUNDS - 1) % 3 + 2) / 3;
+  BOOST_CHECK_EQUAL(aut.size(), static_cast<size_t>(N_STABLE + nVolatile));
+  BOOST_CHECK_EQUAL(aut.getUsers().size(), aut.size());
+
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(SaveWhileChanging)
+{
+  boost::filesystem::path directory = boost::filesystem::path(TMP_TESTS_PATH) / "users";
+  boost::filesystem::remove_all(directory);
+
+  aut.open(directory.string());
+  for (int i = 0; i < 200; ++i) {
+    aut.add("old" + std::to_string(i), publicKey, backend);
+  }
+  aut.saveSnapshot();
+
+  // changes made while a snapshot is written stay logged on top of it
+  std::atomic<bool> isDone(false);
+  std::thread saver([&] {
+    while (!isDone) {
+      aut.saveSnapshot();
+    }
+  });
+  for (int i = 0; i < 300; ++i) {
+    aut.add("new" + std::to_string(i), publicKey, backend);
+    if (i < 200) {
+      aut.remove("old" + std::to_string(i));
+    }
+  }
+  isDone = true;
+  saver.join();
+  BOOST_CHECK_EQUAL(aut.size(), 300);
+  BOOST_CHECK_EQUAL(aut.getUsers().size(), 300);
+
+  ActiveUserTable table;
+  table.open(directory.string());
+  BOOST_CHECK_EQUAL(table.size(), 300);
+  BOOST_CHECK_EQUAL(table.getUsers().size(), 300);
+  BOOST_CHECK(table.find("old0") == nullptr);
+  BOOST_CHECK(table.find("old199") == nullptr);
+  BOOST_CHECK(table.find("new0") != nullptr);
+  BOOST_CHECK(table.find("new299") != nullptr);
+
+  boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestActiveUserTable
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,289 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/content-index.hpp"
+#include "core/crypto-backend.hpp"
+#include "core/key-wrap-bundle.hpp"
+#include "provider/segmenter.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ContentIndexFixture
+{
+protected:
+  ContentIndexFixture()
+    : index(store)
+  {
+  }
+
+  static ContentIndex::Publication
+  makeSingle(const Name& name)
+  {
+    ContentIndex::Publication publication;
+    publication.name = name;
+    publication.packets.push_back(makeData(name));
+    return publication;
+  }
+
+  static ContentIndex::Publication
+  makeSegmented(const Name& versionedName, size_t nSegments, bool hasKeyBundle = false)
+  {
+    ContentIndex::Publication publication;
+    publication.name = versionedName;
+    publication.isSegmented = true;
+    for (size_t i = 0; i < nSegments; ++i) {
+      publication.packets.push_back(makeData(Name(versionedName).appendSegment(i)));
+    }
+    if (hasKeyBundle) {
+      publication.keyBundle = makeKeyBundle(versionedName, 2);
+    }
+    return publication;
+  }
+
+  static std::vector<shared_ptr<const Data>>
+  makeKeyBundle(const Name& versionedName, size_t nSegments)
+  {
+    std::vector<shared_ptr<const Data>> segments;
+    for (size_t i = 0; i < nSegments; ++i) {
+      segments.push_back(makeData(Name(versionedName).append("KEYS").appendVersion(1)
+                                    .appendSegment(i)));
+    }
+    return segments;
+  }
+
+  shared_ptr<const Data>
+  find(const Name& name)
+  {
+    return index.find(*makeInterest(name));
+  }
+
+protected:
+  ContentStore store;
+  ContentIndex index;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestContentIndex, ContentIndexFixture)
+
+BOOST_AUTO_TEST_CASE(Single)
+{
+  index.insert(makeSingle("/epac/a"));
+  index.insert(makeSingle("/epac/b"));
+  BOOST_CHECK_EQUAL(index.size(), 2);
+
+  auto data = find("/epac/a");
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), "/epac/a");
+
+  data = find("/epac/b");
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), "/epac/b");
+
+  BOOST_CHECK(find("/epac/c") == nullptr);
+  BOOST_CHECK(find("/epac/a/0") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Segments)
+{
+  Name name = Name("/epac/doc").appendVersion(1);
+  index.insert(makeSegmented(name, 3, true));
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    auto data = find(Name(name).appendSegment(i));
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK_EQUAL(data->getName(), Name(name).appendSegment(i));
+  }
+  BOOST_CHECK(find(Name(name).appendSegment(3)) == nullptr);
+
+  // the key bundle without version or segment answers with its first segment
+  Name bundleName = Name(name).append("KEYS").appendVersion(1);
+  auto bundle = find(Name(name).append("KEYS"));
+  BOOST_REQUIRE(bundle != nullptr);
+  BOOST_CHECK_EQUAL(bundle->getName(), Name(bundleName).appendSegment(0));
+  BOOST_CHECK(find(bundleName) == bundle);
+  bundle = find(Name(bundleName).appendSegment(1));
+  BOOST_REQUIRE(bundle != nullptr);
+  BOOST_CHECK_EQUAL(bundle->getName(), Name(bundleName).appendSegment(1));
+  BOOST_CHECK(find(Name(bundleName).appendSegment(2)) == nullptr);
+  BOOST_CHECK(find(Name(name).append("KEYS").appendVersion(2)) == nullptr);
+
+  // versioned name without segment answers with the first segment
+  auto first = find(name);
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK_EQUAL(first->getName(), Name(name).appendSegment(0));
+}
+
+BOOST_AUTO_TEST_CASE(Discovery)
+{
+  index.insert(makeSegmented(Name("/epac/doc").appendVersion(1), 2));
+  index.insert(makeSegmented(Name("/epac/doc").appendVersion(5), 2));
+  index.insert(makeSegmented(Name("/epac/doc").appendVersion(3), 2));
+  index.insert(makeSingle("/epac/other"));
+
+  auto data = find("/epac/doc");
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name("/epac/doc").appendVersion(5).appendSegment(0));
+
+  BOOST_CHECK(find("/epac/do") == nullptr);
+  BOOST_CHECK(find("/epac/doc2") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(EraseAndReplace)
+{
+  index.insert(makeSegmented(Name("/epac/doc").appendVersion(1), 4));
+  index.insert(makeSegmented(Name("/epac/doc").appendVersion(1), 2));
+  BOOST_CHECK_EQUAL(index.size(), 1);
+
+  const ContentIndex::Entry* publication =
+    index.findPublication(Name("/epac/doc").appendVersion(1));
+  BOOST_REQUIRE(publication != nullptr);
+  BOOST_CHECK_EQUAL(publication->nPackets, 2);
+  BOOST_CHECK_EQUAL(store.size(), 2);
+  BOOST_CHECK(find(Name("/epac/doc").appendVersion(1).appendSegment(3)) == nullptr);
+
+  BOOST_CHECK(index.erase(Name("/epac/doc").appendVersion(1)));
+  BOOST_CHECK(!index.erase(Name("/epac/doc").appendVersion(1)));
+  BOOST_CHECK_EQUAL(index.size(), 0);
+  BOOST_CHECK_EQUAL(store.size(), 0);
+  BOOST_CHECK(find("/epac/doc") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Lazy)
+{
+  Name name = Name("/epac/lazy").appendVersion(1);
+  std::vector<Name> made;
+  int nKeyBundlesMade = 0;
+  index.insert(name, 3,
+    [&] {
+      ++nKeyBundlesMade;
+      return makeKeyBundle(name, 2);
+    },
+    [&] (const Name& dataName) {
+      made.push_back(dataName);
+      return makeData(dataName);
+    });
+  BOOST_CHECK_EQUAL(store.size(), 0);
+
+  // the key bundle can only be asked for without version until it is made
+  BOOST_CHECK(find(Name(name).append("KEYS").appendVersion(1)) == nullptr);
+  BOOST_CHECK_EQUAL(nKeyBundlesMade, 0);
+
+  auto data = find(Name(name).appendSegment(2));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name(name).appendSegment(2));
+  BOOST_CHECK(find(Name(name).appendSegment(3)) == nullptr);
+
+  // made once, then answered from the store
+  BOOST_CHECK(find(Name(name).appendSegment(2)) == data);
+  BOOST_CHECK(find(Name(name).append("KEYS")) != nullptr);
+  BOOST_CHECK(find(Name(name).append("KEYS").appendVersion(1).appendSegment(1)) != nullptr);
+  BOOST_CHECK(find(Name(name).append("KEYS")) != nullptr);
+  BOOST_CHECK_EQUAL(nKeyBundlesMade, 1);
+  BOOST_CHECK(find("/epac/lazy") != nullptr);
+
+  std::vector<Name> expected{Name(name).appendSegment(2), Name(name).appendSegment(0)};
+  BOOST_CHECK_EQUAL_COLLECTIONS(made.begin(), made.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(store.size(), 4);
+
+  BOOST_CHECK(index.erase(name));
+  BOOST_CHECK_EQUAL(store.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LazyKeyBundleMadeWhenAvailable)
+{
+  Name name = Name("/epac/lazy").appendVersion(1);
+  size_t nUsers = 0;
+  index.insert(name, 1,
+    [&] {
+      // there is no bundle to make while no user is registered
+      return nUsers > 0 ? makeKeyBundle(name, 1) : std::vector<shared_ptr<const Data>>();
+    },
+    [] (const Name& dataName) { return makeData(dataName); });
+
+  BOOST_CHECK(find(Name(name).append("KEYS")) == nullptr);
+  BOOST_CHECK(index.findPublication(name)->keyBundleName.empty());
+
+  nUsers = 1;
+  auto bundle = find(Name(name).append("KEYS"));
+  BOOST_REQUIRE(bundle != nullptr);
+  BOOST_CHECK_EQUAL(bundle->getName(), Name(name).append("KEYS").appendVersion(1).appendSegment(0));
+}
+
+BOOST_AUTO_TEST_CASE(Live)
+{
+  Name name = Name("/epac/live").appendVersion(1);
+  index.insertLive(name, {});
+  BOOST_CHECK(find(name) == nullptr);
+  BOOST_CHECK(find(Name(name).appendSegment(0)) == nullptr);
+
+  auto first = makeData(Name(name).appendSegment(0));
+  BOOST_CHECK(index.appendSegment(name, first, false));
+  auto second = makeData(Name(name).appendSegment(1));
+  BOOST_CHECK(index.appendSegment(name, second, false));
+
+  // the latest segment is advertised while the publication is live
+  BOOST_CHECK(find(name) == second);
+  BOOST_CHECK(find("/epac/live") == second);
+  BOOST_CHECK(find(Name(name).appendSegment(0)) == first);
+  BOOST_CHECK(find(Name(name).appendSegment(2)) == nullptr);
+
+  auto last = makeData(Name(name).appendSegment(2));
+  last->setFinalBlockId(name::Component::fromSegment(2));
+  signData(last);
+  BOOST_CHECK(index.appendSegment(name, last, true));
+  BOOST_CHECK(!index.appendSegment(name, makeData(Name(name).appendSegment(3)), false));
+
+  BOOST_CHECK(find(Name(name).appendSegment(2)) == last);
+  BOOST_CHECK(find(name) == first);
+  BOOST_CHECK_EQUAL(index.findPublication(name)->nPackets, 3);
+}
+
+BOOST_AUTO_TEST_CASE(LargeKeyBundle)
+{
+  // 2048-bit RSA wraps every content key into 256 octets
+  std::vector<KeyWrapBundle::Entry> entries(500);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    entries[i].userId = "user" + std::to_string(i);
+    entries[i].algorithm = CryptoBackend::RSA_OAEP;
+    entries[i].wrappedKey = Buffer(256);
+  }
+  Block wire = KeyWrapBundle(entries).wireEncode();
+  BOOST_CHECK_GT(wire.size(), MAX_NDN_PACKET_SIZE);
+
+  Name name = Name("/epac/doc").appendVersion(1);
+  ContentIndex::Publication publication = makeSegmented(name, 1);
+  for (const auto& segment : Segmenter::split(Name(name).append("KEYS").appendVersion(2), wire))
+    publication.keyBundle.push_back(signData(segment));
+  index.insert(publication);
+
+  auto first = find(Name(name).append("KEYS"));
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_REQUIRE(!first->getFinalBlockId().empty());
+  uint64_t lastSegment = first->getFinalBlockId().toSegment();
+  BOOST_CHECK_EQUAL(lastSegment + 1, publication.keyBundle.size());
+
+  Buffer reassembled;
+  for (uint64_t i = 0; i <= lastSegment; ++i) {
+    auto segment = find(first->getName().getPrefix(-1).appendSegment(i));
+    BOOST_REQUIRE(segment != nullptr);
+    BOOST_CHECK_LE(segment->wireEncode().size(), MAX_NDN_PACKET_SIZE);
+    const Block& content = segment->getContent();
+    reassembled.insert(reassembled.end(), content.value_begin(), content.value_end());
+  }
+
+  KeyWrapBundle bundle(Block(reassembled.data(), reassembled.size()));
+  BOOST_CHECK_EQUAL(bundle.size(), entries.size());
+  BOOST_CHECK(bundle.find("user499") != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestContentIndex
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/content-store.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ContentStoreFixture
+{
+protected:
+  ContentStoreFixture()
+    : directory(boost::filesystem::path(TMP_TESTS_PATH) / "content-store")
+  {
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+  }
+
+  ~ContentStoreFixture()
+  {
+    boost::filesystem::remove_all(directory);
+  }
+
+  static shared_ptr<Data>
+  makePacket(size_t i)
+  {
+    std::vector<uint8_t> content(1000, static_cast<uint8_t>(i));
+    auto data = makeData(Name("/epac/store").appendSegment(i));
+    data->setContent(content.data(), content.size());
+    return signData(data);
+  }
+
+protected:
+  boost::filesystem::path directory;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestContentStore, ContentStoreFixture)
+
+BOOST_AUTO_TEST_CASE(Unbounded)
+{
+  ContentStore store;
+  for (size_t i = 0; i < 100; ++i) {
+    store.insert(makePacket(i));
+  }
+  BOOST_CHECK_EQUAL(store.size(), 100);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 0);
+
+  BOOST_CHECK(store.find(Name("/epac/store").appendSegment(42)) != nullptr);
+  BOOST_CHECK(store.find(Name("/epac/store").appendSegment(100)) == nullptr);
+  BOOST_CHECK_EQUAL(store.getCounters().nHits, 1);
+  BOOST_CHECK_EQUAL(store.getCounters().nMisses, 1);
+  BOOST_CHECK_EQUAL(store.getCounters().nEvictions, 0);
+}
+
+BOOST_AUTO_TEST_CASE(EvictAndSpill)
+{
+  size_t wireSize = makePacket(0)->wireEncode().size();
+  ContentStore store(4 * wireSize, directory.string());
+
+  std::vector<shared_ptr<Data>> packets;
+  for (size_t i = 0; i < 10; ++i) {
+    packets.push_back(makePacket(i));
+    store.insert(packets.back());
+    BOOST_CHECK_LE(store.getMemoryBytes(), store.getCapacity());
+  }
+  BOOST_CHECK_EQUAL(store.size(), 10);
+  BOOST_CHECK_EQUAL(store.getMemoryBytes(), 4 * wireSize);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 6 * wireSize);
+  BOOST_CHECK_EQUAL(store.getCounters().nEvictions, 6);
+
+  // packet 9 is hot, packet 0 comes back from the scratch file with the same wire
+  auto hot = store.find(packets[9]->getName());
+  BOOST_CHECK(hot == packets[9]);
+  BOOST_CHECK_EQUAL(store.getCounters().nHits, 1);
+
+  auto cold = store.find(packets[0]->getName());
+  BOOST_REQUIRE(cold != nullptr);
+  BOOST_CHECK(cold->wireEncode() == packets[0]->wireEncode());
+  BOOST_CHECK_EQUAL(store.getCounters().nSpillHits, 1);
+
+  // bringing packet 0 back evicted the least recently used packet 6, spilling it
+  BOOST_CHECK_EQUAL(store.getCounters().nEvictions, 7);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 7 * wireSize);
+
+  // packets 7 to 9 are spilled on their first eviction, packet 0 is not written again
+  for (size_t i = 1; i <= 4; ++i) {
+    store.find(packets[i]->getName());
+  }
+  BOOST_CHECK_EQUAL(store.getCounters().nEvictions, 11);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 10 * wireSize);
+
+  for (const auto& packet : packets) {
+    auto data = store.find(packet->getName());
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK(data->wireEncode() == packet->wireEncode());
+  }
+  BOOST_CHECK_LE(store.getMemoryBytes(), store.getCapacity());
+}
+
+BOOST_AUTO_TEST_CASE(EraseAndReplace)
+{
+  size_t wireSize = makePacket(0)->wireEncode().size();
+  ContentStore store(2 * wireSize, directory.string());
+  for (size_t i = 0; i < 4; ++i) {
+    store.insert(makePacket(i));
+  }
+
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 2 * wireSize);
+
+  BOOST_CHECK(store.erase(Name("/epac/store").appendSegment(0))); // spilled
+  BOOST_CHECK(store.erase(Name("/epac/store").appendSegment(3))); // in memory
+  BOOST_CHECK(!store.erase(Name("/epac/store").appendSegment(3)));
+  BOOST_CHECK_EQUAL(store.size(), 2);
+  BOOST_CHECK_EQUAL(store.getMemoryBytes(), wireSize);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), wireSize);
+  BOOST_CHECK_EQUAL(store.getFreeSpillBytes(), wireSize);
+
+  auto replacement = makePacket(7);
+  replacement->setName(Name("/epac/store").appendSegment(1));
+  signData(replacement);
+  store.insert(replacement); // replaces a spilled packet
+  BOOST_CHECK_EQUAL(store.size(), 2);
+  BOOST_CHECK(store.find(Name("/epac/store").appendSegment(1)) == replacement);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 0);
+  BOOST_CHECK_EQUAL(store.getFreeSpillBytes(), 2 * wireSize);
+
+  // the next two spills reuse the freed ranges
+  std::vector<shared_ptr<Data>> packets{makePacket(8), makePacket(9)};
+  for (const auto& packet : packets) {
+    store.insert(packet);
+  }
+  BOOST_CHECK_EQUAL(store.getCounters().nEvictions, 4);
+  BOOST_CHECK_EQUAL(store.getSpilledBytes(), 2 * wireSize);
+  BOOST_CHECK_EQUAL(store.getFreeSpillBytes(), 0);
+
+  for (size_t i : {1, 2}) {
+    auto data = store.find(Name("/epac/store").appendSegment(i));
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK_EQUAL(data->getContent().value()[0], i == 1 ? 7 : 2);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestContentStore
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/file-publication.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class FilePublicationFixture
+{
+protected:
+  FilePublicationFixture()
+    : directory(boost::filesystem::path(TMP_TESTS_PATH) / "file-publication")
+    , name(Name("/epac/files/a.txt").appendVersion(1449227841000))
+  {
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+
+    CryptoPP::AutoSeededRandomPool rng;
+    privateKey = backend.generatePrivateKey(rng);
+    publicKey = backend.makePublicKey(*privateKey);
+  }
+
+  ~FilePublicationFixture()
+  {
+    boost::filesystem::remove_all(directory);
+  }
+
+  std::string
+  writeFile(const std::string& content)
+  {
+    std::string path = (directory / "a.txt").string();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+    return path;
+  }
+
+  std::string
+  open(const Data& segment)
+  {
+    const Block& content = segment.getContent();
+    Buffer payload = envelope::open(content.value(), content.value_size(), backend, privateKey);
+    return std::string(payload.begin(), payload.end());
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  boost::filesystem::path directory;
+  Name name;
+  shared_ptr<const CryptoPP::PrivateKey> privateKey;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestFilePublication, FilePublicationFixture)
+
+BOOST_AUTO_TEST_CASE(Segments)
+{
+  std::string text;
+  for (int i = 0; i < 100; ++i) {
+    text += "line " + std::to_string(i) + "\n";
+  }
+  std::string path = writeFile(text);
+
+  FilePublication file(path, text.size(), name, 64, backend, publicKey);
+  BOOST_CHECK_EQUAL(file.getNSegments(), (text.size() + 63) / 64);
+
+  // segments may be requested in any order
+  std::vector<std::string> payloads(file.getNSegments());
+  for (uint64_t i = file.getNSegments(); i-- > 0;) {
+    auto segment = file.makeSegment(i);
+    BOOST_CHECK_EQUAL(segment->getName(), Name(name).appendSegment(i));
+    BOOST_CHECK_EQUAL(segment->getFinalBlockId().toSegment(), file.getNSegments() - 1);
+    payloads[i] = open(*segment);
+  }
+
+  std::string reassembled;
+  for (const auto& payload : payloads) {
+    BOOST_CHECK_LE(payload.size(), 64);
+    reassembled += payload;
+  }
+  BOOST_CHECK_EQUAL(reassembled, text);
+}
+
+BOOST_AUTO_TEST_CASE(ContentKey)
+{
+  std::string path = writeFile(std::string(200, 'x'));
+  FilePublication file(path, 200, name, 64, backend, publicKey);
+
+  Buffer contentKey = file.getContentKey();
+  auto segment = file.makeSegment(0);
+  BOOST_CHECK(file.getContentKey() == contentKey);
+
+  size_t headerSize = 0;
+  const Block& content = segment->getContent();
+  envelope::Header header = envelope::decodeHeader(content.value(), content.value_size(),
+                                                   headerSize);
+  BOOST_CHECK(envelope::unwrapKey(header.getWrappedKey(), backend, privateKey) == contentKey);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyFile)
+{
+  std::string path = writeFile("");
+  FilePublication file(path, 0, name, 64, backend, publicKey);
+  BOOST_REQUIRE_EQUAL(file.getNSegments(), 1);
+  BOOST_CHECK_EQUAL(open(*file.makeSegment(0)), "");
+}
+
+BOOST_AUTO_TEST_CASE(ChangedFile)
+{
+  std::string path = writeFile("HELLO WORLD");
+  FilePublication file(path, 5, name, 64, backend, publicKey);
+  BOOST_CHECK_THROW(file.makeSegment(0), FilePublication::Error);
+}
+
+BOOST_AUTO_TEST_CASE(ChangedAfterFirstSegment)
+{
+  std::string text(5000, 'x');
+  std::string path = writeFile(text);
+  FilePublication file(path, text.size(), name, 4096, backend, publicKey);
+  BOOST_CHECK_EQUAL(open(*file.makeSegment(0)), text.substr(0, 4096));
+
+  // the file is not kept open, so a change is noticed by the next segment
+  writeFile(text + "more");
+  BOOST_CHECK_THROW(file.makeSegment(1), FilePublication::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestFilePublication
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
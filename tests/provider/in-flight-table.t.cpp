@@ -0,0 +1,46 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/in-flight-table.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_AUTO_TEST_SUITE(TestInFlightTable)
+
+BOOST_AUTO_TEST_CASE(Coalesce)
+{
+  InFlightTable table;
+  Name segment = Name("/epac/doc").appendVersion(1).appendSegment(0);
+
+  BOOST_CHECK(table.add(segment, *makeInterest(segment, 1)));
+  BOOST_CHECK(!table.add(segment, *makeInterest(segment, 2)));
+  // discovery Interest waiting for the same first segment
+  BOOST_CHECK(!table.add(segment, *makeInterest("/epac/doc", 3)));
+  BOOST_CHECK(table.add("/epac/other", *makeInterest("/epac/other", 4)));
+  BOOST_CHECK_EQUAL(table.size(), 2);
+  BOOST_CHECK_EQUAL(table.getNCoalesced(), 2);
+
+  std::vector<Interest> interests = table.remove(segment);
+  BOOST_REQUIRE_EQUAL(interests.size(), 3);
+  BOOST_CHECK_EQUAL(interests[0].getNonce(), 1);
+  BOOST_CHECK_EQUAL(interests[2].getName(), "/epac/doc");
+  BOOST_CHECK_EQUAL(table.size(), 1);
+  BOOST_CHECK(table.remove(segment).empty());
+
+  // the packet is made again once the previous job has finished
+  BOOST_CHECK(table.add(segment, *makeInterest(segment, 5)));
+  BOOST_CHECK_EQUAL(table.getNCoalesced(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestInFlightTable
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
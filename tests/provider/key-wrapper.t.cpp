@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/key-wrapper.hpp"
+#include "core/envelope.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class KeyWrapperFixture
+{
+protected:
+  KeyWrapperFixture()
+    : pool(4)
+    , contentKey(envelope::generateContentKey())
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    for (int i = 0; i < 8; ++i) {
+      std::string uid = "user" + std::to_string(i);
+      auto privateKey = backend.generatePrivateKey(rng);
+      aut.add(uid, backend.makePublicKey(*privateKey));
+      privateKeys[uid] = privateKey;
+    }
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  WorkerPool pool;
+  ActiveUserTable aut;
+  std::map<std::string, shared_ptr<const CryptoPP::PrivateKey>> privateKeys;
+  Buffer contentKey;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestKeyWrapper, KeyWrapperFixture)
+
+BOOST_AUTO_TEST_CASE(WrapForAll)
+{
+  KeyWrapper wrapper(pool);
+  KeyWrapBundle bundle = wrapper.wrapForAll(contentKey, aut);
+  BOOST_REQUIRE_EQUAL(bundle.size(), aut.size());
+
+  // the bundle survives encoding and every user recovers the same content key
+  KeyWrapBundle decoded(bundle.wireEncode());
+  BOOST_REQUIRE_EQUAL(decoded.size(), bundle.size());
+  for (const auto& item : privateKeys) {
+    const KeyWrapBundle::Entry* entry = decoded.find(item.first);
+    BOOST_REQUIRE(entry != nullptr);
+    BOOST_CHECK_EQUAL(entry->algorithm, backend.getType());
+    BOOST_CHECK(envelope::unwrapKey(entry->wrappedKey, backend, item.second) == contentKey);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MixedBackends)
+{
+  // users registered with another backend get their key wrapped by that backend
+  const CryptoBackend& ecies = CryptoBackend::get(CryptoBackend::ECIES_P256);
+  CryptoPP::AutoSeededRandomPool rng;
+  for (int i = 0; i < 4; ++i) {
+    std::string uid = "ecies" + std::to_string(i);
+    auto privateKey = ecies.generatePrivateKey(rng);
+    aut.add(uid, ecies.makePublicKey(*privateKey), ecies);
+    privateKeys[uid] = privateKey;
+  }
+
+  KeyWrapper wrapper(pool);
+  KeyWrapBundle decoded(wrapper.wrapForAll(contentKey, aut).wireEncode());
+  BOOST_REQUIRE_EQUAL(decoded.size(), 12);
+  for (const auto& item : privateKeys) {
+    const KeyWrapBundle::Entry* entry = decoded.find(item.first);
+    BOOST_REQUIRE(entry != nullptr);
+    const CryptoBackend& entryBackend = item.first.compare(0, 5, "ecies") == 0 ? ecies : backend;
+    BOOST_CHECK_EQUAL(entry->algorithm, entryBackend.getType());
+    BOOST_CHECK(envelope::unwrapKey(entry->wrappedKey, CryptoBackend::get(entry->algorithm),
+                                    item.second) == contentKey);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WrapForUsers)
+{
+  KeyWrapper wrapper(pool);
+  KeyWrapBundle bundle = wrapper.wrapForUsers(contentKey, aut, {"user3", "user1", "nobody"});
+  BOOST_REQUIRE_EQUAL(bundle.size(), 2);
+  BOOST_CHECK_EQUAL(bundle.getEntries()[0].userId, "user1");
+  BOOST_CHECK_EQUAL(bundle.getEntries()[1].userId, "user3");
+  BOOST_CHECK(bundle.find("user2") == nullptr);
+  BOOST_CHECK(bundle.find("nobody") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+  KeyWrapper wrapper(pool);
+  KeyWrapBundle bundle = wrapper.wrapForAll(contentKey, ActiveUserTable());
+  BOOST_CHECK_EQUAL(bundle.size(), 0);
+  BOOST_CHECK_EQUAL(KeyWrapBundle(bundle.wireEncode()).size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestKeyWrapper
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/live-stream.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class LiveStreamFixture
+{
+protected:
+  LiveStreamFixture()
+    : name(Name("/epac/live").appendVersion(1449227841747))
+    , contentKey(envelope::generateContentKey())
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    privateKey = backend.generatePrivateKey(rng);
+    publicKey = backend.makePublicKey(*privateKey);
+    sealer.reset(new envelope::Sealer(contentKey, backend, publicKey));
+  }
+
+  std::vector<LiveStream::Piece>
+  write(LiveStream& stream, const std::string& input)
+  {
+    return stream.write(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  }
+
+  static std::string
+  toString(const LiveStream::Piece& piece)
+  {
+    return std::string(piece.payload->begin(), piece.payload->end());
+  }
+
+  std::string
+  open(const Data& segment)
+  {
+    const Block& content = segment.getContent();
+    Buffer payload = envelope::open(content.value(), content.value_size(), backend, privateKey);
+    return std::string(payload.begin(), payload.end());
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  Name name;
+  Buffer contentKey;
+  shared_ptr<const CryptoPP::PrivateKey> privateKey;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+  unique_ptr<envelope::Sealer> sealer;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestLiveStream, LiveStreamFixture)
+
+BOOST_AUTO_TEST_CASE(Pieces)
+{
+  LiveStream stream(*sealer, name, 10);
+
+  BOOST_CHECK(write(stream, "abc").empty());
+  BOOST_CHECK_EQUAL(stream.getPendingSize(), 3);
+
+  auto pieces = write(stream, "defghijklmnopqrstuvwxyz");
+  BOOST_REQUIRE_EQUAL(pieces.size(), 2);
+  BOOST_CHECK_EQUAL(pieces[0].segmentNo, 0);
+  BOOST_CHECK_EQUAL(toString(pieces[0]), "abcdefghij");
+  BOOST_CHECK_EQUAL(toString(pieces[1]), "klmnopqrst");
+  BOOST_CHECK(!pieces[1].isLast);
+  BOOST_CHECK_EQUAL(stream.getPendingSize(), 6);
+
+  pieces = stream.flush();
+  BOOST_REQUIRE_EQUAL(pieces.size(), 1);
+  BOOST_CHECK_EQUAL(pieces[0].segmentNo, 2);
+  BOOST_CHECK_EQUAL(toString(pieces[0]), "uvwxyz");
+  BOOST_CHECK(stream.flush().empty());
+
+  BOOST_CHECK(write(stream, "0123").empty());
+  LiveStream::Piece last = stream.close();
+  BOOST_CHECK_EQUAL(last.segmentNo, 3);
+  BOOST_CHECK_EQUAL(toString(last), "0123");
+  BOOST_CHECK(last.isLast);
+  BOOST_CHECK(stream.isClosed());
+  BOOST_CHECK_EQUAL(stream.getNPieces(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyLastPiece)
+{
+  LiveStream stream(*sealer, name, 4);
+  BOOST_CHECK_EQUAL(write(stream, "abcd").size(), 1);
+
+  // the input ended on a segment boundary: an empty segment carries FinalBlockId
+  LiveStream::Piece last = stream.close();
+  BOOST_CHECK_EQUAL(last.segmentNo, 1);
+  BOOST_CHECK(last.payload->empty());
+  BOOST_CHECK(last.isLast);
+}
+
+BOOST_AUTO_TEST_CASE(Segments)
+{
+  LiveStream stream(*sealer, name, 8);
+  auto pieces = write(stream, "HELLO WORLD, HELLO NDN");
+  pieces.push_back(stream.close());
+  BOOST_REQUIRE_EQUAL(pieces.size(), 3);
+
+  std::string reassembled;
+  for (const auto& piece : pieces) {
+    auto segment = stream.makeSegment(piece);
+    BOOST_CHECK_EQUAL(segment->getName(), Name(name).appendSegment(piece.segmentNo));
+    BOOST_CHECK_EQUAL(segment->getFinalBlockId().empty(), !piece.isLast);
+    reassembled += open(*segment);
+  }
+  BOOST_CHECK_EQUAL(pieces.back().segmentNo, 2);
+  BOOST_CHECK_EQUAL(reassembled, "HELLO WORLD, HELLO NDN");
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestLiveStream
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/name-tree.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_AUTO_TEST_SUITE(TestNameTree)
+
+BOOST_AUTO_TEST_CASE(InsertFind)
+{
+  NameTree<int> tree;
+  tree["/a/b"] = 1;
+  tree["/a/b/c"] = 2;
+  tree["/"] = 3;
+  BOOST_CHECK_EQUAL(tree.size(), 3);
+  BOOST_CHECK_EQUAL(tree.getNNodes(), 4);
+
+  BOOST_REQUIRE(tree.find("/a/b") != nullptr);
+  BOOST_CHECK_EQUAL(*tree.find("/a/b"), 1);
+  BOOST_CHECK_EQUAL(*tree.find("/a/b/c"), 2);
+  BOOST_CHECK_EQUAL(*tree.find("/"), 3);
+  BOOST_CHECK(tree.find("/a") == nullptr);
+  BOOST_CHECK(tree.find("/a/c") == nullptr);
+
+  // existing values are returned, not replaced
+  int* value = &tree["/a/b"];
+  BOOST_CHECK_EQUAL(*value, 1);
+  BOOST_CHECK_EQUAL(tree.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(LongestPrefix)
+{
+  NameTree<int> tree;
+  BOOST_CHECK(tree.findLongestPrefix("/a/b/c") == nullptr);
+
+  tree["/a"] = 1;
+  tree["/a/b/c"] = 3;
+
+  BOOST_CHECK_EQUAL(*tree.findLongestPrefix("/a"), 1);
+  BOOST_CHECK_EQUAL(*tree.findLongestPrefix("/a/b"), 1);
+  BOOST_CHECK_EQUAL(*tree.findLongestPrefix("/a/b/c"), 3);
+  BOOST_CHECK_EQUAL(*tree.findLongestPrefix("/a/b/c/d/e"), 3);
+  BOOST_CHECK_EQUAL(*tree.findLongestPrefix("/a/x/c"), 1);
+  BOOST_CHECK(tree.findLongestPrefix("/b") == nullptr);
+
+  tree["/"] = 0;
+  BOOST_CHECK_EQUAL(*tree.findLongestPrefix("/b"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Last)
+{
+  NameTree<int> tree;
+  tree[Name("/doc").appendVersion(1)] = 1;
+  tree[Name("/doc").appendVersion(5)] = 5;
+  tree[Name("/doc").appendVersion(3)] = 3;
+  tree["/doc2"] = 10;
+  tree["/doc"] = 0;
+
+  BOOST_CHECK_EQUAL(*tree.findLast("/doc"), 5);
+  BOOST_CHECK_EQUAL(*tree.findLast("/"), 10);
+  BOOST_CHECK(tree.findLast(Name("/doc").appendVersion(5)) == nullptr);
+  BOOST_CHECK(tree.findLast("/do") == nullptr);
+
+  // the last name is the deepest on the rightmost path
+  tree[Name("/doc").appendVersion(5).append("x").append("y")] = 6;
+  BOOST_CHECK_EQUAL(*tree.findLast("/doc"), 6);
+}
+
+BOOST_AUTO_TEST_CASE(Erase)
+{
+  NameTree<int> tree;
+  tree[Name("/doc").appendVersion(1)] = 1;
+  tree[Name("/doc").appendVersion(5).append("a").append("b")] = 5;
+  tree[Name("/doc").appendVersion(3)] = 3;
+  BOOST_CHECK_EQUAL(tree.getNNodes(), 7);
+
+  BOOST_CHECK(!tree.erase("/doc"));
+  BOOST_CHECK(!tree.erase(Name("/doc").appendVersion(5)));
+  BOOST_CHECK(tree.erase(Name("/doc").appendVersion(5).append("a").append("b")));
+  BOOST_CHECK(!tree.erase(Name("/doc").appendVersion(5).append("a").append("b")));
+  BOOST_CHECK_EQUAL(tree.size(), 2);
+  BOOST_CHECK_EQUAL(tree.getNNodes(), 4);
+
+  // the rightmost child is recomputed when it is removed
+  BOOST_CHECK_EQUAL(*tree.findLast("/doc"), 3);
+  BOOST_CHECK(tree.find(Name("/doc").appendVersion(5).append("a")) == nullptr);
+
+  BOOST_CHECK(tree.erase(Name("/doc").appendVersion(3)));
+  BOOST_CHECK_EQUAL(*tree.findLast("/doc"), 1);
+  BOOST_CHECK(tree.erase(Name("/doc").appendVersion(1)));
+  BOOST_CHECK(tree.findLast("/doc") == nullptr);
+  BOOST_CHECK_EQUAL(tree.size(), 0);
+  BOOST_CHECK_EQUAL(tree.getNNodes(), 1);
+
+  // freed nodes are reused
+  tree["/x/y"] = 7;
+  BOOST_CHECK_EQUAL(*tree.find("/x/y"), 7);
+  BOOST_CHECK_EQUAL(tree.getNNodes(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Many)
+{
+  NameTree<size_t> tree;
+  const size_t N_NAMES = 10000;
+  for (size_t i = 0; i < N_NAMES; ++i) {
+    tree[Name("/many").append(std::to_string(i % 100)).appendVersion(i)] = i;
+  }
+  BOOST_CHECK_EQUAL(tree.size(), N_NAMES);
+
+  for (size_t i = 0; i < N_NAMES; i += 97) {
+    Name name = Name("/many").append(std::to_string(i % 100)).appendVersion(i);
+    BOOST_REQUIRE(tree.find(name) != nullptr);
+    BOOST_CHECK_EQUAL(*tree.find(name), i);
+    BOOST_CHECK_EQUAL(*tree.findLongestPrefix(Name(name).appendSegment(0)), i);
+  }
+  BOOST_CHECK_EQUAL(*tree.findLast("/many/42"), N_NAMES - 100 + 42);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestNameTree
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/segmenter.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class SegmenterFixture
+{
+protected:
+  SegmenterFixture()
+    : prefix(Name("/epac/segmented").appendVersion(1449227841747))
+    , contentKey(envelope::generateContentKey())
+  {
+    CryptoPP::AutoSeededRandomPool rng;
+    privateKey = backend.generatePrivateKey(rng);
+    publicKey = backend.makePublicKey(*privateKey);
+  }
+
+  std::string
+  open(const Data& segment)
+  {
+    const Block& content = segment.getContent();
+    Buffer payload = envelope::open(content.value(), content.value_size(), backend, privateKey);
+    return std::string(payload.begin(), payload.end());
+  }
+
+protected:
+  const CryptoBackend& backend = CryptoBackend::getDefault();
+  Name prefix;
+  Buffer contentKey;
+  shared_ptr<const CryptoPP::PrivateKey> privateKey;
+  shared_ptr<const CryptoPP::PublicKey> publicKey;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestSegmenter, SegmenterFixture)
+
+BOOST_AUTO_TEST_CASE(SegmentCount)
+{
+  envelope::Sealer sealer(contentKey, backend, publicKey);
+  Segmenter segmenter(sealer, 40);
+
+  for (size_t size : {0, 1, 39, 40, 41, 120, 1234}) {
+    BOOST_TEST_MESSAGE("payload size " << size);
+    std::istringstream input(std::string(size, 'a'));
+    auto segments = segmenter.segment(prefix, input);
+
+    size_t expectedSize = std::max<size_t>(1, (size + 39) / 40);
+    BOOST_CHECK_EQUAL(segments.size(), expectedSize);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NamesAndPayload)
+{
+  std::string text;
+  for (int i = 0; i < 100; ++i) {
+    text += "segment " + std::to_string(i) + ";";
+  }
+
+  envelope::Sealer sealer(contentKey, backend, publicKey);
+  Segmenter segmenter(sealer, 64);
+  std::istringstream input(text);
+  auto segments = segmenter.segment(prefix, input);
+  BOOST_REQUIRE_GT(segments.size(), 1);
+
+  envelope::Header firstHeader;
+  std::string reassembled;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const Data& segment = *segments[i];
+    BOOST_REQUIRE_EQUAL(segment.getName().size(), prefix.size() + 1);
+    BOOST_CHECK(prefix.isPrefixOf(segment.getName()));
+    BOOST_CHECK_EQUAL(segment.getName()[-1].toSegment(), i);
+    BOOST_REQUIRE(!segment.getFinalBlockId().empty());
+    BOOST_CHECK_EQUAL(segment.getFinalBlockId().toSegment(), segments.size() - 1);
+
+    // every segment carries the content key wrapped once, under its own IV
+    size_t headerSize = 0;
+    const Block& content = segment.getContent();
+    envelope::Header header = envelope::decodeHeader(content.value(), content.value_size(),
+                                                     headerSize);
+    if (i == 0) {
+      firstHeader = header;
+    }
+    else {
+      BOOST_CHECK(header.getWrappedKey() == firstHeader.getWrappedKey());
+      BOOST_CHECK(header.getInitialVector() != firstHeader.getInitialVector());
+    }
+
+    std::string payload = open(segment);
+    BOOST_CHECK_LE(payload.size(), 64);
+    reassembled += payload;
+  }
+  BOOST_CHECK_EQUAL(reassembled, text);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSegmenter
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
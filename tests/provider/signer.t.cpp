@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/signer.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class SignerFixture
+{
+protected:
+  SignerFixture()
+    : pool(4)
+  {
+  }
+
+  static std::vector<shared_ptr<Data>>
+  makePackets(size_t n)
+  {
+    std::vector<shared_ptr<Data>> packets;
+    for (size_t i = 0; i < n; ++i) {
+      auto data = make_shared<Data>(Name("/epac/signed").appendSegment(i));
+      data->setContent(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+      packets.push_back(data);
+    }
+    return packets;
+  }
+
+protected:
+  WorkerPool pool;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestSigner, SignerFixture)
+
+BOOST_AUTO_TEST_CASE(Sha256)
+{
+  Signer signer(pool, security::signingWithSha256());
+  auto packets = makePackets(1);
+  signer.sign(*packets.front());
+
+  const Data& data = *packets.front();
+  BOOST_CHECK_EQUAL(data.getSignature().getType(), ndn::tlv::DigestSha256);
+  BOOST_CHECK(security::verifyDigest(data, DigestAlgorithm::SHA256));
+
+  // the packet decodes from its wire encoding and still verifies
+  Data decoded(data.wireEncode());
+  BOOST_CHECK(security::verifyDigest(decoded, DigestAlgorithm::SHA256));
+}
+
+BOOST_AUTO_TEST_CASE(SignAll)
+{
+  Signer signer(pool, security::signingWithSha256());
+  auto packets = makePackets(1000);
+  signer.signAll(packets);
+
+  for (const auto& data : packets) {
+    BOOST_CHECK(data->hasWire());
+    BOOST_CHECK(security::verifyDigest(*data, DigestAlgorithm::SHA256));
+  }
+
+  // re-signing a modified packet gives a new, valid signature
+  packets[7]->setFreshnessPeriod(time::seconds(1));
+  signer.sign(*packets[7]);
+  BOOST_CHECK(security::verifyDigest(*packets[7], DigestAlgorithm::SHA256));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSigner
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/timing-wheel.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <map>
+#include <random>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class TimingWheelFixture
+{
+protected:
+  /**
+   * @brief advance the wheel to @p now, recording when each value expires
+   */
+  void
+  advance(uint64_t now)
+  {
+    while (wheel.getNow() <= now) {
+      uint64_t tick = wheel.getNow();
+      wheel.advance(tick, [this, tick] (int value) {
+        expired.emplace(value, tick);
+      });
+    }
+  }
+
+protected:
+  TimingWheel<int> wheel;
+  std::map<int, uint64_t> expired;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestTimingWheel, TimingWheelFixture)
+
+BOOST_AUTO_TEST_CASE(Expire)
+{
+  // deadlines within the first level, in coarser levels, and past
+  wheel.schedule(5, 1);
+  wheel.schedule(255, 2);
+  wheel.schedule(256, 3);
+  wheel.schedule(70000, 4);
+  wheel.schedule(16777217, 5);
+  BOOST_CHECK_EQUAL(wheel.size(), 5);
+
+  advance(4);
+  BOOST_CHECK(expired.empty());
+  advance(70000);
+  BOOST_CHECK_EQUAL(expired.size(), 4);
+  BOOST_CHECK_EQUAL(expired[1], 5);
+  BOOST_CHECK_EQUAL(expired[2], 255);
+  BOOST_CHECK_EQUAL(expired[3], 256);
+  BOOST_CHECK_EQUAL(expired[4], 70000);
+
+  // a deadline that has passed expires at the next tick
+  wheel.schedule(10, 6);
+  advance(70001);
+  BOOST_CHECK_EQUAL(expired[6], 70001);
+
+  advance(16777217);
+  BOOST_CHECK_EQUAL(expired[5], 16777217);
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Cancel)
+{
+  size_t id1 = wheel.schedule(300, 1);
+  wheel.schedule(300, 2);
+  size_t id3 = wheel.schedule(300, 3);
+  BOOST_CHECK_EQUAL(wheel.getDeadline(id1), 300);
+
+  wheel.cancel(id1);
+  wheel.cancel(id3);
+  BOOST_CHECK_EQUAL(wheel.size(), 1);
+
+  advance(1000);
+  BOOST_CHECK_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired.count(2), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleWhileExpiring)
+{
+  size_t id1 = wheel.schedule(10, 1);
+  size_t id2 = wheel.schedule(10, 2);
+
+  // the first value to expire reschedules itself and cancels the other
+  std::vector<uint64_t> ticks;
+  wheel.advance(20, [&] (int value) {
+    ticks.push_back(wheel.getNow() - 1);
+    if (ticks.size() == 1) {
+      wheel.cancel(value == 1 ? id2 : id1);
+      wheel.schedule(wheel.getNow() + 4, value);
+    }
+  });
+  BOOST_CHECK_EQUAL(ticks.size(), 2);
+  if (ticks.size() == 2) {
+    BOOST_CHECK_EQUAL(ticks[0], 10);
+    BOOST_CHECK_EQUAL(ticks[1], 15);
+  }
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Random)
+{
+  std::mt19937 random(7);
+  std::uniform_int_distribution<uint64_t> delay(0, 200000);
+  std::map<int, uint64_t> deadlines;
+  for (int value = 0; value < 2000; ++value) {
+    uint64_t deadline = delay(random);
+    deadlines[value] = deadline;
+    wheel.schedule(deadline, value);
+  }
+
+  advance(200000);
+  BOOST_CHECK(expired == deadlines);
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTimingWheel
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/token-verifier.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class TokenVerifierFixture : public UnitTestTimeFixture
+{
+protected:
+  TokenVerifierFixture()
+    : verifier(time::seconds(60))
+  {
+  }
+
+protected:
+  TokenVerifier verifier;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestTokenVerifier, TokenVerifierFixture)
+
+BOOST_AUTO_TEST_CASE(Verify)
+{
+  AccessToken token = verifier.issue("alice");
+  BOOST_CHECK_EQUAL(token.getUserId(), "alice");
+  BOOST_CHECK_EQUAL(token.getMac().size(), AccessToken::MAC_SIZE);
+  BOOST_CHECK(verifier.verify(token));
+  BOOST_CHECK(verifier.verify(AccessToken(token.wireEncode())));
+
+  // the MAC binds the user and the expiry
+  BOOST_CHECK(!verifier.verify(AccessToken("mallory", token.getExpiry(), token.getMac())));
+  BOOST_CHECK(!verifier.verify(AccessToken("alice", token.getExpiry() + 1, token.getMac())));
+  Buffer forged = token.getMac();
+  forged[AccessToken::MAC_SIZE - 1] ^= 1;
+  BOOST_CHECK(!verifier.verify(AccessToken("alice", token.getExpiry(), forged)));
+  BOOST_CHECK_EQUAL(verifier.getNRejected(), 3);
+
+  // tokens of another verifier have another secret
+  TokenVerifier other(time::seconds(60));
+  BOOST_CHECK(!other.verify(token));
+}
+
+BOOST_AUTO_TEST_CASE(Secret)
+{
+  Buffer secret(32);
+  std::fill(secret.begin(), secret.end(), 7);
+  TokenVerifier first(time::seconds(60), secret);
+  TokenVerifier second(time::seconds(60), secret);
+  BOOST_CHECK(second.verify(first.issue("alice")));
+}
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  AccessToken token = verifier.issue("alice");
+  systemClock->advance(time::seconds(59));
+  BOOST_CHECK(verifier.verify(token));
+
+  // an expired token is rejected even though it is cached
+  systemClock->advance(time::seconds(1));
+  BOOST_CHECK(!verifier.verify(token));
+  BOOST_CHECK(verifier.verify(verifier.issue("alice")));
+}
+
+BOOST_AUTO_TEST_CASE(Cache)
+{
+  std::vector<AccessToken> tokens;
+  for (int i = 0; i < 100; ++i) {
+    tokens.push_back(verifier.issue("user" + std::to_string(i)));
+  }
+
+  for (const auto& token : tokens) {
+    BOOST_CHECK(verifier.verify(token));
+  }
+  BOOST_CHECK_EQUAL(verifier.getNCacheHits(), 0);
+
+  // later Interests of the same users are checked against the cache; a few tokens may
+  // have evicted each other
+  for (const auto& token : tokens) {
+    BOOST_CHECK(verifier.verify(token));
+  }
+  BOOST_CHECK_GE(verifier.getNCacheHits(), 90);
+
+  // a token that differs from a cached one only in its MAC misses the cache
+  Buffer forged = tokens[0].getMac();
+  forged[AccessToken::MAC_SIZE - 1] ^= 1;
+  uint64_t nCacheHits = verifier.getNCacheHits();
+  BOOST_CHECK(!verifier.verify(AccessToken("user0", tokens[0].getExpiry(), forged)));
+  BOOST_CHECK_EQUAL(verifier.getNCacheHits(), nCacheHits);
+  BOOST_CHECK(verifier.verify(tokens[0]));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTokenVerifier
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn
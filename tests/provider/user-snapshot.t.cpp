@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "provider/user-snapshot.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ndn {
+namespace epac {
+namespace tests {
+
+using namespace ndn::tests;
+
+class UserSnapshotFixture
+{
+protected:
+  UserSnapshotFixture()
+    : directory(boost::filesystem::path(TMP_TESTS_PATH) / "user-snapshot")
+    , filename((directory / "users.snapshot").string())
+  {
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+  }
+
+  ~UserSnapshotFixture()
+  {
+    boost::filesystem::remove_all(directory);
+  }
+
+  static UserSnapshot::Record
+  makeRecord(const std::string& userId, const std::string& key)
+  {
+    UserSnapshot::Record record;
+    record.userId = userId.data();
+    record.userIdSize = userId.size();
+    record.backendType = 1;
+    record.key = reinterpret_cast<const uint8_t*>(key.data());
+    record.keySize = key.size();
+    return record;
+  }
+
+protected:
+  boost::filesystem::path directory;
+  std::string filename;
+};
+
+BOOST_AUTO_TEST_SUITE(EpacProvider)
+BOOST_FIXTURE_TEST_SUITE(TestUserSnapshot, UserSnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(WriteFind)
+{
+  std::vector<std::string> userIds;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; ++i) {
+    userIds.push_back("user" + std::to_string(i));
+    keys.push_back(std::string(i, 'k'));
+  }
+  std::vector<UserSnapshot::Record> records;
+  for (size_t i = 0; i < userIds.size(); ++i) {
+    records.push_back(makeRecord(userIds[i], keys[i]));
+  }
+  UserSnapshot::write(filename, records);
+
+  UserSnapshot snapshot(filename);
+  BOOST_CHECK_EQUAL(snapshot.size(), 100);
+  for (size_t i = 0; i < userIds.size(); ++i) {
+    size_t n = snapshot.find(userIds[i]);
+    BOOST_REQUIRE_EQUAL(n, i);
+    UserSnapshot::Record record = snapshot.getRecord(n);
+    BOOST_CHECK_EQUAL(std::string(record.userId, record.userIdSize), userIds[i]);
+    BOOST_CHECK_EQUAL(record.backendType, 1);
+    BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(record.key), record.keySize),
+                      keys[i]);
+  }
+  BOOST_CHECK_EQUAL(snapshot.find("nobody"), snapshot.size());
+  BOOST_CHECK_THROW(snapshot.getRecord(100), UserSnapshot::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+  UserSnapshot::write(filename, {});
+  UserSnapshot snapshot(filename);
+  BOOST_CHECK_EQUAL(snapshot.size(), 0);
+  BOOST_CHECK_EQUAL(snapshot.find("user"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  BOOST_CHECK_THROW(UserSnapshot((directory / "absent").string()), UserSnapshot::Error);
+
+  std::ofstream(filename) << "EPACAUT1";
+  BOOST_CHECK_THROW(UserSnapshot snapshot(filename), UserSnapshot::Error);
+
+  std::ofstream(filename) << "NOTAUSERSNAPSHOTATALL...";
+  BOOST_CHECK_THROW(UserSnapshot snapshot(filename), UserSnapshot::Error);
+
+  // index larger than the file
+  std::string userId = "user";
+  std::string key = "key";
+  UserSnapshot::write(filename, {makeRecord(userId, key)});
+  boost::filesystem::resize_file(filename, 64);
+  BOOST_CHECK_THROW(UserSnapshot snapshot(filename), UserSnapshot::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestUserSnapshot
+BOOST_AUTO_TEST_SUITE_END() // EpacProvider
+
+} // namespace tests
+} // namespace epac
+} // namespace ndn